@@ -0,0 +1,200 @@
+/**
+ * data_structures/common/arena.c
+ * arena.c - Implement of arena.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "arena.h"
+
+struct ArenaChunk
+{
+    ArenaChunk *next;
+    size_t size; // usable bytes after the header
+};
+
+struct PoolSlab
+{
+    PoolSlab *next;
+};
+
+// headers are padded so the payload that follows stays ARENA_ALIGN-aligned
+#define CHUNK_HEADER (((sizeof(ArenaChunk) + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN)
+#define SLAB_HEADER (((sizeof(PoolSlab) + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN)
+
+// malloc / free allocator
+static void *heap_alloc(void *ctx, size_t size)
+{
+    (void)ctx;
+    return malloc(size);
+}
+
+static void heap_free(void *ctx, void *ptr, size_t size)
+{
+    (void)ctx;
+    (void)size;
+    free(ptr);
+}
+
+Allocator allocator_default(void)
+{
+    return (Allocator){.alloc = heap_alloc, .free = heap_free, .ctx = NULL};
+}
+
+// bump arena
+void arena_init(Arena *a, size_t chunk_size)
+{
+    a->chunks = NULL;
+    a->cur = NULL;
+    a->end = NULL;
+    a->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK;
+    a->bytes = 0;
+}
+
+void *arena_alloc(Arena *a, size_t size)
+{
+    if (size > SIZE_MAX - ARENA_ALIGN - CHUNK_HEADER)
+        return NULL;
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (size == 0)
+        size = ARENA_ALIGN;
+    if ((size_t)(a->end - a->cur) >= size)
+    {
+        void *p = a->cur;
+        a->cur += size;
+        return p;
+    }
+
+    // an oversized request gets a chunk of its own behind the current one, so the
+    // space left in the current chunk is not thrown away
+    size_t usable = size > a->chunk_size ? size : a->chunk_size;
+    ArenaChunk *c = malloc(CHUNK_HEADER + usable);
+    if (!c)
+    {
+        fprintf(stderr, "Failed to allocate memory for arena chunk\n");
+        return NULL;
+    }
+    c->size = usable;
+    a->bytes += CHUNK_HEADER + usable;
+    char *base = (char *)c + CHUNK_HEADER;
+    if (size > a->chunk_size && a->chunks)
+    {
+        c->next = a->chunks->next;
+        a->chunks->next = c;
+        return base;
+    }
+    c->next = a->chunks;
+    a->chunks = c;
+    a->cur = base + size;
+    a->end = base + usable;
+    return base;
+}
+
+void arena_reset(Arena *a)
+{
+    if (!a->chunks)
+        return;
+    ArenaChunk *keep = a->chunks;
+    ArenaChunk *c = keep->next;
+    while (c)
+    {
+        ArenaChunk *next = c->next;
+        a->bytes -= CHUNK_HEADER + c->size;
+        free(c);
+        c = next;
+    }
+    keep->next = NULL;
+    a->cur = (char *)keep + CHUNK_HEADER;
+    a->end = a->cur + keep->size;
+}
+
+void arena_destroy(Arena *a)
+{
+    ArenaChunk *c = a->chunks;
+    while (c)
+    {
+        ArenaChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    arena_init(a, a->chunk_size);
+}
+
+static void *arena_alloc_cb(void *ctx, size_t size)
+{
+    return arena_alloc((Arena *)ctx, size);
+}
+
+Allocator arena_allocator(Arena *a)
+{
+    return (Allocator){.alloc = arena_alloc_cb, .free = NULL, .ctx = a};
+}
+
+// fixed-size slab pool
+void pool_init(Pool *p, size_t elem_size, size_t per_slab)
+{
+    // every free object holds the next-pointer of the free list
+    if (elem_size < sizeof(void *))
+        elem_size = sizeof(void *);
+    elem_size = (elem_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+    p->elem_size = elem_size;
+    p->per_slab = per_slab ? per_slab : POOL_DEFAULT_PER_SLAB;
+    p->free_list = NULL;
+    p->cur = NULL;
+    p->end = NULL;
+    p->slabs = NULL;
+    p->live = 0;
+    p->bytes = 0;
+}
+
+void *pool_grow(Pool *p)
+{
+    if (p->per_slab > (SIZE_MAX - SLAB_HEADER) / p->elem_size)
+        return NULL;
+    size_t bytes = SLAB_HEADER + p->per_slab * p->elem_size;
+    PoolSlab *s = malloc(bytes);
+    if (!s)
+    {
+        fprintf(stderr, "Failed to allocate memory for pool slab\n");
+        return NULL;
+    }
+    s->next = p->slabs;
+    p->slabs = s;
+    p->bytes += bytes;
+
+    char *obj = (char *)s + SLAB_HEADER;
+    p->cur = obj + p->elem_size;
+    p->end = obj + p->per_slab * p->elem_size;
+    return obj;
+}
+
+void pool_destroy(Pool *p)
+{
+    PoolSlab *s = p->slabs;
+    while (s)
+    {
+        PoolSlab *next = s->next;
+        free(s);
+        s = next;
+    }
+    pool_init(p, p->elem_size, p->per_slab);
+}
+
+static void *pool_alloc_cb(void *ctx, size_t size)
+{
+    Pool *p = (Pool *)ctx;
+    return size <= p->elem_size ? pool_alloc(p) : NULL;
+}
+
+static void pool_free_cb(void *ctx, void *ptr, size_t size)
+{
+    (void)size;
+    pool_free((Pool *)ctx, ptr);
+}
+
+Allocator pool_allocator(Pool *p)
+{
+    return (Allocator){.alloc = pool_alloc_cb, .free = pool_free_cb, .ctx = p};
+}
@@ -0,0 +1,175 @@
+/**
+ * arena.h - 内存分配器：bump arena、定长 slab 池和可插拔的分配器接口
+ *
+ * 容器按元素 malloc（链表节点、哈希节点……）时，几百万个 24 字节的小块会让堆碎片化，
+ * malloc/free 本身也成为热点。这里提供两种批量分配器：
+ * - Arena：从大块内存里顺序切分，单个对象不能释放，arena_reset/arena_destroy 时整体回收
+ * - Pool：同一尺寸对象的 slab 池，释放的对象进入空闲链表，下次分配直接复用
+ * 容器在创建时接收一个 Allocator（见 list_create_with_allocator、
+ * hashtable_chaining_create_alloc），不传时使用 malloc/free。
+ *
+ * Arena 和 Pool 都不是线程安全的，多线程共享时由使用者加锁。
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+// ========== 分配器接口 ==========
+
+/**
+ * 容器使用的分配器
+ * alloc(ctx, size)：分配 size 字节，失败返回 NULL
+ * free(ctx, ptr, size)：释放 alloc 返回的 ptr，size 与分配时相同（可为 NULL，表示不单独释放）
+ * alloc 为 NULL 的 Allocator 表示使用 malloc/free
+ */
+typedef struct Allocator
+{
+    void *(*alloc)(void *ctx, size_t size);
+    void (*free)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} Allocator;
+
+/**
+ * 基于 malloc/free 的分配器
+ */
+Allocator allocator_default(void);
+
+/**
+ * 通过分配器分配 / 释放；a 为 NULL 或 a->alloc 为 NULL 时使用 malloc/free
+ */
+static inline void *allocator_alloc(const Allocator *a, size_t size);
+static inline void allocator_free(const Allocator *a, void *ptr, size_t size);
+
+// ========== Bump arena ==========
+
+#define ARENA_ALIGN 16                 /* arena_alloc 返回的地址按 16 字节对齐 */
+#define ARENA_DEFAULT_CHUNK (64 * 1024) /* chunk_size 传 0 时每块的大小 */
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena
+{
+    ArenaChunk *chunks; // 最新的块在前
+    char *cur;          // 当前块中下一个可用字节
+    char *end;          // 当前块末尾
+    size_t chunk_size;
+    size_t bytes; // 已向 malloc 申请的字节数（含块头）
+} Arena;
+
+/**
+ * 初始化 arena，第一次分配时才申请内存
+ * @param chunk_size 每块大小，0 表示 ARENA_DEFAULT_CHUNK；超过它的请求单独成块
+ */
+void arena_init(Arena *a, size_t chunk_size);
+
+/**
+ * 分配 size 字节（16 字节对齐），失败返回 NULL；均摊 O(1)，通常只是移动一个指针
+ */
+void *arena_alloc(Arena *a, size_t size);
+
+/**
+ * 回收所有分配：保留最新的一块供复用，其余块归还给 malloc
+ */
+void arena_reset(Arena *a);
+
+/**
+ * 释放 arena 的全部内存
+ */
+void arena_destroy(Arena *a);
+
+/**
+ * 从 arena 分配的 Allocator：free 为空操作，内存随 arena 一起回收
+ */
+Allocator arena_allocator(Arena *a);
+
+// ========== 定长 slab 池 ==========
+
+typedef struct PoolSlab PoolSlab;
+
+typedef struct Pool
+{
+    size_t elem_size;  // 每个对象的大小（向上取整到指针大小的倍数）
+    size_t per_slab;   // 每个 slab 容纳的对象数
+    void *free_list;   // 释放的对象，头部存下一个空闲对象
+    char *cur;         // 当前 slab 中尚未切分的部分
+    char *end;
+    PoolSlab *slabs;
+    size_t live;  // 已分配未释放的对象数
+    size_t bytes; // 已向 malloc 申请的字节数
+} Pool;
+
+#define POOL_DEFAULT_PER_SLAB 1024
+
+/**
+ * 初始化对象大小为 elem_size 的池
+ * @param per_slab 每个 slab 的对象数，0 表示 POOL_DEFAULT_PER_SLAB
+ */
+void pool_init(Pool *p, size_t elem_size, size_t per_slab);
+
+/**
+ * 分配一个对象：优先从空闲链表取，其次从当前 slab 切分，都没有时再申请一个 slab
+ */
+static inline void *pool_alloc(Pool *p);
+
+/**
+ * 把对象放回空闲链表（不还给 malloc），O(1)
+ */
+static inline void pool_free(Pool *p, void *ptr);
+
+/**
+ * 释放池的全部 slab，尚未 pool_free 的对象一并失效
+ */
+void pool_destroy(Pool *p);
+
+/**
+ * 从池分配的 Allocator；请求大于 elem_size 时 alloc 返回 NULL
+ */
+Allocator pool_allocator(Pool *p);
+
+// ========== 内联实现 ==========
+
+void *pool_grow(Pool *p); /* 慢路径：申请新 slab 并切出一个对象 */
+
+static inline void *pool_alloc(Pool *p)
+{
+    void *obj = p->free_list;
+    if (obj)
+        p->free_list = *(void **)obj;
+    else if (p->cur < p->end)
+    {
+        obj = p->cur;
+        p->cur += p->elem_size;
+    }
+    else if (!(obj = pool_grow(p)))
+        return NULL;
+    p->live++;
+    return obj;
+}
+
+static inline void pool_free(Pool *p, void *ptr)
+{
+    if (!ptr)
+        return;
+    *(void **)ptr = p->free_list;
+    p->free_list = ptr;
+    p->live--;
+}
+
+static inline void *allocator_alloc(const Allocator *a, size_t size)
+{
+    return (a && a->alloc) ? a->alloc(a->ctx, size) : malloc(size);
+}
+
+static inline void allocator_free(const Allocator *a, void *ptr, size_t size)
+{
+    if (!a || !a->alloc)
+        free(ptr);
+    else if (a->free)
+        a->free(a->ctx, ptr, size);
+}
+
+#endif
@@ -91,4 +91,23 @@ void print_int(const void *data)
     }
 
     printf("%d ", *(const int *)data);
-}
\ No newline at end of file
+}
+
+// memory helpers
+void *safe_malloc(size_t size)
+{
+    void *p = malloc(size);
+    if (p == NULL && size > 0)
+    {
+        fprintf(stderr, "Failed to allocate %zu bytes\n", size);
+    }
+    return p;
+}
+
+void safe_free(void **ptr)
+{
+    if (!ptr)
+        return;
+    free(*ptr);
+    *ptr = NULL;
+}
@@ -1,8 +1,160 @@
 #include "common.h"
+#include "arena.h"
+#include "thread_pool.h"
+#include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 
+void test_arena()
+{
+    printf("=== Test arena ===\n");
+
+    Arena a;
+    arena_init(&a, 1024);
+    char *prev = NULL;
+    for (int i = 0; i < 1000; i++)
+    {
+        char *p = arena_alloc(&a, (size_t)(i % 40) + 1);
+        assert(p != NULL);
+        assert(((uintptr_t)p % ARENA_ALIGN) == 0);
+        memset(p, i & 0xff, (size_t)(i % 40) + 1);
+        assert(p != prev);
+        prev = p;
+    }
+    size_t bytes = a.bytes;
+    assert(bytes > 0);
+
+    // a request bigger than a chunk gets its own block and keeps the current one
+    char *cur = a.cur;
+    char *big = arena_alloc(&a, 10000);
+    assert(big != NULL && a.cur == cur);
+    memset(big, 0, 10000);
+
+    arena_reset(&a);
+    assert(a.bytes < bytes && a.bytes < 2048); // only the newest chunk is kept
+    assert(arena_alloc(&a, 8) != NULL);
+
+    Allocator alloc = arena_allocator(&a);
+    int *x = allocator_alloc(&alloc, sizeof(int));
+    *x = 42;
+    allocator_free(&alloc, x, sizeof(int)); // no-op, the arena owns it
+    assert(*x == 42);
+
+    arena_destroy(&a);
+    assert(a.chunks == NULL && a.bytes == 0);
+    printf("passed\n");
+}
+
+void test_pool()
+{
+    printf("=== Test pool ===\n");
+
+    Pool p;
+    pool_init(&p, 24, 64);
+    assert(p.elem_size == 24);
+
+    void *objs[1000];
+    for (int i = 0; i < 1000; i++)
+    {
+        objs[i] = pool_alloc(&p);
+        assert(objs[i] != NULL);
+        memset(objs[i], 0xab, 24);
+    }
+    assert(p.live == 1000);
+    size_t bytes = p.bytes;
+
+    // freed objects are handed out again before any new slab is taken
+    for (int i = 0; i < 1000; i += 2)
+        pool_free(&p, objs[i]);
+    assert(p.live == 500);
+    for (int i = 0; i < 1000; i += 2)
+    {
+        void *o = pool_alloc(&p);
+        int reused = 0;
+        for (int j = 0; j < 1000; j += 2)
+            reused |= o == objs[j];
+        assert(reused);
+    }
+    assert(p.bytes == bytes && p.live == 1000);
+
+    Allocator alloc = pool_allocator(&p);
+    assert(allocator_alloc(&alloc, 16) != NULL);
+    assert(allocator_alloc(&alloc, 25) == NULL); // larger than the pool's objects
+
+    pool_destroy(&p);
+    assert(p.slabs == NULL && p.live == 0 && p.bytes == 0);
+
+    pool_init(&p, 1, 0);
+    assert(p.elem_size == sizeof(void *) && p.per_slab == POOL_DEFAULT_PER_SLAB);
+    pool_destroy(&p);
+    printf("passed\n");
+}
+
+void test_default_allocator()
+{
+    printf("=== Test default allocator ===\n");
+
+    Allocator heap = allocator_default();
+    void *p = allocator_alloc(&heap, 100);
+    assert(p != NULL);
+    allocator_free(&heap, p, 100);
+
+    p = allocator_alloc(NULL, 100); // NULL means malloc/free
+    assert(p != NULL);
+    allocator_free(NULL, p, 100);
+
+    void *q = safe_malloc(16);
+    assert(q != NULL);
+    safe_free(&q);
+    assert(q == NULL);
+    printf("passed\n");
+}
+
+static void mark_range(size_t lo, size_t hi, size_t chunk, void *ctx)
+{
+    (void)chunk;
+    unsigned char *hits = ctx;
+    for (size_t i = lo; i < hi; i++)
+        hits[i]++;
+}
+
+void test_thread_pool()
+{
+    printf("=== Test thread pool ===\n");
+
+    enum { N = 100003 };
+    unsigned char *hits = calloc(N, 1);
+    ThreadPool *pool = thread_pool_create(4);
+    assert(pool != NULL);
+    assert(thread_pool_size(pool) >= 1 && thread_pool_size(pool) <= 4);
+    assert(thread_pool_size(NULL) == 1);
+    assert(thread_pool_chunks(10, 3) == 4 && thread_pool_chunks(9, 3) == 3);
+    assert(thread_pool_grain(pool, 10, 64) == 64);
+
+    // the pool is reused: every element is visited exactly once per run
+    for (int round = 1; round <= 20; round++)
+    {
+        thread_pool_parallel_for(pool, N, 1000, mark_range, hits);
+        for (size_t i = 0; i < N; i += 997)
+            assert(hits[i] == round);
+    }
+    thread_pool_parallel_for(NULL, N, 0, mark_range, hits);
+    for (size_t i = 0; i < N; i++)
+        assert(hits[i] == 21);
+
+    thread_pool_destroy(&pool);
+    assert(pool == NULL);
+    free(hits);
+    printf("passed\n");
+}
 
 int main() {
     int result = compare_int(&(int){2}, &(int){2});
-    printf("%d", result);
+    printf("%d\n", result);
+
+    test_arena();
+    test_pool();
+    test_default_allocator();
+    test_thread_pool();
+    return 0;
 }
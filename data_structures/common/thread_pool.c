@@ -0,0 +1,204 @@
+/**
+ * data_structures/common/thread_pool.c
+ * thread_pool.c - Implement of thread_pool.h
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "thread_pool.h"
+
+#define THREAD_POOL_MAX_THREADS 256
+// aim for this many chunks per thread so uneven chunks still balance out
+#define THREAD_POOL_CHUNKS_PER_THREAD 8
+
+struct ThreadPool
+{
+    pthread_t *threads;
+    size_t nworkers; // started worker threads, the submitting thread is extra
+
+    pthread_mutex_t submit; // one parallel_for at a time
+    pthread_mutex_t lock;   // guards everything below
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    unsigned long generation; // bumped for every job
+    bool shutdown;
+
+    // current job
+    ThreadPoolRangeFn fn;
+    void *ctx;
+    size_t n;
+    size_t grain;
+    size_t nchunks;
+    size_t next_chunk;
+    size_t busy; // workers that have not finished the current job
+};
+
+// claims and runs chunks until none are left
+static void run_chunks(ThreadPool *pool)
+{
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        size_t chunk = pool->next_chunk;
+        if (chunk < pool->nchunks)
+            pool->next_chunk++;
+        pthread_mutex_unlock(&pool->lock);
+        if (chunk >= pool->nchunks)
+            return;
+
+        size_t lo = chunk * pool->grain;
+        size_t hi = pool->n - lo < pool->grain ? pool->n : lo + pool->grain;
+        pool->fn(lo, hi, chunk, pool->ctx);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    ThreadPool *pool = (ThreadPool *)arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (!pool->shutdown && pool->generation == seen)
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        if (pool->shutdown)
+            break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_chunks(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0)
+            pthread_cond_signal(&pool->done_cv);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool *thread_pool_create(size_t nthreads)
+{
+    if (nthreads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = cpus > 1 ? (size_t)cpus : 1;
+    }
+    if (nthreads > THREAD_POOL_MAX_THREADS)
+        nthreads = THREAD_POOL_MAX_THREADS;
+
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (!pool)
+    {
+        fprintf(stderr, "Failed to allocate memory for ThreadPool\n");
+        return NULL;
+    }
+    pool->threads = malloc((nthreads - 1 ? nthreads - 1 : 1) * sizeof(pthread_t));
+    if (!pool->threads)
+    {
+        fprintf(stderr, "Failed to allocate memory for ThreadPool\n");
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->submit, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+
+    // a worker that fails to start is just skipped, the others share its chunks
+    for (size_t t = 1; t < nthreads; t++)
+        if (pthread_create(&pool->threads[pool->nworkers], NULL, worker_main, pool) == 0)
+            pool->nworkers++;
+
+    return pool;
+}
+
+void thread_pool_destroy(ThreadPool **pool)
+{
+    if (!pool || !*pool)
+        return;
+    ThreadPool *p = *pool;
+
+    pthread_mutex_lock(&p->lock);
+    p->shutdown = true;
+    pthread_cond_broadcast(&p->work_cv);
+    pthread_mutex_unlock(&p->lock);
+    for (size_t t = 0; t < p->nworkers; t++)
+        pthread_join(p->threads[t], NULL);
+
+    pthread_cond_destroy(&p->done_cv);
+    pthread_cond_destroy(&p->work_cv);
+    pthread_mutex_destroy(&p->lock);
+    pthread_mutex_destroy(&p->submit);
+    free(p->threads);
+    free(p);
+    *pool = NULL;
+}
+
+size_t thread_pool_size(const ThreadPool *pool)
+{
+    return pool ? pool->nworkers + 1 : 1;
+}
+
+size_t thread_pool_chunks(size_t n, size_t grain)
+{
+    if (grain == 0)
+        grain = 1;
+    return n / grain + (n % grain != 0);
+}
+
+size_t thread_pool_grain(const ThreadPool *pool, size_t n, size_t min_grain)
+{
+    size_t target = thread_pool_size(pool) * THREAD_POOL_CHUNKS_PER_THREAD;
+    size_t grain = n / target + (n % target != 0);
+    if (grain < min_grain)
+        grain = min_grain;
+    return grain ? grain : 1;
+}
+
+void thread_pool_parallel_for(ThreadPool *pool, size_t n, size_t grain,
+                              ThreadPoolRangeFn fn, void *ctx)
+{
+    if (n == 0 || !fn)
+        return;
+    if (grain == 0)
+        grain = 1;
+    size_t nchunks = thread_pool_chunks(n, grain);
+
+    if (!pool || pool->nworkers == 0 || nchunks == 1)
+    {
+        for (size_t c = 0; c < nchunks; c++)
+        {
+            size_t lo = c * grain;
+            fn(lo, n - lo < grain ? n : lo + grain, c, ctx);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->submit);
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->n = n;
+    pool->grain = grain;
+    pool->nchunks = nchunks;
+    pool->next_chunk = 0;
+    pool->busy = pool->nworkers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    // the submitting thread works too
+    run_chunks(pool);
+
+    // every worker checks in, so none still reads this job when the next one is set up
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0)
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->submit);
+}
@@ -0,0 +1,64 @@
+/**
+ * thread_pool.h - 可复用的 pthread 线程池，按块并行执行区间任务
+ *
+ * 线程在 thread_pool_create 时启动一次，之后每次 thread_pool_parallel_for 只是
+ * 唤醒它们，避免每次并行操作都 pthread_create / pthread_join。
+ * 工作划分：[0, n) 切成固定大小的块，线程（含调用线程）从共享计数器上领取下一块，
+ * 处理得快的线程自然多领，各块耗时不均时也能保持负载均衡。
+ *
+ * 同一个池同一时刻只执行一个 parallel_for，多个线程同时提交时依次执行；
+ * 块回调里不能再对同一个池调用 thread_pool_parallel_for（会死锁）。
+ * 需要链接 -pthread。
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * 块回调：处理 [lo, hi)，chunk 是块编号（0 .. 块数-1），可用作每块部分结果的下标
+ */
+typedef void (*ThreadPoolRangeFn)(size_t lo, size_t hi, size_t chunk, void *ctx);
+
+/**
+ * 创建线程池
+ * @param nthreads 参与计算的线程数（含调用线程，池里启动 nthreads - 1 个工作线程），
+ *                 0 表示在线 CPU 数
+ * @return 新线程池，失败返回 NULL；部分工作线程启动失败时用已启动的线程继续工作
+ */
+ThreadPool *thread_pool_create(size_t nthreads);
+
+/**
+ * 停止并回收所有工作线程，*pool 置为 NULL
+ */
+void thread_pool_destroy(ThreadPool **pool);
+
+/**
+ * 参与计算的线程数（含调用线程）；pool 为 NULL 时为 1
+ */
+size_t thread_pool_size(const ThreadPool *pool);
+
+/**
+ * 块数：把 n 个元素按 grain 切块后的块数，即 (n + grain - 1) / grain
+ */
+size_t thread_pool_chunks(size_t n, size_t grain);
+
+/**
+ * 为 n 个元素选择块大小：每个线程约分到 8 块，每块不少于 min_grain 个元素
+ */
+size_t thread_pool_grain(const ThreadPool *pool, size_t n, size_t min_grain);
+
+/**
+ * 并行执行 fn 覆盖 [0, n)，返回时所有块都已完成
+ * @param pool 线程池，NULL 时在调用线程上顺序执行
+ * @param grain 块大小，0 表示 1
+ * 只有一块时直接在调用线程上执行，不唤醒工作线程
+ */
+void thread_pool_parallel_for(ThreadPool *pool, size_t n, size_t grain,
+                              ThreadPoolRangeFn fn, void *ctx);
+
+#endif
@@ -8,6 +8,7 @@ Implement of linked list.
 #include <stdbool.h>
 #include "doubly_circular_list.h"
 #include "../common/common.h"
+#include "../common/arena.h"
 
 struct Node
 {
@@ -21,10 +22,27 @@ struct DoublyCircularList
     Node *head;
     size_t length;
     int (*compare)(const void *a, const void *b);
+    const Allocator *alloc; // nodes (sentinel included) come from here; NULL means malloc
 };
 
+static inline Node *node_alloc(DoublyCircularList *list)
+{
+    return (Node *)allocator_alloc(list->alloc, sizeof(Node));
+}
+
+static inline void node_free(DoublyCircularList *list, Node *node)
+{
+    allocator_free(list->alloc, node, sizeof(Node));
+}
+
 // init and destroy
 DoublyCircularList *list_create(int (*compare)(const void *a, const void *b))
+{
+    return list_create_with_allocator(compare, NULL);
+}
+
+DoublyCircularList *list_create_with_allocator(int (*compare)(const void *a, const void *b),
+                                               const Allocator *alloc)
 {
     DoublyCircularList *dcl = malloc(sizeof(DoublyCircularList));
     if (dcl == NULL)
@@ -32,11 +50,13 @@ DoublyCircularList *list_create(int (*compare)(const void *a, const void *b))
         fprintf(stderr, "Failed to allocate memory for LinkedList\n");
         return NULL;
     }
+    dcl->alloc = alloc;
     // set list head as a sentinel node
-    Node *head = malloc(sizeof(Node));
+    Node *head = node_alloc(dcl);
     if (head == NULL)
     {
         fprintf(stderr, "Failed to allocate memory for LinkedList head\n");
+        free(dcl);
         return NULL;
     }
     head->data = NULL;
@@ -63,21 +83,27 @@ void list_destroy(DoublyCircularList **list)
     while (cur != head)
     {
         next = cur->next;
-        free(cur);
+        node_free(*list, cur);
         cur = next;
     }
 
-    free(head);
+    node_free(*list, head);
     free(*list);
     *list = NULL;
 }
 
-Node *init_node(void *data)
+size_t list_node_size(void)
+{
+    return sizeof(Node);
+}
+
+static Node *init_node(DoublyCircularList *list, void *data)
 {
-    Node *new_node = malloc(sizeof(Node));
+    Node *new_node = node_alloc(list);
     if (new_node == NULL)
     {
         fprintf(stderr, "Failed to allocate memory for Node\n");
+        return NULL;
     }
     new_node->data = data;
     new_node->next = NULL;
@@ -98,7 +124,9 @@ bool list_insert_head(DoublyCircularList *list, void *data)
     Node *head = list->head;
     Node *first = head->next;
     // init new node
-    Node *new_node = init_node(data);
+    Node *new_node = init_node(list, data);
+    if (!new_node)
+        return false;
 
     new_node->next = first;
     new_node->prev = head;
@@ -121,7 +149,9 @@ bool list_insert_tail(DoublyCircularList *list, void *data)
     Node *head = list->head;
     Node *tail = head->prev;
 
-    Node *new_node = init_node(data);
+    Node *new_node = init_node(list, data);
+    if (!new_node)
+        return false;
 
     new_node->next = head;
     new_node->prev = tail;
@@ -149,7 +179,9 @@ bool list_insert_at(DoublyCircularList *list, size_t index, void *data)
         return false;
     }
 
-    Node *new_node = init_node(data);
+    Node *new_node = init_node(list, data);
+    if (!new_node)
+        return false;
 
     // get node at index
     Node *target_node = list_get_node_at(list, index);
@@ -191,7 +223,7 @@ bool list_remove_head(DoublyCircularList *list)
     head->next = second;
     second->prev = head;
 
-    free(first);
+    node_free(list, first);
     list->length -= 1;
     return true;
 }
@@ -217,7 +249,7 @@ bool list_remove_tail(DoublyCircularList *list)
     head->prev = penultimate;
     penultimate->next = head;
 
-    free(last);
+    node_free(list, last);
     list->length -= 1;
     return true;
 }
@@ -253,7 +285,28 @@ bool list_remove_at(DoublyCircularList *list, size_t index)
     prev_node->next = next_node;
     next_node->prev = prev_node;
 
-    free(target_node);
+    node_free(list, target_node);
+    list->length -= 1;
+    return true;
+}
+
+bool list_remove_node(DoublyCircularList *list, Node *node)
+{
+    if (!list)
+    {
+        fprintf(stderr, "List doesn't exist\n");
+        return false;
+    };
+    if (!node || node == list->head)
+    {
+        fprintf(stderr, "Invalid node\n");
+        return false;
+    }
+
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+
+    node_free(list, node);
     list->length -= 1;
     return true;
 }
@@ -317,6 +370,31 @@ Node *list_get_node_at(DoublyCircularList *list, size_t index)
     return cur;
 }
 
+Node *list_first_node(DoublyCircularList *list)
+{
+    if (!list)
+    {
+        fprintf(stderr, "List doesn't exist\n");
+        return NULL;
+    }
+    return list->head->next == list->head ? NULL : list->head->next;
+}
+
+Node *list_next_node(DoublyCircularList *list, Node *node)
+{
+    if (!list || !node)
+    {
+        return NULL;
+    }
+    // the sentinel head marks the end of one round
+    return node->next == list->head ? NULL : node->next;
+}
+
+void *list_node_data(const Node *node)
+{
+    return node ? node->data : NULL;
+}
+
 void *list_get_head(DoublyCircularList *list)
 {
     if (!list)
@@ -473,7 +551,7 @@ DoublyCircularList *list_clone(DoublyCircularList *list, void *(*clone_data)(con
         return NULL;
     }
 
-    DoublyCircularList *new_list = list_create(list->compare);
+    DoublyCircularList *new_list = list_create_with_allocator(list->compare, list->alloc);
     // copy old list
     Node *cur = list->head->next;
     for (int i = 0; i < list->length; i++)
@@ -527,7 +605,7 @@ void *list_pop_front(DoublyCircularList *lst) {
     Node *second = first->next;
     lst->head->next = second;
     second->prev = lst->head;
-    free(first);                 // 只释放“节点”，不动 data
+    node_free(lst, first);       // 只释放“节点”，不动 data
     lst->length--;               // 如果维护 length，这里再减
     return data;                 // data 交给上层释放
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include "../common/arena.h"
 
 // 节点结构
 typedef struct Node Node;
@@ -21,6 +22,12 @@ typedef struct DoublyCircularList DoublyCircularList;
 DoublyCircularList *list_create(int (*compare)(const void *a, const void *b));
 void list_destroy(DoublyCircularList **list);
 
+// 节点（含哨兵）从 alloc 分配，例如多个链表共用一个 list_node_size() 大小的 Pool；
+// alloc 为 NULL 时使用 malloc。链表只保存 alloc 指针，alloc 须比链表活得久
+DoublyCircularList *list_create_with_allocator(int (*compare)(const void *a, const void *b),
+                                               const Allocator *alloc);
+size_t list_node_size(void);
+
 // 插入操作
 bool list_insert_head(DoublyCircularList *list, void *data);
 bool list_insert_tail(DoublyCircularList *list, void *data);
@@ -40,6 +47,13 @@ void *list_get_at(DoublyCircularList *list, size_t index);
 
 void *list_pop_front(DoublyCircularList *lst);
 
+// 按节点遍历：每步 O(1)，代替逐个 list_get_at（每次都要从头走到下标处）
+// 到达尾部后 list_next_node 返回 NULL；遍历中删除当前节点前先取得下一个节点
+Node *list_first_node(DoublyCircularList *list);
+Node *list_next_node(DoublyCircularList *list, Node *node);
+void *list_node_data(const Node *node);
+bool list_remove_node(DoublyCircularList *list, Node *node);
+
 // 修改操作
 bool list_set_at(DoublyCircularList *list, size_t index, void *data);
 
@@ -121,7 +121,48 @@ void test_list_operation()
     }
 }
 
+void test_pool_allocator()
+{
+    printf("=== Test list_create_with_allocator ===\n");
+
+    // two lists sharing one node pool
+    Pool pool;
+    pool_init(&pool, list_node_size(), 0);
+    Allocator alloc = pool_allocator(&pool);
+    DoublyCircularList *a = list_create_with_allocator(compare_int, &alloc);
+    DoublyCircularList *b = list_create_with_allocator(compare_int, &alloc);
+    assert(pool.live == 2); // sentinels
+
+    int vals[100];
+    for (int i = 0; i < 100; i++)
+    {
+        vals[i] = i;
+        assert(list_insert_tail(i % 2 ? a : b, &vals[i]));
+    }
+    assert(pool.live == 102 && list_size(a) == 50 && list_size(b) == 50);
+    assert(list_find(a, &(int){51}) == 25);
+
+    list_remove_head(a);
+    list_remove_tail(b);
+    assert(pool.live == 100);
+    size_t bytes = pool.bytes;
+    list_insert_head(a, &vals[1]);
+    assert(pool.bytes == bytes); // the freed node is reused
+
+    // a clone allocates from the same pool
+    DoublyCircularList *c = list_clone(a, NULL);
+    assert(pool.live == 101 + 51 && list_size(c) == 50);
+
+    list_destroy(&a);
+    list_destroy(&b);
+    list_destroy(&c);
+    assert(pool.live == 0);
+    pool_destroy(&pool);
+    printf("passed\n");
+}
+
 int main()
 {
     test_reverse_and_clone();
+    test_pool_allocator();
 }
\ No newline at end of file
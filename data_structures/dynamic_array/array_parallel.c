@@ -0,0 +1,358 @@
+/*
+Implement of array_parallel.h on top of common/thread_pool.h.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "array_parallel.h"
+
+// both array kinds seen as n elements of stride bytes at base; a DynamicArray
+// element is its void* slot, and callbacks get the pointer stored in it
+typedef struct
+{
+    char *base;
+    size_t stride;
+    size_t n;
+    bool boxed;
+} Seq;
+
+static Seq seq_of_array(const DynamicArray *array)
+{
+    return (Seq){(char *)array->data, sizeof(void *), array->size, true};
+}
+
+static Seq seq_of_varray(const ValueArray *array)
+{
+    return (Seq){(char *)array->data, array->elem_size, array->size, false};
+}
+
+static inline void *seq_at(const Seq *s, size_t i)
+{
+    char *slot = s->base + i * s->stride;
+    return s->boxed ? *(void **)slot : slot;
+}
+
+typedef struct
+{
+    Seq in;
+    void *ctx;
+    void (*each)(void *elem, void *ctx);
+    // map: exactly one of these is set
+    void *(*map_boxed)(const void *elem, void *ctx);
+    void (*map_value)(const void *elem, void *out, void *ctx);
+    Seq out;
+    // reduce
+    const void *identity;
+    char *partials;
+    size_t acc_size;
+    void (*accumulate)(void *acc, const void *elem, void *ctx);
+    // filter
+    bool (*pred)(const void *elem, void *ctx);
+    unsigned char *keep;
+    size_t *counts; // per chunk, then turned into output offsets
+} Job;
+
+static void for_each_range(size_t lo, size_t hi, size_t chunk, void *arg)
+{
+    (void)chunk;
+    Job *job = (Job *)arg;
+    for (size_t i = lo; i < hi; i++)
+        job->each(seq_at(&job->in, i), job->ctx);
+}
+
+static void map_range(size_t lo, size_t hi, size_t chunk, void *arg)
+{
+    (void)chunk;
+    Job *job = (Job *)arg;
+    if (job->map_boxed)
+    {
+        void **out = (void **)job->out.base;
+        for (size_t i = lo; i < hi; i++)
+            out[i] = job->map_boxed(seq_at(&job->in, i), job->ctx);
+    }
+    else
+    {
+        for (size_t i = lo; i < hi; i++)
+            job->map_value(seq_at(&job->in, i), job->out.base + i * job->out.stride, job->ctx);
+    }
+}
+
+static void reduce_range(size_t lo, size_t hi, size_t chunk, void *arg)
+{
+    Job *job = (Job *)arg;
+    char *acc = job->partials + chunk * job->acc_size;
+    memcpy(acc, job->identity, job->acc_size);
+    for (size_t i = lo; i < hi; i++)
+        job->accumulate(acc, seq_at(&job->in, i), job->ctx);
+}
+
+static void filter_mark_range(size_t lo, size_t hi, size_t chunk, void *arg)
+{
+    Job *job = (Job *)arg;
+    size_t count = 0;
+    for (size_t i = lo; i < hi; i++)
+    {
+        job->keep[i] = job->pred(seq_at(&job->in, i), job->ctx);
+        count += job->keep[i];
+    }
+    job->counts[chunk] = count;
+}
+
+static void filter_copy_range(size_t lo, size_t hi, size_t chunk, void *arg)
+{
+    Job *job = (Job *)arg;
+    size_t stride = job->in.stride;
+    char *dst = job->out.base + job->counts[chunk] * stride;
+    for (size_t i = lo; i < hi; i++)
+    {
+        if (job->keep[i])
+        {
+            memcpy(dst, job->in.base + i * stride, stride);
+            dst += stride;
+        }
+    }
+}
+
+static size_t grain_for(const ThreadPool *pool, size_t n)
+{
+    return thread_pool_grain(pool, n, ARRAY_PARALLEL_MIN_CHUNK);
+}
+
+static bool run_reduce(ThreadPool *pool, Seq in, void *acc, size_t acc_size,
+                       void (*accumulate)(void *acc, const void *elem, void *ctx),
+                       void (*combine)(void *acc, const void *other, void *ctx), void *ctx)
+{
+    if (in.n == 0)
+        return true;
+
+    size_t grain = grain_for(pool, in.n);
+    size_t nchunks = thread_pool_chunks(in.n, grain);
+    Job job = {0};
+    job.in = in;
+    job.ctx = ctx;
+    job.identity = acc;
+    job.acc_size = acc_size;
+    job.accumulate = accumulate;
+    job.partials = malloc(nchunks * acc_size);
+    if (!job.partials)
+    {
+        fprintf(stderr, "Failed to allocate memory for partial results\n");
+        return false;
+    }
+
+    thread_pool_parallel_for(pool, in.n, grain, reduce_range, &job);
+
+    // combine in chunk order so only associativity is needed
+    memcpy(acc, job.partials, acc_size);
+    for (size_t c = 1; c < nchunks; c++)
+        combine(acc, job.partials + c * acc_size, ctx);
+    free(job.partials);
+    return true;
+}
+
+// marks kept elements and stores how many there are in *total; on success
+// job->keep and job->counts are allocated and counts hold each chunk's output offset
+static bool run_filter_mark(ThreadPool *pool, Job *job, size_t grain, size_t *total)
+{
+    size_t nchunks = thread_pool_chunks(job->in.n, grain);
+    job->keep = malloc(job->in.n);
+    job->counts = malloc(nchunks * sizeof(size_t));
+    if (!job->keep || !job->counts)
+    {
+        fprintf(stderr, "Failed to allocate memory for filter\n");
+        free(job->keep);
+        free(job->counts);
+        return false;
+    }
+
+    thread_pool_parallel_for(pool, job->in.n, grain, filter_mark_range, job);
+
+    size_t offset = 0;
+    for (size_t c = 0; c < nchunks; c++)
+    {
+        size_t count = job->counts[c];
+        job->counts[c] = offset;
+        offset += count;
+    }
+    *total = offset;
+    return true;
+}
+
+// ========== DynamicArray ==========
+
+void array_parallel_for_each(ThreadPool *pool, DynamicArray *array,
+                             void (*fn)(void *data, void *ctx), void *ctx)
+{
+    if (!array || !fn)
+    {
+        fprintf(stderr, "Array or function doesn't exist\n");
+        return;
+    }
+
+    Job job = {0};
+    job.in = seq_of_array(array);
+    job.ctx = ctx;
+    job.each = fn;
+    thread_pool_parallel_for(pool, array->size, grain_for(pool, array->size), for_each_range, &job);
+}
+
+DynamicArray *array_parallel_map(ThreadPool *pool, const DynamicArray *array,
+                                 void *(*fn)(const void *data, void *ctx), void *ctx)
+{
+    if (!array || !fn)
+    {
+        fprintf(stderr, "Array or function doesn't exist\n");
+        return NULL;
+    }
+
+    DynamicArray *out = array_create(array->size);
+    if (!out)
+        return NULL;
+
+    Job job = {0};
+    job.in = seq_of_array(array);
+    job.ctx = ctx;
+    job.map_boxed = fn;
+    job.out = seq_of_array(out);
+    thread_pool_parallel_for(pool, array->size, grain_for(pool, array->size), map_range, &job);
+    out->size = array->size;
+    return out;
+}
+
+bool array_parallel_reduce(ThreadPool *pool, const DynamicArray *array,
+                           void *acc, size_t acc_size,
+                           void (*accumulate)(void *acc, const void *data, void *ctx),
+                           void (*combine)(void *acc, const void *other, void *ctx),
+                           void *ctx)
+{
+    if (!array || !acc || acc_size == 0 || !accumulate || !combine)
+    {
+        fprintf(stderr, "Array, accumulator or function doesn't exist\n");
+        return false;
+    }
+
+    return run_reduce(pool, seq_of_array(array), acc, acc_size, accumulate, combine, ctx);
+}
+
+DynamicArray *array_parallel_filter(ThreadPool *pool, const DynamicArray *array,
+                                    bool (*pred)(const void *data, void *ctx), void *ctx)
+{
+    if (!array || !pred)
+    {
+        fprintf(stderr, "Array or predicate doesn't exist\n");
+        return NULL;
+    }
+    if (array->size == 0)
+        return array_create(0);
+
+    Job job = {0};
+    job.in = seq_of_array(array);
+    job.ctx = ctx;
+    job.pred = pred;
+    size_t grain = grain_for(pool, array->size);
+    size_t total;
+    if (!run_filter_mark(pool, &job, grain, &total))
+        return NULL;
+
+    DynamicArray *out = array_create(total);
+    if (out)
+    {
+        job.out = seq_of_array(out);
+        thread_pool_parallel_for(pool, array->size, grain, filter_copy_range, &job);
+        out->size = total;
+    }
+    free(job.keep);
+    free(job.counts);
+    return out;
+}
+
+// ========== ValueArray ==========
+
+void varray_parallel_for_each(ThreadPool *pool, ValueArray *array,
+                              void (*fn)(void *elem, void *ctx), void *ctx)
+{
+    if (!array || !fn)
+    {
+        fprintf(stderr, "Array or function doesn't exist\n");
+        return;
+    }
+
+    Job job = {0};
+    job.in = seq_of_varray(array);
+    job.ctx = ctx;
+    job.each = fn;
+    thread_pool_parallel_for(pool, array->size, grain_for(pool, array->size), for_each_range, &job);
+}
+
+ValueArray *varray_parallel_map(ThreadPool *pool, const ValueArray *array, size_t out_elem_size,
+                                void (*fn)(const void *elem, void *out, void *ctx), void *ctx)
+{
+    if (!array || !fn)
+    {
+        fprintf(stderr, "Array or function doesn't exist\n");
+        return NULL;
+    }
+
+    ValueArray *out = varray_create(out_elem_size, array->size);
+    if (!out)
+        return NULL;
+
+    Job job = {0};
+    job.in = seq_of_varray(array);
+    job.ctx = ctx;
+    job.map_value = fn;
+    job.out = seq_of_varray(out);
+    thread_pool_parallel_for(pool, array->size, grain_for(pool, array->size), map_range, &job);
+    out->size = array->size;
+    return out;
+}
+
+bool varray_parallel_reduce(ThreadPool *pool, const ValueArray *array,
+                            void *acc, size_t acc_size,
+                            void (*accumulate)(void *acc, const void *elem, void *ctx),
+                            void (*combine)(void *acc, const void *other, void *ctx),
+                            void *ctx)
+{
+    if (!array || !acc || acc_size == 0 || !accumulate || !combine)
+    {
+        fprintf(stderr, "Array, accumulator or function doesn't exist\n");
+        return false;
+    }
+
+    return run_reduce(pool, seq_of_varray(array), acc, acc_size, accumulate, combine, ctx);
+}
+
+ValueArray *varray_parallel_filter(ThreadPool *pool, const ValueArray *array,
+                                   bool (*pred)(const void *elem, void *ctx), void *ctx)
+{
+    if (!array || !pred)
+    {
+        fprintf(stderr, "Array or predicate doesn't exist\n");
+        return NULL;
+    }
+    if (array->size == 0)
+        return varray_create(array->elem_size, 0);
+
+    Job job = {0};
+    job.in = seq_of_varray(array);
+    job.ctx = ctx;
+    job.pred = pred;
+    size_t grain = grain_for(pool, array->size);
+    size_t total;
+    if (!run_filter_mark(pool, &job, grain, &total))
+        return NULL;
+
+    ValueArray *out = varray_create(array->elem_size, total);
+    if (out)
+    {
+        job.out = seq_of_varray(out);
+        thread_pool_parallel_for(pool, array->size, grain, filter_copy_range, &job);
+        out->size = total;
+    }
+    free(job.keep);
+    free(job.counts);
+    return out;
+}
@@ -0,0 +1,104 @@
+#ifndef ARRAY_PARALLEL_H
+#define ARRAY_PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dynamic_array.h"
+#include "value_array.h"
+#include "../common/thread_pool.h"
+
+/*
+ * 动态数组的并行 for_each / map / reduce / filter
+ *
+ * 对每个元素独立的变换（解析、打分、格式转换……）在百万级数组上是天然并行的。
+ * 这些函数把数组按块交给线程池（common/thread_pool.h），块由线程动态领取：
+ * - pool 为 NULL 时在调用线程上顺序执行，结果与并行时相同
+ * - 元素数少于 ARRAY_PARALLEL_MIN_CHUNK 时只有一块，也不会唤醒工作线程
+ * - 回调会在多个线程中同时调用，只能修改当前元素或自己的输出，共享状态需要调用者同步
+ * - 执行期间不能修改数组本身（push/insert/remove 等）
+ *
+ * DynamicArray 版本的回调收到数组里存的数据指针（与 array_find 相同），
+ * ValueArray 版本（varray_parallel_*）收到元素在数组内的地址。
+ */
+
+/* 每块至少这么多个元素，避免块太小时调度开销超过计算本身 */
+#define ARRAY_PARALLEL_MIN_CHUNK 1024
+
+/*
+ * ========================================
+ * DynamicArray
+ * ========================================
+ */
+
+/**
+ * 对每个元素调用 fn(data, ctx)
+ */
+void array_parallel_for_each(ThreadPool* pool, DynamicArray* array,
+                             void (*fn)(void* data, void* ctx), void* ctx);
+
+/**
+ * 生成新数组，第 i 个元素为 fn(array[i], ctx)，顺序与原数组相同
+ * @return 新数组（调用者负责释放其中的数据），失败返回NULL
+ */
+DynamicArray* array_parallel_map(ThreadPool* pool, const DynamicArray* array,
+                                 void* (*fn)(const void* data, void* ctx), void* ctx);
+
+/**
+ * 归约：acc 进入时是单位元（如求和时为 0），返回时是所有元素的归约结果
+ * @param acc 调用者提供的 acc_size 字节累加器
+ * @param accumulate 把一个元素累加进 acc：accumulate(acc, data, ctx)
+ * @param combine 把另一块的部分结果合并进 acc：combine(acc, other, ctx)
+ * 每块从单位元开始累加，部分结果按块的顺序合并，因此只要求运算满足结合律，
+ * 不要求交换律；每次调用的结果确定，与线程数无关
+ * @return 成功返回true，内存不足返回false（acc 不变）
+ */
+bool array_parallel_reduce(ThreadPool* pool, const DynamicArray* array,
+                           void* acc, size_t acc_size,
+                           void (*accumulate)(void* acc, const void* data, void* ctx),
+                           void (*combine)(void* acc, const void* other, void* ctx),
+                           void* ctx);
+
+/**
+ * 生成只含 pred(data, ctx) 为 true 的元素的新数组，保持原顺序（浅拷贝指针）
+ * pred 对每个元素只调用一次
+ * @return 新数组，失败返回NULL
+ */
+DynamicArray* array_parallel_filter(ThreadPool* pool, const DynamicArray* array,
+                                    bool (*pred)(const void* data, void* ctx), void* ctx);
+
+/*
+ * ========================================
+ * ValueArray
+ * ========================================
+ */
+
+/**
+ * 对每个元素调用 fn(elem, ctx)，elem 指向数组内的元素，可以原地修改
+ */
+void varray_parallel_for_each(ThreadPool* pool, ValueArray* array,
+                              void (*fn)(void* elem, void* ctx), void* ctx);
+
+/**
+ * 生成元素大小为 out_elem_size 的新数组，fn(elem, out, ctx) 把结果写入 out
+ * @return 新数组，失败返回NULL
+ */
+ValueArray* varray_parallel_map(ThreadPool* pool, const ValueArray* array, size_t out_elem_size,
+                                void (*fn)(const void* elem, void* out, void* ctx), void* ctx);
+
+/**
+ * 归约，语义同 array_parallel_reduce，accumulate 收到元素的地址
+ */
+bool varray_parallel_reduce(ThreadPool* pool, const ValueArray* array,
+                            void* acc, size_t acc_size,
+                            void (*accumulate)(void* acc, const void* elem, void* ctx),
+                            void (*combine)(void* acc, const void* other, void* ctx),
+                            void* ctx);
+
+/**
+ * 生成只含 pred(elem, ctx) 为 true 的元素拷贝的新数组，保持原顺序
+ * @return 新数组，失败返回NULL
+ */
+ValueArray* varray_parallel_filter(ThreadPool* pool, const ValueArray* array,
+                                   bool (*pred)(const void* elem, void* ctx), void* ctx);
+
+#endif /* ARRAY_PARALLEL_H */
@@ -0,0 +1,358 @@
+/*
+Implement of array_sort.h: introsort, (parallel) merge sort and binary search.
+
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "array_sort.h"
+
+// ranges this short are finished with insertion sort
+#define INSERTION_SORT_MAX 16
+#define SORT_MAX_THREADS 64
+// a thread is not worth starting for fewer elements than this
+#define SORT_MIN_PER_THREAD 4096
+
+typedef int (*CompareFn)(const void *a, const void *b);
+
+static inline void swap_ptr(void **a, void **b)
+{
+    void *tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+// stable: an element only moves left past strictly greater ones
+static void insertion_sort(void **a, size_t lo, size_t hi, CompareFn cmp)
+{
+    for (size_t i = lo + 1; i < hi; i++)
+    {
+        void *x = a[i];
+        size_t j = i;
+        while (j > lo && cmp(a[j - 1], x) > 0)
+        {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = x;
+    }
+}
+
+// ========== introsort ==========
+
+static void sift_down(void **a, size_t root, size_t n, CompareFn cmp)
+{
+    for (;;)
+    {
+        size_t child = 2 * root + 1;
+        if (child >= n)
+            return;
+        if (child + 1 < n && cmp(a[child], a[child + 1]) < 0)
+            child++;
+        if (cmp(a[root], a[child]) >= 0)
+            return;
+        swap_ptr(&a[root], &a[child]);
+        root = child;
+    }
+}
+
+static void heap_sort(void **a, size_t n, CompareFn cmp)
+{
+    for (size_t i = n / 2; i-- > 0;)
+        sift_down(a, i, n, cmp);
+    for (size_t end = n - 1; end > 0; end--)
+    {
+        swap_ptr(&a[0], &a[end]);
+        sift_down(a, 0, end, cmp);
+    }
+}
+
+static void introsort(void **a, size_t lo, size_t hi, size_t depth, CompareFn cmp)
+{
+    while (hi - lo > INSERTION_SORT_MAX)
+    {
+        if (depth == 0)
+        {
+            // quicksort is degenerating on this input: finish in O(n log n)
+            heap_sort(a + lo, hi - lo, cmp);
+            return;
+        }
+        depth--;
+
+        // median of three moved to a[lo], then Hoare partition
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(a[mid], a[lo]) < 0)
+            swap_ptr(&a[mid], &a[lo]);
+        if (cmp(a[hi - 1], a[lo]) < 0)
+            swap_ptr(&a[hi - 1], &a[lo]);
+        if (cmp(a[hi - 1], a[mid]) < 0)
+            swap_ptr(&a[hi - 1], &a[mid]);
+        swap_ptr(&a[lo], &a[mid]);
+        void *pivot = a[lo];
+
+        size_t i = lo, j = hi;
+        for (;;)
+        {
+            do
+                i++;
+            while (i < hi && cmp(a[i], pivot) < 0);
+            do
+                j--;
+            while (cmp(a[j], pivot) > 0);
+            if (i >= j)
+                break;
+            swap_ptr(&a[i], &a[j]);
+        }
+        swap_ptr(&a[lo], &a[j]);
+
+        // recurse into the smaller side, loop on the larger one
+        if (j - lo < hi - j - 1)
+        {
+            introsort(a, lo, j, depth, cmp);
+            lo = j + 1;
+        }
+        else
+        {
+            introsort(a, j + 1, hi, depth, cmp);
+            hi = j;
+        }
+    }
+    insertion_sort(a, lo, hi, cmp);
+}
+
+bool array_sort(DynamicArray *array, int (*compare)(const void *a, const void *b))
+{
+    if (!array || !compare)
+    {
+        fprintf(stderr, "Array or compare function doesn't exist\n");
+        return false;
+    }
+    if (array->size < 2)
+        return true;
+
+    size_t depth = 0;
+    for (size_t n = array->size; n > 1; n >>= 1)
+        depth += 2;
+    introsort(array->data, 0, array->size, depth, compare);
+    return true;
+}
+
+// ========== merge sort ==========
+
+// merge sorted src[lo, mid) and src[mid, hi) into dst[lo, hi); ties take the left run
+static void merge(void **dst, void *const *src, size_t lo, size_t mid, size_t hi, CompareFn cmp)
+{
+    size_t i = lo, j = mid, k = lo;
+    while (i < mid && j < hi)
+        dst[k++] = cmp(src[j], src[i]) < 0 ? src[j++] : src[i++];
+    memcpy(&dst[k], &src[i], (mid - i) * sizeof(void *));
+    k += mid - i;
+    memcpy(&dst[k], &src[j], (hi - j) * sizeof(void *));
+}
+
+// sorts a[lo, hi) using tmp[lo, mid) as scratch
+static void merge_sort(void **a, void **tmp, size_t lo, size_t hi, CompareFn cmp)
+{
+    if (hi - lo <= INSERTION_SORT_MAX)
+    {
+        insertion_sort(a, lo, hi, cmp);
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    merge_sort(a, tmp, lo, mid, cmp);
+    merge_sort(a, tmp, mid, hi, cmp);
+    if (cmp(a[mid - 1], a[mid]) <= 0)
+        return; // already in order, common for nearly sorted input
+
+    // move the left run out of the way and merge back into a
+    memcpy(&tmp[lo], &a[lo], (mid - lo) * sizeof(void *));
+    size_t i = lo, j = mid, k = lo;
+    while (i < mid && j < hi)
+        a[k++] = cmp(a[j], tmp[i]) < 0 ? a[j++] : tmp[i++];
+    memcpy(&a[k], &tmp[i], (mid - i) * sizeof(void *));
+}
+
+typedef struct
+{
+    void **a;
+    void **tmp;
+    size_t lo, mid, hi;
+    CompareFn cmp;
+} SortJob;
+
+static void *sort_worker(void *arg)
+{
+    SortJob *job = (SortJob *)arg;
+    merge_sort(job->a, job->tmp, job->lo, job->hi, job->cmp);
+    return NULL;
+}
+
+static void *merge_worker(void *arg)
+{
+    SortJob *job = (SortJob *)arg;
+    // a is the source, tmp the destination for this round
+    merge(job->tmp, job->a, job->lo, job->mid, job->hi, job->cmp);
+    return NULL;
+}
+
+// runs jobs[1..n) on new threads and jobs[0] on the caller; a job whose thread
+// fails to start is run by the caller too
+static void run_jobs(SortJob *jobs, size_t n, void *(*fn)(void *))
+{
+    pthread_t threads[SORT_MAX_THREADS];
+    bool started[SORT_MAX_THREADS];
+    for (size_t t = 1; t < n; t++)
+        started[t] = pthread_create(&threads[t], NULL, fn, &jobs[t]) == 0;
+    fn(&jobs[0]);
+    for (size_t t = 1; t < n; t++)
+    {
+        if (started[t])
+            pthread_join(threads[t], NULL);
+        else
+            fn(&jobs[t]);
+    }
+}
+
+static void parallel_merge_sort(void **data, void **tmp, size_t n, size_t nthreads, CompareFn cmp)
+{
+    // sort one chunk per thread
+    size_t bounds[SORT_MAX_THREADS + 1];
+    SortJob jobs[SORT_MAX_THREADS];
+    size_t runs = nthreads;
+    for (size_t t = 0; t <= runs; t++)
+        bounds[t] = n / runs * t + (t < n % runs ? t : n % runs);
+    for (size_t t = 0; t < runs; t++)
+        jobs[t] = (SortJob){data, tmp, bounds[t], 0, bounds[t + 1], cmp};
+    run_jobs(jobs, runs, sort_worker);
+
+    // merge adjacent runs pairwise, ping-ponging between data and tmp
+    void **src = data, **dst = tmp;
+    while (runs > 1)
+    {
+        size_t pairs = runs / 2;
+        for (size_t p = 0; p < pairs; p++)
+            jobs[p] = (SortJob){src, dst, bounds[2 * p], bounds[2 * p + 1], bounds[2 * p + 2], cmp};
+        run_jobs(jobs, pairs, merge_worker);
+        if (runs % 2)
+        {
+            size_t lo = bounds[runs - 1];
+            memcpy(&dst[lo], &src[lo], (n - lo) * sizeof(void *));
+        }
+
+        size_t next = 0;
+        for (size_t r = 0; r <= runs; r += 2)
+            bounds[next++] = bounds[r];
+        if (runs % 2 == 0)
+            next--;
+        bounds[next] = n;
+        runs = next;
+
+        void **swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != data)
+        memcpy(data, src, n * sizeof(void *));
+}
+
+static bool stable_sort(DynamicArray *array, CompareFn cmp, size_t nthreads)
+{
+    size_t n = array->size;
+    void **tmp = malloc(n * sizeof(void *));
+    if (!tmp)
+    {
+        fprintf(stderr, "Failed to allocate memory for sort buffer\n");
+        return false;
+    }
+
+    if (nthreads > SORT_MAX_THREADS)
+        nthreads = SORT_MAX_THREADS;
+    if (nthreads > n / SORT_MIN_PER_THREAD)
+        nthreads = n / SORT_MIN_PER_THREAD;
+    if (nthreads > 1)
+        parallel_merge_sort(array->data, tmp, n, nthreads, cmp);
+    else
+        merge_sort(array->data, tmp, 0, n, cmp);
+
+    free(tmp);
+    return true;
+}
+
+static size_t online_cpus(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 1 ? (size_t)cpus : 1;
+}
+
+bool array_sort_stable(DynamicArray *array, int (*compare)(const void *a, const void *b))
+{
+    if (!array || !compare)
+    {
+        fprintf(stderr, "Array or compare function doesn't exist\n");
+        return false;
+    }
+    if (array->size < 2)
+        return true;
+
+    size_t nthreads = array->size >= ARRAY_PARALLEL_SORT_MIN ? online_cpus() : 1;
+    return stable_sort(array, compare, nthreads);
+}
+
+bool array_sort_parallel(DynamicArray *array, int (*compare)(const void *a, const void *b),
+                         size_t nthreads)
+{
+    if (!array || !compare)
+    {
+        fprintf(stderr, "Array or compare function doesn't exist\n");
+        return false;
+    }
+    if (array->size < 2)
+        return true;
+
+    return stable_sort(array, compare, nthreads ? nthreads : online_cpus());
+}
+
+// ========== binary search ==========
+
+size_t array_lower_bound(const DynamicArray *array, const void *key,
+                         int (*compare)(const void *a, const void *b))
+{
+    if (!array || !compare)
+    {
+        fprintf(stderr, "Array or compare function doesn't exist\n");
+        return 0;
+    }
+
+    size_t lo = 0, hi = array->size;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compare(array->data[mid], key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+size_t array_bsearch(const DynamicArray *array, const void *key,
+                     int (*compare)(const void *a, const void *b))
+{
+    if (!array || !compare)
+    {
+        fprintf(stderr, "Array or compare function doesn't exist\n");
+        return ARRAY_NPOS;
+    }
+
+    size_t i = array_lower_bound(array, key, compare);
+    if (i < array->size && compare(array->data[i], key) == 0)
+        return i;
+    return ARRAY_NPOS;
+}
@@ -0,0 +1,68 @@
+#ifndef ARRAY_SORT_H
+#define ARRAY_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dynamic_array.h"
+
+/*
+ * 动态数组的排序与二分查找
+ *
+ * array_find 是 O(n) 的线性扫描；对排好序的大数组（如 ID 列表）先 array_sort，
+ * 之后每次成员查询用 array_bsearch / array_lower_bound，只需 O(log n)。
+ *
+ * 比较函数与 array_find 相同：收到两个元素（数组里存的数据指针），
+ * a < b 返回负数，相等返回0，a > b 返回正数，common.h 里的 compare_int 等可以直接用。
+ * 并行排序会在多个线程中同时调用比较函数，它不能修改共享状态。
+ *
+ * 单独成一个模块（array_sort.c）是因为并行归并排序依赖 pthread：
+ * 只用 dynamic_array.c 的代码（如链式哈希表）不需要链接 -pthread。
+ */
+
+/* array_bsearch 找不到时的返回值 */
+#define ARRAY_NPOS ((size_t)-1)
+
+/* array_sort_stable 在元素数不少于该值时使用多线程归并排序 */
+#define ARRAY_PARALLEL_SORT_MIN (1 << 16)
+
+/**
+ * 原地排序（内省排序，不稳定）
+ * 快速排序（三数取中），递归深度超过 2·log2(n) 时改用堆排序，小区间用插入排序；
+ * 最坏 O(n log n)，不分配额外内存
+ * @return 成功返回true，array 或 compare 为 NULL 时返回false
+ */
+bool array_sort(DynamicArray* array, int (*compare)(const void* a, const void* b));
+
+/**
+ * 稳定排序（归并排序），相等元素保持原来的先后顺序
+ * 需要 size 个指针的临时缓冲区；元素数不少于 ARRAY_PARALLEL_SORT_MIN 时
+ * 按在线 CPU 数分段并行排序，再并行两两归并
+ * @return 成功返回true，内存不足返回false（数组不变）
+ */
+bool array_sort_stable(DynamicArray* array, int (*compare)(const void* a, const void* b));
+
+/**
+ * 多线程稳定归并排序，不受 ARRAY_PARALLEL_SORT_MIN 限制
+ * @param nthreads 线程数（含调用线程），0 表示在线 CPU 数
+ * @return 成功返回true，内存不足返回false（数组不变）
+ */
+bool array_sort_parallel(DynamicArray* array, int (*compare)(const void* a, const void* b),
+                         size_t nthreads);
+
+/**
+ * 在升序数组中找第一个不小于 key 的位置
+ * @return [0, size] 内的索引；所有元素都小于 key 时返回 size，array 或 compare 为 NULL 时返回 0
+ * key 可以插入到返回的位置而保持有序（array_insert_at）
+ */
+size_t array_lower_bound(const DynamicArray* array, const void* key,
+                         int (*compare)(const void* a, const void* b));
+
+/**
+ * 在升序数组中二分查找与 key 相等的元素
+ * @return 第一个相等元素的索引，找不到返回 ARRAY_NPOS
+ * 时间复杂度：O(log n)
+ */
+size_t array_bsearch(const DynamicArray* array, const void* key,
+                     int (*compare)(const void* a, const void* b));
+
+#endif /* ARRAY_SORT_H */
@@ -0,0 +1,173 @@
+/**
+ * bench_array.c - DynamicArray 扩容/缩容策略的基准测试
+ *
+ * 对几种 push/pop 密集的操作序列，比较不同容量策略下：
+ *   - reallocs：容量变化次数（每次都是一次 realloc 调用）
+ *   - moved：realloc 返回了新地址的次数
+ *   - copied(MB)：每次 realloc 原地扩展失败时需要拷贝的字节数（旧块与新块中较小者）之和，
+ *     是拷贝量的上界；glibc 对大块（默认 >= 128KB）用 mremap 换地址，实际不拷贝
+ *   - peak：最大容量（元素个数），反映内存占用的峰值
+ *   - ms：整个序列的墙钟时间
+ *
+ * 操作序列：
+ *   append     连续 push n 个元素
+ *   fill-drain 每轮 push n 个再全部 pop，共 rounds 轮（工作栈、批处理缓冲区）
+ *   sawtooth   随机游走：每步 push 或 pop 一段 1..64 个元素，size 在 [0, n] 内来回
+ *
+ * 编译: gcc -std=c99 -O2 -o bench_array bench_array.c dynamic_array.c ../common/common.c
+ * 用法: ./bench_array [n] [rounds]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "dynamic_array.h"
+
+typedef struct
+{
+    const char *name;
+    double growth;
+    bool auto_shrink;
+    bool reserve;
+} Policy;
+
+typedef struct
+{
+    size_t reallocs;
+    size_t moved;
+    size_t copied;
+    size_t peak;
+} Counters;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t xorshift64(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// capacity only changes through realloc inside the array, so watching it after
+// every operation counts reallocs without hooking the allocator
+static void observe(const DynamicArray *arr, void ***data, size_t *cap, Counters *c)
+{
+    if (arr->capacity != *cap)
+    {
+        c->reallocs++;
+        if (arr->data != *data)
+            c->moved++;
+        c->copied += (*cap < arr->capacity ? *cap : arr->capacity) * sizeof(void *);
+        if (arr->capacity > c->peak)
+            c->peak = arr->capacity;
+        *data = arr->data;
+        *cap = arr->capacity;
+    }
+}
+
+static void push(DynamicArray *arr, void ***data, size_t *cap, Counters *c)
+{
+    static int payload;
+    array_push_back(arr, &payload);
+    observe(arr, data, cap, c);
+}
+
+static void pop(DynamicArray *arr, void ***data, size_t *cap, Counters *c)
+{
+    array_pop_back(arr);
+    observe(arr, data, cap, c);
+}
+
+static void run(const char *trace, const Policy *p, size_t n, size_t rounds)
+{
+    DynamicArray *arr = array_create(0);
+    array_set_growth_factor(arr, p->growth);
+    array_set_auto_shrink(arr, p->auto_shrink);
+
+    Counters c = {0, 0, 0, arr->capacity};
+    void **data = arr->data;
+    size_t cap = arr->capacity;
+    rng_state = 88172645463325252ULL;
+
+    double t0 = now_ms();
+    if (p->reserve)
+    {
+        array_reserve(arr, n);
+        observe(arr, &data, &cap, &c);
+    }
+
+    if (trace[0] == 'a')
+    {
+        for (size_t i = 0; i < n; i++)
+            push(arr, &data, &cap, &c);
+    }
+    else if (trace[0] == 'f')
+    {
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (size_t i = 0; i < n; i++)
+                push(arr, &data, &cap, &c);
+            for (size_t i = 0; i < n; i++)
+                pop(arr, &data, &cap, &c);
+        }
+    }
+    else
+    {
+        for (size_t step = 0; step < rounds * n / 32; step++)
+        {
+            size_t burst = (size_t)(xorshift64() % 64) + 1;
+            bool up = xorshift64() & 1;
+            for (size_t i = 0; i < burst; i++)
+            {
+                if (up && arr->size < n)
+                    push(arr, &data, &cap, &c);
+                else if (!up && arr->size > 0)
+                    pop(arr, &data, &cap, &c);
+            }
+        }
+    }
+    double ms = now_ms() - t0;
+
+    printf("%-11s %-18s %9zu %9zu %11.2f %10zu %9.2f\n", trace, p->name,
+           c.reallocs, c.moved, c.copied / (1024.0 * 1024.0), c.peak, ms);
+    array_destroy(&arr);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000;
+    size_t rounds = argc > 2 ? strtoull(argv[2], NULL, 10) : 100;
+    if (n == 0 || rounds == 0)
+    {
+        fprintf(stderr, "usage: %s [n] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    const Policy policies[] = {
+        {"x2 shrink", 2.0, true, false},
+        {"x1.5 shrink", 1.5, true, false},
+        {"x2 no-shrink", 2.0, false, false},
+        {"x1.5 no-shrink", 1.5, false, false},
+        {"reserve(n)", 2.0, true, true},
+    };
+    const char *traces[] = {"append", "fill-drain", "sawtooth"};
+
+    printf("n=%zu rounds=%zu\n", n, rounds);
+    printf("%-11s %-18s %9s %9s %11s %10s %9s\n", "trace", "policy",
+           "reallocs", "moved", "copied(MB)", "peak", "ms");
+    for (size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++)
+        for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++)
+            run(traces[t], &policies[i], n, rounds);
+    return 0;
+}
@@ -6,6 +6,8 @@ Implement of dynamic array.
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
 #include "dynamic_array.h"
 #include "../common/common.h"
 
@@ -34,6 +36,9 @@ DynamicArray *array_create(size_t initial_capacity)
     }
     new_array->capacity = initial_capacity;
     new_array->size = 0;
+    new_array->min_capacity = 0;
+    new_array->growth_factor = ARRAY_DEFAULT_GROWTH;
+    new_array->auto_shrink = true;
 
     return new_array;
 }
@@ -84,34 +89,157 @@ bool array_is_empty(const DynamicArray *array)
     return array->size == 0;
 }
 
-// insert, delete
-bool array_push_back(DynamicArray *array, void *data)
+// resize
+static bool resize_to(DynamicArray *array, size_t new_capacity)
+{
+    void **new_data = realloc(array->data, new_capacity * sizeof(void *));
+    if (!new_data)
+        return false;
+    array->data = new_data;
+    array->capacity = new_capacity;
+    return true;
+}
+
+static bool grow(DynamicArray *array)
+{
+    // compute in double so factors like 1.5 work; always add at least one slot
+    double want = (double)array->capacity * array->growth_factor;
+    if (want >= (double)(SIZE_MAX / sizeof(void *)))
+    {
+        fprintf(stderr, "Exceeded maximum array capacity\n");
+        return false;
+    }
+    size_t new_capacity = (size_t)want;
+    if (new_capacity <= array->capacity)
+        new_capacity = array->capacity + 1;
+    if (!resize_to(array, new_capacity))
+    {
+        fprintf(stderr, "Failed to reallocate memory for data\n");
+        return false;
+    }
+    return true;
+}
+
+static void shrink_if_sparse(DynamicArray *array)
+{
+    if (!array->auto_shrink)
+        return;
+    size_t new_capacity = array->capacity / 2;
+    if (array->size < array->capacity / 4 && new_capacity >= 1 &&
+        new_capacity >= array->min_capacity)
+    {
+        if (!resize_to(array, new_capacity))
+            fprintf(stderr, "Shrink failed: memory reallocation failed\n");
+    }
+}
+
+// make room for extra more elements with at most one realloc
+static bool ensure_room(DynamicArray *array, size_t extra)
+{
+    if (extra > SIZE_MAX / sizeof(void *) - array->size)
+    {
+        fprintf(stderr, "Exceeded maximum array capacity\n");
+        return false;
+    }
+    size_t need = array->size + extra;
+    if (need <= array->capacity)
+        return true;
+
+    // grow geometrically unless the batch alone needs more
+    double want = (double)array->capacity * array->growth_factor;
+    size_t new_capacity = want < (double)(SIZE_MAX / sizeof(void *)) ? (size_t)want : need;
+    if (new_capacity < need)
+        new_capacity = need;
+    if (!resize_to(array, new_capacity))
+    {
+        fprintf(stderr, "Failed to reallocate memory for data\n");
+        return false;
+    }
+    return true;
+}
+
+bool array_reserve(DynamicArray *array, size_t n)
 {
     if (!array)
     {
         fprintf(stderr, "Array doesn't exist\n");
         return false;
     }
+    if (n > SIZE_MAX / sizeof(void *))
+    {
+        fprintf(stderr, "Exceeded maximum array capacity\n");
+        return false;
+    }
 
-    if (array->size == array->capacity)
+    if (n > array->capacity && !resize_to(array, n))
     {
-        if (array->capacity > SIZE_MAX / 2)
-        {
-            fprintf(stderr, "Exceeded maximum array capacity\n");
-            return false;
-        }
-        size_t new_capacity = array->capacity * 2;
-        void **new_data = realloc(array->data, new_capacity * sizeof(void *));
-        if (!new_data)
-        {
-            fprintf(stderr, "Failed to reallocate memory for data\n");
-            return false;
-        }
-        // copy to new mem
-        array->data = new_data;
-        array->capacity = new_capacity;
+        fprintf(stderr, "Failed to reallocate memory for data\n");
+        return false;
+    }
+    array->min_capacity = n;
+    return true;
+}
+
+bool array_shrink_to_fit(DynamicArray *array)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+
+    array->min_capacity = 0;
+    size_t new_capacity = array->size ? array->size : 1;
+    if (new_capacity == array->capacity)
+        return true;
+    if (!resize_to(array, new_capacity))
+    {
+        fprintf(stderr, "Shrink failed: memory reallocation failed\n");
+        return false;
+    }
+    return true;
+}
+
+bool array_set_growth_factor(DynamicArray *array, double factor)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+    if (!(factor > 1.0))
+    {
+        fprintf(stderr, "Growth factor must be greater than 1\n");
+        return false;
+    }
+
+    array->growth_factor = factor;
+    return true;
+}
+
+void array_set_auto_shrink(DynamicArray *array, bool enabled)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return;
     }
 
+    array->auto_shrink = enabled;
+}
+
+// insert, delete
+bool array_push_back(DynamicArray *array, void *data)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+
+    if (array->size == array->capacity && !grow(array))
+        return false;
+
     array->data[array->size] = data;
     array->size++;
 
@@ -132,26 +260,12 @@ void *array_pop_back(DynamicArray *array)
     }
 
     // pop data
-    size_t capacity = array->capacity;
     void *data = array->data[array->size - 1];
     array->size--;
 
     array->data[array->size] = NULL;
 
-    // shrink
-    if (array->size < capacity / 4 && array->capacity > 1)
-    {
-        size_t new_capacity = capacity / 2;
-        void **new_data = realloc(array->data, new_capacity * sizeof(void *));
-        if (!new_data)
-        {
-            fprintf(stderr, "Shrink failed: memory reallocation failed\n");
-            return data;
-        }
-        array->data = new_data;
-        array->capacity = new_capacity;
-    }
-
+    shrink_if_sparse(array);
     return data;
 }
 
@@ -168,24 +282,8 @@ bool array_insert_at(DynamicArray *array, size_t index, void *data)
         return false;
     }
 
-    if (array->size == array->capacity)
-    {
-        if (array->capacity > SIZE_MAX / 2)
-        {
-            fprintf(stderr, "Exceeded maximum array capacity\n");
-            return false;
-        }
-        size_t new_capacity = array->capacity * 2;
-        void **new_data = realloc(array->data, new_capacity * sizeof(void *));
-        if (!new_data)
-        {
-            fprintf(stderr, "Failed to reallocate memory for data\n");
-            return false;
-        }
-        // copy to new mem
-        array->data = new_data;
-        array->capacity = new_capacity;
-    }
+    if (array->size == array->capacity && !grow(array))
+        return false;
 
     if (index < array->size)
     {
@@ -212,29 +310,121 @@ void *array_remove_at(DynamicArray *array, size_t index)
     }
 
     // remove data
-    size_t capacity = array->capacity;
+    void *data = array->data[index];
     memmove(
         &array->data[index], &array->data[index + 1],
-        (array->size - index) * sizeof(void *));
+        (array->size - index - 1) * sizeof(void *));
 
     array->data[array->size - 1] = NULL;
     array->size--;
 
-    // shrink
-    if (array->size < capacity / 4 && array->capacity > 1)
-    {
-        size_t new_capacity = capacity / 2;
-        void **new_data = realloc(array->data, new_capacity * sizeof(void *));
-        if (new_data)
-        {
-            array->data = new_data;
-            array->capacity = new_capacity;
-        }
-        else
-        {
+    shrink_if_sparse(array);
+    return data;
+}
+
+// bulk operations
+bool array_append_n(DynamicArray *array, void *const *items, size_t n)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+
+    return array_insert_range(array, array->size, items, n);
+}
+
+bool array_insert_range(DynamicArray *array, size_t index, void *const *items, size_t n)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+    if (index > array->size)
+    {
+        fprintf(stderr, "Index %zu out of bounds [0, %zu]\n", index, array->size);
+        return false;
+    }
+    if (n == 0)
+        return true;
+    if (!items)
+    {
+        fprintf(stderr, "Items don't exist\n");
+        return false;
+    }
+
+    if (!ensure_room(array, n))
+        return false;
+
+    if (index < array->size)
+    {
+        memmove(&array->data[index + n], &array->data[index],
+                (array->size - index) * sizeof(void *));
+    }
+    memcpy(&array->data[index], items, n * sizeof(void *));
+    array->size += n;
+
+    return true;
+}
+
+bool array_erase_range(DynamicArray *array, size_t index, size_t count, void **out)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+    if (index > array->size || count > array->size - index)
+    {
+        fprintf(stderr, "Range [%zu, %zu + %zu) out of bounds [0, %zu)\n",
+                index, index, count, array->size);
+        return false;
+    }
+    if (count == 0)
+        return true;
+
+    if (out)
+        memcpy(out, &array->data[index], count * sizeof(void *));
+    memmove(&array->data[index], &array->data[index + count],
+            (array->size - index - count) * sizeof(void *));
+    array->size -= count;
+    memset(&array->data[array->size], 0, count * sizeof(void *));
+
+    // apply the 1/4 rule as many times as it would fire, with a single realloc
+    if (array->auto_shrink)
+    {
+        size_t new_capacity = array->capacity;
+        while (array->size < new_capacity / 4 && new_capacity / 2 >= 1 &&
+               new_capacity / 2 >= array->min_capacity)
+            new_capacity /= 2;
+        if (new_capacity != array->capacity && !resize_to(array, new_capacity))
             fprintf(stderr, "Shrink failed: memory reallocation failed\n");
-        }
     }
+
+    return true;
+}
+
+bool array_extend(DynamicArray *dst, const DynamicArray *src)
+{
+    if (!dst || !src)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+
+    if (dst != src)
+        return array_insert_range(dst, dst->size, src->data, src->size);
+
+    // self-extend: src->data moves with the realloc, so copy after growing
+    size_t n = dst->size;
+    if (n == 0)
+        return true;
+    if (!ensure_room(dst, n))
+        return false;
+    memcpy(&dst->data[n], dst->data, n * sizeof(void *));
+    dst->size += n;
+    return true;
 }
 
 // get functions
@@ -279,10 +469,12 @@ int array_find(const DynamicArray *array, const void *data,
         return -1;
     }
 
-    for (int i = 0; i < array->size; i++)
+    // the result is an int: indices past INT_MAX cannot be reported
+    size_t limit = array->size < (size_t)INT_MAX ? array->size : (size_t)INT_MAX;
+    for (size_t i = 0; i < limit; i++)
     {
         if (compare(array->data[i], data) == 0)
-            return i;
+            return (int)i;
     }
 
     return -1;
@@ -379,6 +571,11 @@ DynamicArray *array_clone(const DynamicArray *array, void *(*clone_data)(const v
     }
 
     DynamicArray *new_array = array_create(array->capacity);
+    if (!new_array)
+        return NULL;
+    new_array->min_capacity = array->min_capacity;
+    new_array->growth_factor = array->growth_factor;
+    new_array->auto_shrink = array->auto_shrink;
     for (int i = 0; i < array->size; i++)
     {
         new_array->data[i] = clone_data ? clone_data(array->data[i]) : array->data[i];
@@ -20,8 +20,13 @@ typedef struct DynamicArray {
     void** data;         // 存储数据指针的数组
     size_t size;         // 当前元素数量
     size_t capacity;     // 当前容量
+    size_t min_capacity; // 自动缩容的下限，由 array_reserve 设置
+    double growth_factor; // 满时容量乘以的倍数，默认 ARRAY_DEFAULT_GROWTH
+    bool auto_shrink;    // size < capacity/4 时是否自动减半，默认 true
 } DynamicArray;
 
+#define ARRAY_DEFAULT_GROWTH 2.0
+
 /* 
  * ========================================
  * 基础操作：创建和销毁
@@ -142,6 +147,93 @@ bool array_insert_at(DynamicArray* array, size_t index, void* data);
  */
 void* array_remove_at(DynamicArray* array, size_t index);
 
+/* 
+ * ========================================
+ * 批量操作
+ * ========================================
+ *
+ * 逐个 push_back / insert_at 装入 n 个元素要做 n 次检查，插入中间时还要做 n 次重叠的
+ * memmove（O(n·size)）。下面的函数最多扩容一次、只做一次 memmove，整体 O(size + n)。
+ */
+
+/**
+ * 在尾部追加 n 个元素
+ * @param array 动态数组
+ * @param items n 个数据指针，不能指向 array 自身的存储（自身追加用 array_extend）
+ * @param n 元素个数，0 时什么也不做
+ * @return 成功返回true，失败返回false（数组不变）
+ */
+bool array_append_n(DynamicArray* array, void* const* items, size_t n);
+
+/**
+ * 在 index 处插入 n 个元素，原来 [index, size) 的元素整体后移
+ * @param array 动态数组
+ * @param index 插入位置，可以等于 size
+ * @param items n 个数据指针，不能指向 array 自身的存储
+ * @param n 元素个数
+ * @return 成功返回true，失败返回false（数组不变）
+ */
+bool array_insert_range(DynamicArray* array, size_t index, void* const* items, size_t n);
+
+/**
+ * 移除 [index, index + count) 的元素
+ * @param array 动态数组
+ * @param index 起始位置
+ * @param count 移除个数，index + count 不能超过 size
+ * @param out 非 NULL 时依次写入被移除的 count 个数据指针（供调用者释放）
+ * @return 成功返回true，越界返回false
+ * 自动缩容时一次 realloc 直接缩到合适的容量
+ */
+bool array_erase_range(DynamicArray* array, size_t index, size_t count, void** out);
+
+/**
+ * 把 src 的全部元素追加到 dst 尾部（浅拷贝指针），dst 和 src 可以是同一个数组
+ * @return 成功返回true，失败返回false（dst 不变）
+ */
+bool array_extend(DynamicArray* dst, const DynamicArray* src);
+
+/* 
+ * ========================================
+ * 容量控制
+ * ========================================
+ *
+ * 默认策略：满时容量翻倍，pop/remove 后 size < capacity/4 时减半。
+ * 反复“装满 -> 清空”的工作栈、批处理缓冲区每一轮都要 realloc log(n) 次，
+ * 这时用 array_reserve 预留容量，或关闭自动缩容。
+ */
+
+/**
+ * 预留容量：保证 capacity >= n，并把 n 作为自动缩容的下限
+ * @param array 动态数组
+ * @param n 需要的容量
+ * @return 成功返回true，内存不足返回false（数组不变）
+ * 之后 size 不超过 n 的 push/insert/pop/remove 都不会 realloc
+ */
+bool array_reserve(DynamicArray* array, size_t n);
+
+/**
+ * 把容量缩到 size（至少为 1），并清除 array_reserve 设置的下限
+ * @param array 动态数组
+ * @return 成功返回true，失败返回false
+ */
+bool array_shrink_to_fit(DynamicArray* array);
+
+/**
+ * 设置扩容倍数
+ * @param array 动态数组
+ * @param factor 满时新容量 = 旧容量 * factor（至少加 1），必须大于 1
+ * @return 成功返回true，factor 不合法返回false
+ * 1.5 倍比 2 倍多几次 realloc，但空闲容量最多约 1/3 而不是 1/2
+ */
+bool array_set_growth_factor(DynamicArray* array, double factor);
+
+/**
+ * 开启或关闭自动缩容
+ * @param array 动态数组
+ * @param enabled false 时 pop/remove 不再 realloc，容量只能由 array_shrink_to_fit 收回
+ */
+void array_set_auto_shrink(DynamicArray* array, bool enabled);
+
 /* 
  * ========================================
  * 查找操作
@@ -155,6 +247,8 @@ void* array_remove_at(DynamicArray* array, size_t index);
  * @param compare 比较函数
  * @return 找到返回索引，未找到返回-1
  * 时间复杂度：O(n)
+ * 注意：返回 int，只能表示 INT_MAX 以内的索引，更靠后的元素视为未找到；
+ * 大数组排序后用 array_bsearch / array_lower_bound（array_sort.h，返回 size_t）
  */
 int array_find(const DynamicArray* array, const void* data, 
               int (*compare)(const void* a, const void* b));
@@ -1,4 +1,7 @@
 #include "dynamic_array.h"
+#include "value_array.h"
+#include "array_sort.h"
+#include "array_parallel.h"
 #include "../common/common.h"
 #include <assert.h>
 
@@ -325,8 +328,527 @@ void test_array_clone()
     printf("✅ array_clone 测试通过\n\n");
 }
 
+typedef struct
+{
+    int id;
+    double score;
+} Record;
+
+ARRAY_DEFINE(IntArray, int)
+ARRAY_DEFINE(RecordArray, Record)
+
+void test_dynamic_array_capacity_control()
+{
+    printf("=== 测试 reserve / shrink_to_fit / 扩容策略 ===\n");
+
+    int x = 1;
+    DynamicArray *arr = array_create(0);
+    assert(arr->growth_factor == ARRAY_DEFAULT_GROWTH && arr->auto_shrink);
+
+    // reserve: 之后装满和清空都不再 realloc
+    assert(array_reserve(arr, 1000));
+    assert(array_capacity(arr) == 1000);
+    void **data = arr->data;
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 1000; i++)
+            assert(array_push_back(arr, &x));
+        while (!array_is_empty(arr))
+            assert(array_pop_back(arr) == &x);
+        assert(arr->data == data && array_capacity(arr) == 1000);
+    }
+
+    // shrink_to_fit 收回容量并清除下限
+    for (int i = 0; i < 10; i++)
+        array_push_back(arr, &x);
+    assert(array_shrink_to_fit(arr));
+    assert(array_capacity(arr) == 10 && array_size(arr) == 10);
+    array_clear(arr);
+    assert(array_shrink_to_fit(arr));
+    assert(array_capacity(arr) == 1);
+
+    // 1.5 倍扩容
+    assert(!array_set_growth_factor(arr, 1.0));
+    assert(!array_set_growth_factor(NULL, 1.5));
+    assert(array_set_growth_factor(arr, 1.5));
+    size_t prev = array_capacity(arr);
+    for (int i = 0; i < 100; i++)
+    {
+        assert(array_push_back(arr, &x));
+        size_t cap = array_capacity(arr);
+        if (cap != prev)
+        {
+            assert(cap == (prev * 3 / 2 > prev ? prev * 3 / 2 : prev + 1));
+            prev = cap;
+        }
+    }
+    assert(array_capacity(arr) < 200);
+
+    // 关闭自动缩容：pop 到空也保持容量
+    array_set_auto_shrink(arr, false);
+    size_t cap = array_capacity(arr);
+    while (!array_is_empty(arr))
+        array_pop_back(arr);
+    assert(array_capacity(arr) == cap);
+
+    // 开启自动缩容：remove_at 按 1/4 规则减半，并返回被移除的元素
+    array_set_auto_shrink(arr, true);
+    int nums[3] = {1, 2, 3};
+    for (int i = 0; i < 3; i++)
+        array_push_back(arr, &nums[i]);
+    assert(array_remove_at(arr, 1) == &nums[1]);
+    assert(array_capacity(arr) == cap / 2);
+    assert(*(int *)array_get_at(arr, 1) == 3);
+
+    DynamicArray *copy = array_clone(arr, NULL);
+    assert(copy->growth_factor == 1.5 && copy->auto_shrink);
+    array_destroy(&copy);
+
+    array_destroy(&arr);
+    printf("✅ 容量控制测试通过\n\n");
+}
+
+void test_dynamic_array_bulk()
+{
+    printf("=== 测试 append_n / insert_range / erase_range / extend ===\n");
+
+    int nums[10];
+    void *items[10];
+    for (int i = 0; i < 10; i++)
+    {
+        nums[i] = i;
+        items[i] = &nums[i];
+    }
+
+    DynamicArray *arr = array_create(2);
+    assert(array_append_n(arr, items, 4)); // [0, 1, 2, 3]
+    assert(array_size(arr) == 4);
+    assert(array_append_n(arr, NULL, 0));
+
+    // 一次插入 100 个元素只扩容一次
+    void *many[100];
+    for (int i = 0; i < 100; i++)
+        many[i] = &nums[9];
+    size_t cap = array_capacity(arr);
+    assert(array_insert_range(arr, 2, many, 100)); // [0, 1, 9 x 100, 2, 3]
+    assert(array_capacity(arr) > cap && array_capacity(arr) >= 104);
+    assert(array_size(arr) == 104);
+    assert(*(int *)array_get_at(arr, 1) == 1);
+    assert(*(int *)array_get_at(arr, 2) == 9);
+    assert(*(int *)array_get_at(arr, 101) == 9);
+    assert(*(int *)array_get_at(arr, 102) == 2);
+    assert(*(int *)array_get_at(arr, 103) == 3);
+
+    // 越界
+    assert(!array_insert_range(arr, 105, items, 1));
+    assert(!array_erase_range(arr, 100, 5, NULL));
+    assert(!array_erase_range(arr, 105, 0, NULL));
+
+    // 移除中间 100 个，被移除的指针写入 out，容量一次缩到位
+    void *out[100];
+    assert(array_erase_range(arr, 2, 100, out));
+    assert(out[0] == &nums[9] && out[99] == &nums[9]);
+    assert(array_size(arr) == 4);
+    assert(array_capacity(arr) >= 4 && array_capacity(arr) < 16);
+    for (int i = 0; i < 4; i++)
+        assert(*(int *)array_get_at(arr, i) == i);
+
+    // extend：从另一个数组追加，以及追加自身
+    DynamicArray *tail = array_create(0);
+    array_append_n(tail, items + 4, 6);
+    assert(array_extend(arr, tail));
+    assert(array_size(arr) == 10 && array_size(tail) == 6);
+    for (int i = 0; i < 10; i++)
+        assert(*(int *)array_get_at(arr, i) == i);
+    assert(array_extend(arr, arr));
+    assert(array_size(arr) == 20);
+    for (int i = 0; i < 20; i++)
+        assert(*(int *)array_get_at(arr, i) == i % 10);
+
+    // 头部插入后全部移除
+    assert(array_insert_range(arr, 0, items, 3));
+    assert(*(int *)array_get_at(arr, 3) == 0 && *(int *)array_get_at(arr, 2) == 2);
+    assert(array_erase_range(arr, 0, array_size(arr), NULL));
+    assert(array_is_empty(arr));
+
+    array_destroy(&tail);
+    array_destroy(&arr);
+    printf("✅ 批量操作测试通过\n\n");
+}
+
+static bool is_sorted_int(const DynamicArray *arr)
+{
+    for (size_t i = 1; i < arr->size; i++)
+        if (*(int *)arr->data[i - 1] > *(int *)arr->data[i])
+            return false;
+    return true;
+}
+
+// sort by value only; the index into the backing array tells equal keys apart
+static int compare_pair_key(const void *a, const void *b)
+{
+    return ((const int *)a)[0] - ((const int *)b)[0];
+}
+
+void test_dynamic_array_sort()
+{
+    printf("=== 测试 sort / sort_stable / bsearch ===\n");
+
+    enum { N = 20000 };
+    int *vals = malloc(N * sizeof(int));
+    DynamicArray *arr = array_create(0);
+    unsigned seed = 12345;
+    for (int i = 0; i < N; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        vals[i] = (int)(seed >> 16) % 1000;
+        array_push_back(arr, &vals[i]);
+    }
+
+    // 内省排序：随机、已排序、逆序、全相等
+    assert(array_sort(arr, compare_int) && is_sorted_int(arr));
+    assert(array_sort(arr, compare_int) && is_sorted_int(arr));
+    array_reverse(arr);
+    assert(array_sort(arr, compare_int) && is_sorted_int(arr));
+    int same = 7;
+    DynamicArray *flat = array_create(0);
+    for (int i = 0; i < 1000; i++)
+        array_push_back(flat, &same);
+    assert(array_sort(flat, compare_int));
+    array_destroy(&flat);
+    assert(!array_sort(NULL, compare_int) && !array_sort(arr, NULL));
+
+    // 二分查找
+    int key = 500;
+    size_t lb = array_lower_bound(arr, &key, compare_int);
+    assert(lb == arr->size || *(int *)arr->data[lb] >= key);
+    assert(lb == 0 || *(int *)arr->data[lb - 1] < key);
+    size_t pos = array_bsearch(arr, &key, compare_int);
+    assert(pos == ARRAY_NPOS || pos == lb);
+    int missing = 5000;
+    assert(array_bsearch(arr, &missing, compare_int) == ARRAY_NPOS);
+    assert(array_lower_bound(arr, &missing, compare_int) == arr->size);
+    for (int i = 0; i < N; i += 97)
+    {
+        size_t at = array_bsearch(arr, &vals[i], compare_int);
+        assert(at != ARRAY_NPOS && *(int *)arr->data[at] == vals[i]);
+        assert(at == 0 || *(int *)arr->data[at - 1] < vals[i]);
+    }
+
+    // 稳定排序：键只有 10 种，相等键保持原来的先后顺序（用元素地址判断）
+    int (*pairs)[2] = malloc(N * sizeof(*pairs));
+    for (size_t threads = 1; threads <= 4; threads += 3)
+    {
+        array_clear(arr);
+        for (int i = 0; i < N; i++)
+        {
+            pairs[i][0] = vals[i] % 10;
+            pairs[i][1] = i;
+            array_push_back(arr, pairs[i]);
+        }
+        if (threads == 1)
+            assert(array_sort_stable(arr, compare_pair_key));
+        else
+            assert(array_sort_parallel(arr, compare_pair_key, threads));
+        for (size_t i = 1; i < arr->size; i++)
+        {
+            const int *p = arr->data[i - 1], *q = arr->data[i];
+            assert(p[0] < q[0] || (p[0] == q[0] && p[1] < q[1]));
+        }
+    }
+
+    // 元素数不是线程数的整数倍，段数为奇数
+    array_clear(arr);
+    for (int i = 0; i < N; i++)
+        array_push_back(arr, &vals[i]);
+    assert(array_sort_parallel(arr, compare_int, 3) && is_sorted_int(arr));
+    assert(array_size(arr) == N);
+
+    free(pairs);
+    free(vals);
+    array_destroy(&arr);
+    printf("✅ 排序与二分查找测试通过\n\n");
+}
+
+static void double_int(void *data, void *ctx)
+{
+    (void)ctx;
+    *(int *)data *= 2;
+}
+
+static void *square_int(const void *data, void *ctx)
+{
+    (void)ctx;
+    // values reach about 2 * N after double_int, so the square needs 64 bits
+    long long *out = malloc(sizeof(long long));
+    *out = (long long)*(const int *)data * *(const int *)data;
+    return out;
+}
+
+static void sum_int(void *acc, const void *data, void *ctx)
+{
+    (void)ctx;
+    *(long long *)acc += *(const int *)data;
+}
+
+static void sum_combine(void *acc, const void *other, void *ctx)
+{
+    (void)ctx;
+    *(long long *)acc += *(const long long *)other;
+}
+
+// joining contiguous index ranges is associative but not commutative: checks combine order
+typedef struct
+{
+    int first, last;
+    bool empty, ordered;
+} Span;
+
+static void span_add(void *acc, const void *data, void *ctx)
+{
+    Span *sp = acc;
+    int i = (int)((const int *)data - (const int *)ctx); // ctx is the base of vals
+    if (sp->empty)
+        sp->first = i;
+    else if (i != sp->last + 1)
+        sp->ordered = false;
+    sp->last = i;
+    sp->empty = false;
+}
+
+static void span_join(void *acc, const void *other, void *ctx)
+{
+    (void)ctx;
+    Span *sp = acc;
+    const Span *o = other;
+    if (o->empty)
+        return;
+    if (sp->empty)
+    {
+        *sp = *o;
+        return;
+    }
+    sp->ordered = sp->ordered && o->ordered && o->first == sp->last + 1;
+    sp->last = o->last;
+}
+
+static bool is_multiple(const void *data, void *ctx)
+{
+    return *(const int *)data % *(int *)ctx == 0;
+}
+
+static void half_to_double(const void *elem, void *out, void *ctx)
+{
+    (void)ctx;
+    *(double *)out = *(const int *)elem / 2.0;
+}
+
+void test_dynamic_array_parallel()
+{
+    printf("=== 测试并行 for_each / map / reduce / filter ===\n");
+
+    enum { N = 50000 };
+    ThreadPool *pools[2] = {NULL, thread_pool_create(4)};
+    assert(pools[1] != NULL);
+
+    for (int p = 0; p < 2; p++)
+    {
+        ThreadPool *pool = pools[p];
+        int *vals = malloc(N * sizeof(int));
+        DynamicArray *arr = array_create(0);
+        for (int i = 0; i < N; i++)
+        {
+            vals[i] = i;
+            array_push_back(arr, &vals[i]);
+        }
+
+        array_parallel_for_each(pool, arr, double_int, NULL);
+        for (int i = 0; i < N; i++)
+            assert(vals[i] == 2 * i);
+
+        DynamicArray *squares = array_parallel_map(pool, arr, square_int, NULL);
+        assert(array_size(squares) == N);
+        for (int i = 0; i < N; i += 101)
+            assert(*(long long *)array_get_at(squares, i) == 4LL * i * i);
+        for (size_t i = 0; i < array_size(squares); i++)
+            free(squares->data[i]);
+        array_destroy(&squares);
+
+        long long sum = 0;
+        assert(array_parallel_reduce(pool, arr, &sum, sizeof(sum), sum_int, sum_combine, NULL));
+        assert(sum == (long long)N * (N - 1));
+
+        // 部分结果按块顺序合并：[0, N) 的下标区间依次拼接
+        Span span = {0, 0, true, true};
+        assert(array_parallel_reduce(pool, arr, &span, sizeof(span), span_add, span_join, vals));
+        assert(span.ordered && span.first == 0 && span.last == N - 1);
+
+        int k = 3;
+        DynamicArray *multiples = array_parallel_filter(pool, arr, is_multiple, &k);
+        assert(array_size(multiples) == (N + 2) / 3);
+        for (size_t i = 0; i < array_size(multiples); i++)
+            assert(array_get_at(multiples, i) == &vals[3 * i]);
+        array_destroy(&multiples);
+
+        // 空数组
+        DynamicArray *empty = array_create(0);
+        long long zero = 0;
+        assert(array_parallel_reduce(pool, empty, &zero, sizeof(zero), sum_int, sum_combine, NULL) && zero == 0);
+        DynamicArray *none = array_parallel_filter(pool, empty, is_multiple, &k);
+        assert(none && array_is_empty(none));
+        array_destroy(&none);
+        array_destroy(&empty);
+
+        // ValueArray
+        ValueArray *va = IntArray_create(0);
+        for (int i = 0; i < N; i++)
+            IntArray_push(va, i);
+        varray_parallel_for_each(pool, va, double_int, NULL);
+        assert(IntArray_get(va, N - 1) == 2 * (N - 1));
+        ValueArray *halves = varray_parallel_map(pool, va, sizeof(double), half_to_double, NULL);
+        assert(halves->size == N && ((double *)halves->data)[7] == 7.0);
+        varray_destroy(&halves);
+        sum = 0;
+        assert(varray_parallel_reduce(pool, va, &sum, sizeof(sum), sum_int, sum_combine, NULL));
+        assert(sum == (long long)N * (N - 1));
+        k = 4;
+        ValueArray *fours = varray_parallel_filter(pool, va, is_multiple, &k);
+        assert(fours->size == N / 2);
+        for (size_t i = 0; i < fours->size; i++)
+            assert(IntArray_get(fours, i) == 4 * (int)i);
+        varray_destroy(&fours);
+        varray_destroy(&va);
+
+        array_destroy(&arr);
+        free(vals);
+    }
+
+    thread_pool_destroy(&pools[1]);
+    printf("✅ 并行操作测试通过\n\n");
+}
+
+void test_value_array_push_pop()
+{
+    printf("=== 测试 ValueArray push_back / pop_back / get / set ===\n");
+
+    ValueArray *arr = varray_create(sizeof(int), 0);
+    assert(arr != NULL && arr->capacity == 2 && arr->elem_size == sizeof(int));
+    assert(varray_create(0, 4) == NULL);
+
+    for (int i = 0; i < 5; i++)
+    {
+        int v = i * 10;
+        assert(varray_push_back(arr, &v));
+        assert(varray_size(arr) == (size_t)i + 1);
+    }
+    assert(arr->capacity == 8);
+    // the elements live inside the array, contiguously
+    assert((int *)varray_get_at(arr, 1) == (int *)arr->data + 1);
+    assert(*(int *)varray_get_at(arr, 4) == 40);
+    assert(varray_get_at(arr, 5) == NULL);
+
+    int x = 1234;
+    assert(varray_set_at(arr, 2, &x));
+    x = 0; // set copied the value
+    assert(*(int *)varray_get_at(arr, 2) == 1234);
+    assert(!varray_set_at(arr, 5, &x));
+
+    int out;
+    for (int i = 4; i >= 1; i--)
+    {
+        assert(varray_pop_back(arr, &out));
+        assert(out == (i == 2 ? 1234 : i * 10));
+    }
+    assert(arr->capacity == 4); // shrinks like DynamicArray once size < capacity / 4
+    assert(varray_pop_back(arr, NULL));
+    assert(!varray_pop_back(arr, &out));
+
+    varray_destroy(&arr);
+    assert(arr == NULL);
+    printf("✅ ValueArray push_back / pop_back 测试通过\n\n");
+}
+
+void test_value_array_insert_remove()
+{
+    printf("=== 测试 ValueArray insert_at / remove_at / find ===\n");
+
+    ValueArray *arr = varray_create(sizeof(Record), 2);
+    for (int i = 0; i < 3; i++)
+        assert(varray_insert_at(arr, (size_t)i, &(Record){i, i * 0.5}));
+    assert(varray_insert_at(arr, 0, &(Record){30, 1.5}));  // [30, 0, 1, 2]
+    assert(varray_insert_at(arr, 2, &(Record){40, 2.5}));  // [30, 0, 40, 1, 2]
+    assert(!varray_insert_at(arr, 9, &(Record){0, 0}));
+    assert(varray_size(arr) == 5);
+
+    int expect[] = {30, 0, 40, 1, 2};
+    for (size_t i = 0; i < 5; i++)
+        assert(((Record *)varray_get_at(arr, i))->id == expect[i]);
+
+    Record r;
+    assert(varray_remove_at(arr, 2, &r) && r.id == 40 && r.score == 2.5);
+    assert(varray_remove_at(arr, 0, NULL));
+    assert(!varray_remove_at(arr, 3, NULL));
+    assert(varray_size(arr) == 3 && ((Record *)varray_get_at(arr, 0))->id == 0);
+
+    // compare callbacks receive element addresses, so compare_int works on the leading int
+    assert(varray_find(arr, &(int){2}, compare_int) == 2);
+    assert(varray_find(arr, &(int){99}, compare_int) == VARRAY_NPOS);
+    assert(varray_contains(arr, &(int){1}, compare_int));
+
+    varray_reverse(arr);
+    assert(((Record *)varray_get_at(arr, 0))->id == 2 && ((Record *)varray_get_at(arr, 2))->id == 0);
+
+    ValueArray *copy = varray_clone(arr);
+    assert(copy->size == 3 && copy->data != arr->data);
+    assert(memcmp(copy->data, arr->data, 3 * sizeof(Record)) == 0);
+
+    varray_clear(arr);
+    assert(varray_is_empty(arr));
+
+    varray_destroy(&arr);
+    varray_destroy(&copy);
+    printf("✅ ValueArray insert_at / remove_at 测试通过\n\n");
+}
+
+void test_value_array_typed()
+{
+    printf("=== 测试 ARRAY_DEFINE ===\n");
+
+    ValueArray *a = IntArray_create(0);
+    for (int i = 0; i < 100000; i++)
+        assert(IntArray_push(a, i));
+    assert(a->size == 100000);
+
+    long long sum = 0;
+    int *p = IntArray_data(a);
+    for (size_t i = 0; i < a->size; i++)
+        sum += p[i];
+    assert(sum == 100000LL * 99999 / 2);
+
+    IntArray_set(a, 7, -7);
+    assert(IntArray_get(a, 7) == -7 && *(int *)varray_get_at(a, 7) == -7);
+    int last;
+    assert(IntArray_pop(a, &last) && last == 99999);
+    varray_destroy(&a);
+
+    ValueArray *recs = RecordArray_create(4);
+    assert(recs->elem_size == sizeof(Record));
+    RecordArray_push(recs, (Record){1, 0.25});
+    RecordArray_push(recs, (Record){2, 0.75});
+    assert(RecordArray_get(recs, 1).score == 0.75);
+    varray_destroy(&recs);
+    printf("✅ ARRAY_DEFINE 测试通过\n\n");
+}
+
 int main()
 {
     test_array_clone();
+    test_dynamic_array_capacity_control();
+    test_dynamic_array_bulk();
+    test_dynamic_array_sort();
+    test_dynamic_array_parallel();
+    test_value_array_push_pop();
+    test_value_array_insert_remove();
+    test_value_array_typed();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,368 @@
+/*
+Implement of value-storing dynamic array.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "value_array.h"
+
+static inline char *elem_at(const ValueArray *array, size_t index)
+{
+    return (char *)array->data + index * array->elem_size;
+}
+
+// init and destroy
+ValueArray *varray_create(size_t elem_size, size_t initial_capacity)
+{
+    if (elem_size == 0)
+    {
+        fprintf(stderr, "Element size must be positive\n");
+        return NULL;
+    }
+    if (initial_capacity == 0)
+    {
+        // use 2 as default capacity
+        initial_capacity = 2;
+    }
+    if (initial_capacity > SIZE_MAX / elem_size)
+    {
+        fprintf(stderr, "Exceeded maximum array capacity\n");
+        return NULL;
+    }
+
+    ValueArray *new_array = malloc(sizeof(ValueArray));
+    if (new_array == NULL)
+    {
+        fprintf(stderr, "Failed to allocate memory for ValueArray\n");
+        return NULL;
+    }
+
+    new_array->data = malloc(initial_capacity * elem_size);
+    if (new_array->data == NULL)
+    {
+        fprintf(stderr, "Failed to allocate memory for data\n");
+        free(new_array);
+        return NULL;
+    }
+    new_array->elem_size = elem_size;
+    new_array->capacity = initial_capacity;
+    new_array->size = 0;
+
+    return new_array;
+}
+
+void varray_destroy(ValueArray **array)
+{
+    if (!array || !*array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return;
+    }
+
+    free((*array)->data);
+    free(*array);
+    *array = NULL;
+}
+
+size_t varray_size(const ValueArray *array)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return -1;
+    }
+
+    return array->size;
+}
+
+size_t varray_capacity(const ValueArray *array)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return -1;
+    }
+
+    return array->capacity;
+}
+
+bool varray_is_empty(const ValueArray *array)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+
+    return array->size == 0;
+}
+
+// resize
+static bool resize_to(ValueArray *array, size_t new_capacity)
+{
+    void *new_data = realloc(array->data, new_capacity * array->elem_size);
+    if (!new_data)
+        return false;
+    array->data = new_data;
+    array->capacity = new_capacity;
+    return true;
+}
+
+bool varray_grow(ValueArray *array)
+{
+    if (array->capacity > SIZE_MAX / 2 / array->elem_size)
+    {
+        fprintf(stderr, "Exceeded maximum array capacity\n");
+        return false;
+    }
+    if (!resize_to(array, array->capacity * 2))
+    {
+        fprintf(stderr, "Failed to reallocate memory for data\n");
+        return false;
+    }
+    return true;
+}
+
+static void shrink_if_sparse(ValueArray *array)
+{
+    if (array->size < array->capacity / 4 && array->capacity > 1)
+    {
+        if (!resize_to(array, array->capacity / 2))
+            fprintf(stderr, "Shrink failed: memory reallocation failed\n");
+    }
+}
+
+// insert, delete
+bool varray_push_back(ValueArray *array, const void *elem)
+{
+    if (!array || !elem)
+    {
+        fprintf(stderr, "Array or element doesn't exist\n");
+        return false;
+    }
+
+    if (array->size == array->capacity && !varray_grow(array))
+        return false;
+
+    memcpy(elem_at(array, array->size), elem, array->elem_size);
+    array->size++;
+
+    return true;
+}
+
+bool varray_pop_back(ValueArray *array, void *out)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+    if (array->size == 0)
+    {
+        fprintf(stderr, "Array is empty\n");
+        return false;
+    }
+
+    array->size--;
+    if (out)
+        memcpy(out, elem_at(array, array->size), array->elem_size);
+
+    shrink_if_sparse(array);
+    return true;
+}
+
+bool varray_insert_at(ValueArray *array, size_t index, const void *elem)
+{
+    if (!array || !elem)
+    {
+        fprintf(stderr, "Array or element doesn't exist\n");
+        return false;
+    }
+    if (index > array->size)
+    {
+        fprintf(stderr, "Index %zu out of bounds [0, %zu]\n", index, array->size);
+        return false;
+    }
+
+    if (array->size == array->capacity && !varray_grow(array))
+        return false;
+
+    if (index < array->size)
+    {
+        memmove(elem_at(array, index + 1), elem_at(array, index),
+                (array->size - index) * array->elem_size);
+    }
+    memcpy(elem_at(array, index), elem, array->elem_size);
+    array->size++;
+
+    return true;
+}
+
+bool varray_remove_at(ValueArray *array, size_t index, void *out)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return false;
+    }
+    if (index >= array->size)
+    {
+        fprintf(stderr, "Index %zu out of bounds [0, %zu)\n", index, array->size);
+        return false;
+    }
+
+    if (out)
+        memcpy(out, elem_at(array, index), array->elem_size);
+    memmove(elem_at(array, index), elem_at(array, index + 1),
+            (array->size - index - 1) * array->elem_size);
+    array->size--;
+
+    shrink_if_sparse(array);
+    return true;
+}
+
+// get and set
+void *varray_get_at(const ValueArray *array, size_t index)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return NULL;
+    }
+    if (index >= array->size)
+    {
+        fprintf(stderr, "Index %zu out of bounds [0, %zu)\n", index, array->size);
+        return NULL;
+    }
+
+    return elem_at(array, index);
+}
+
+bool varray_set_at(ValueArray *array, size_t index, const void *elem)
+{
+    if (!array || !elem)
+    {
+        fprintf(stderr, "Array or element doesn't exist\n");
+        return false;
+    }
+    if (index >= array->size)
+    {
+        fprintf(stderr, "Index %zu out of bounds [0, %zu)\n", index, array->size);
+        return false;
+    }
+    memcpy(elem_at(array, index), elem, array->elem_size);
+    return true;
+}
+
+// find
+size_t varray_find(const ValueArray *array, const void *elem,
+                   int (*compare)(const void *a, const void *b))
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array doesn't exist\n");
+        return VARRAY_NPOS;
+    }
+    if (!compare)
+    {
+        fprintf(stderr, "No compare function\n");
+        return VARRAY_NPOS;
+    }
+
+    // elements are contiguous: a sequential scan with no pointer chasing
+    const char *p = array->data;
+    for (size_t i = 0; i < array->size; i++, p += array->elem_size)
+    {
+        if (compare(p, elem) == 0)
+            return i;
+    }
+
+    return VARRAY_NPOS;
+}
+
+bool varray_contains(const ValueArray *array, const void *elem,
+                     int (*compare)(const void *a, const void *b))
+{
+    return varray_find(array, elem, compare) != VARRAY_NPOS;
+}
+
+// operate
+void varray_clear(ValueArray *array)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array is NULL\n");
+        return;
+    }
+
+    array->size = 0;
+}
+
+void varray_reverse(ValueArray *array)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array is NULL\n");
+        return;
+    }
+    if (array->size < 2)
+        return;
+
+    for (size_t i = 0, j = array->size - 1; i < j; i++, j--)
+    {
+        unsigned char *a = (unsigned char *)elem_at(array, i);
+        unsigned char *b = (unsigned char *)elem_at(array, j);
+        for (size_t k = 0; k < array->elem_size; k++)
+        {
+            unsigned char tmp = a[k];
+            a[k] = b[k];
+            b[k] = tmp;
+        }
+    }
+}
+
+ValueArray *varray_clone(const ValueArray *array)
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array is NULL\n");
+        return NULL;
+    }
+
+    ValueArray *new_array = varray_create(array->elem_size, array->capacity);
+    if (!new_array)
+        return NULL;
+    memcpy(new_array->data, array->data, array->size * array->elem_size);
+    new_array->size = array->size;
+
+    return new_array;
+}
+
+// print func
+void varray_print(const ValueArray *array, void (*print_func)(const void *data))
+{
+    if (!array)
+    {
+        fprintf(stderr, "Array is NULL\n");
+        return;
+    }
+
+    if (!print_func)
+    {
+        fprintf(stderr, "print_func is NULL\n");
+        return;
+    }
+
+    printf("[");
+    for (size_t i = 0; i < array->size; i++)
+    {
+        print_func(elem_at(array, i));
+        if (i < array->size - 1)
+            printf(", ");
+    }
+    printf("]\n");
+}
@@ -0,0 +1,200 @@
+#ifndef VALUE_ARRAY_H
+#define VALUE_ARRAY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * 按值存储的动态数组
+ *
+ * DynamicArray 存的是 void*：一百万个 int 要一百万次 malloc（如 clone_int），
+ * 查找和打印时每个元素还要多跳一次指针。ValueArray 把元素本身连续存放：
+ * - 创建时给定元素大小 elem_size，data 是 capacity * elem_size 字节的一整块内存
+ * - push/insert/set 拷贝元素的内容，get 返回指向数组内部元素的指针
+ * - 扩容、缩容、越界检查和出错信息与 dynamic_array.h 相同
+ * - 比较/打印回调收到的是元素的地址，common.h 里的 compare_int / print_int 等可以直接用
+ *
+ * 需要编译期类型时用 ARRAY_DEFINE(name, T) 生成类型化的内联访问函数（见文件末尾）。
+ */
+
+/* 按值存储的动态数组结构体 */
+typedef struct ValueArray {
+    void* data;          // capacity * elem_size 字节，元素连续存放
+    size_t elem_size;    // 每个元素的字节数
+    size_t size;         // 当前元素数量
+    size_t capacity;     // 当前容量（元素个数）
+} ValueArray;
+
+/* varray_find 找不到时的返回值 */
+#define VARRAY_NPOS ((size_t)-1)
+
+/*
+ * ========================================
+ * 创建和销毁
+ * ========================================
+ */
+
+/**
+ * 创建按值存储的动态数组
+ * @param elem_size 每个元素的字节数，不能为 0
+ * @param initial_capacity 初始容量，0表示使用默认值
+ * @return 新创建的数组指针，失败返回NULL
+ */
+ValueArray* varray_create(size_t elem_size, size_t initial_capacity);
+
+/**
+ * 销毁数组
+ * @param array 要销毁的数组指针的地址，销毁后置为 NULL
+ */
+void varray_destroy(ValueArray** array);
+
+/*
+ * ========================================
+ * 基本信息查询
+ * ========================================
+ */
+
+size_t varray_size(const ValueArray* array);
+size_t varray_capacity(const ValueArray* array);
+bool varray_is_empty(const ValueArray* array);
+
+/*
+ * ========================================
+ * 访问操作
+ * ========================================
+ */
+
+/**
+ * 通过索引访问元素
+ * @return 指向数组内第 index 个元素的指针（下一次插入/删除前有效），越界返回NULL
+ */
+void* varray_get_at(const ValueArray* array, size_t index);
+
+/**
+ * 把 elem 指向的 elem_size 字节拷贝到第 index 个元素
+ * @return 成功返回true，越界返回false
+ */
+bool varray_set_at(ValueArray* array, size_t index, const void* elem);
+
+/*
+ * ========================================
+ * 插入和删除
+ * ========================================
+ */
+
+/**
+ * 在尾部追加 elem 的拷贝；满时容量翻倍
+ * 平均时间复杂度：O(1)
+ */
+bool varray_push_back(ValueArray* array, const void* elem);
+
+/**
+ * 移除尾部元素，out 非 NULL 时把它拷贝到 out
+ * @return 成功返回true，空数组返回false
+ * 元素数少于容量的 1/4 时容量减半
+ */
+bool varray_pop_back(ValueArray* array, void* out);
+
+/**
+ * 在 index 处插入 elem 的拷贝，index 可以等于 size（追加）
+ * 时间复杂度：O(n)
+ */
+bool varray_insert_at(ValueArray* array, size_t index, const void* elem);
+
+/**
+ * 移除第 index 个元素，out 非 NULL 时把它拷贝到 out
+ * 时间复杂度：O(n)；缩容规则同 varray_pop_back
+ */
+bool varray_remove_at(ValueArray* array, size_t index, void* out);
+
+/**
+ * 容量翻倍一次，供 ARRAY_DEFINE 生成的内联 push 在满时调用
+ */
+bool varray_grow(ValueArray* array);
+
+/*
+ * ========================================
+ * 查找和数组操作
+ * ========================================
+ */
+
+/**
+ * 线性查找第一个与 elem 相等的元素
+ * @param compare 收到两个元素的地址，相等时返回0
+ * @return 找到返回索引，未找到返回 VARRAY_NPOS
+ */
+size_t varray_find(const ValueArray* array, const void* elem,
+                   int (*compare)(const void* a, const void* b));
+
+bool varray_contains(const ValueArray* array, const void* elem,
+                     int (*compare)(const void* a, const void* b));
+
+/**
+ * 清空数组（保持容量不变）
+ */
+void varray_clear(ValueArray* array);
+
+/**
+ * 反转元素顺序
+ */
+void varray_reverse(ValueArray* array);
+
+/**
+ * 复制数组：一次 memcpy，元素本身就是值，没有深浅拷贝之分
+ */
+ValueArray* varray_clone(const ValueArray* array);
+
+/**
+ * 打印数组内容，print_func 收到每个元素的地址
+ */
+void varray_print(const ValueArray* array, void (*print_func)(const void* data));
+
+/*
+ * ========================================
+ * 编译期类型化访问
+ * ========================================
+ *
+ *   ARRAY_DEFINE(IntArray, int)
+ *   ValueArray *a = IntArray_create(0);
+ *   IntArray_push(a, 42);
+ *   int x = IntArray_get(a, 0);
+ *   int *p = IntArray_data(a);        // 连续的 int[size]，可直接交给 qsort、SIMD 循环等
+ *
+ * 生成 name_create / name_data / name_get / name_set / name_push / name_pop，
+ * 都是 static inline，元素按 T 直接读写，不经 memcpy 和函数指针。
+ * name_get / name_set 不做越界检查（与 name_data 的下标访问一致），
+ * 需要检查时用 varray_get_at / varray_set_at。
+ */
+#define ARRAY_DEFINE(name, T)                                                  \
+    static inline ValueArray *name##_create(size_t initial_capacity)           \
+    {                                                                          \
+        return varray_create(sizeof(T), initial_capacity);                     \
+    }                                                                          \
+    static inline T *name##_data(const ValueArray *a)                          \
+    {                                                                          \
+        return (T *)a->data;                                                   \
+    }                                                                          \
+    static inline T name##_get(const ValueArray *a, size_t i)                  \
+    {                                                                          \
+        return ((const T *)a->data)[i];                                        \
+    }                                                                          \
+    static inline void name##_set(ValueArray *a, size_t i, T v)                \
+    {                                                                          \
+        ((T *)a->data)[i] = v;                                                 \
+    }                                                                          \
+    static inline bool name##_push(ValueArray *a, T v)                         \
+    {                                                                          \
+        if (a->size == a->capacity && !varray_grow(a))                         \
+            return false;                                                      \
+        ((T *)a->data)[a->size++] = v;                                         \
+        return true;                                                           \
+    }                                                                          \
+    static inline bool name##_pop(ValueArray *a, T *out)                       \
+    {                                                                          \
+        return varray_pop_back(a, out);                                        \
+    }
+
+#endif /* VALUE_ARRAY_H */
@@ -0,0 +1,1088 @@
+/**
+ * bench_hashtable.c - Benchmark suite for the hashtable backends
+ *
+ * 对每个后端 × 键类型 × 键分布 × 规模，测量 insert/search/update/delete：
+ *   - ns/op（整段循环的墙钟时间 / 操作数）
+ *   - p50/p99 单次操作延迟（抽样计时）
+ *   - maxwin：连续 256 次操作耗时的最大值（us），反映扩容造成的停顿
+ *   - allocs/op（通过链接期 --wrap 统计 malloc/calloc/realloc 次数）
+ *   - 峰值 RSS（每个配置在独立子进程中运行，互不污染）
+ *
+ * insert 和 delete 各触达每个键一次；search/update 的键按所选分布抽取
+ * （uniform 或 Zipfian），search 中约 10% 为未命中查询。
+ * sbatch 用与 search 相同的键流，每 256 个键调用一次 hashtable_search_batch。
+ * --hash 选择 HashKeyOps.hash（默认 fnv1a），*-seeded 改用 hash_seeded + 每张表的随机种子；
+ * --hash-speed 只测各哈希函数按键长的吞吐。
+ * --typed 对比 HASHTABLE_DEFINE 生成的 int -> struct 表与通用的 hashtable_oa_create（线性探测）。
+ * --snapshot 对比逐个插入重建字符串键表与 hashtable_open_mmap 打开快照的耗时，以及两者的查找速度。
+ * --build 对比逐个 hashtable_insert 与 hashtable_build（一次预留容量）装入 n 个 int 键的耗时和扩容次数。
+ * --keys collide 生成针对无种子 FNV-1a 构造的冲突键（所有键的低 32 位哈希相同），
+ * 对比 --hash fnv1a 与 --hash fnv1a-seeded / fast-seeded 可以看到种子的作用；
+ * 无种子时每次操作是 O(n)，未指定 --max-size 时规模上限默认为 1e3。
+ *
+ * 用法: ./bench_hashtable [--backend NAME|chaining|oa|all] [--keys int|string|collide|all]
+ *                         [--dist uniform|zipf|all] [--min-size N] [--max-size N]
+ *                         [--zipf-theta T] [--hash NAME] [--hash-speed] [--typed] [--snapshot] [--build]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "hashtable.h"
+#include "hashtable_chaining.h"
+#include "hashtable_oa.h"
+#include "hashtable_flat.h"
+#include "hashtable_swiss.h"
+#include "hashtable_typed.h"
+#include "hashtable_snapshot.h"
+#include "hash.h"
+#include "../common/common.h"
+
+/* ========== allocation counting (linked with -Wl,--wrap=...) ========== */
+
+static size_t g_alloc_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    g_alloc_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    g_alloc_count++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    g_alloc_count++;
+    return __real_realloc(ptr, size);
+}
+
+/* ========== backends ========== */
+
+static size_t bench_hash2(const void *key, size_t keysz)
+{
+    // djb2 over raw bytes, independent of h1 (FNV-1a) for double hashing
+    const unsigned char *bytes = (const unsigned char *)key;
+    size_t hash = 5381;
+    for (size_t i = 0; i < keysz; i++)
+        hash = ((hash << 5) + hash) + bytes[i];
+    return hash;
+}
+
+static HashTable *create_chaining(HashKeyOps kops)
+{
+    return hashtable_chaining_create(8, 0.75, kops);
+}
+
+static HashTable *create_chaining_incr(HashKeyOps kops)
+{
+    return hashtable_chaining_create_ex(8, 0.75, kops, RESIZE_INCREMENTAL);
+}
+
+static HashTable *create_flat(HashKeyOps kops)
+{
+    return hashtable_flat_create(8, 0.75, kops);
+}
+
+static HashTable *create_swiss(HashKeyOps kops)
+{
+    return hashtable_swiss_create(16, 0.875, kops);
+}
+
+static HashTable *create_oa_linear(HashKeyOps kops)
+{
+    return hashtable_oa_create(8, 0.5, kops, PROBE_LINEAR, NULL);
+}
+
+static HashTable *create_oa_robinhood(HashKeyOps kops)
+{
+    // no tombstones and bounded probe variance allow a much higher load factor
+    return hashtable_oa_create(8, 0.9, kops, PROBE_ROBINHOOD, NULL);
+}
+
+static HashTable *create_oa_linear_incr(HashKeyOps kops)
+{
+    return hashtable_oa_create_ex(8, 0.5, kops, PROBE_LINEAR, NULL, RESIZE_INCREMENTAL);
+}
+
+static HashTable *create_oa_quadratic(HashKeyOps kops)
+{
+    return hashtable_oa_create(8, 0.5, kops, PROBE_QUADRATIC, NULL);
+}
+
+static HashTable *create_oa_doublehash(HashKeyOps kops)
+{
+    return hashtable_oa_create(8, 0.5, kops, PROBE_DOUBLEHASH, bench_hash2);
+}
+
+typedef struct
+{
+    const char *name;   /* 报表中显示的名字，也可直接用于 --backend */
+    const char *family; /* --backend chaining / oa 按族过滤 */
+    HashTable *(*create)(HashKeyOps kops);
+} Backend;
+
+static const Backend BACKENDS[] = {
+    {"chaining", "chaining", create_chaining},
+    {"chaining-incr", "chaining", create_chaining_incr},
+    {"flat", "chaining", create_flat},
+    {"oa-linear", "oa", create_oa_linear},
+    {"oa-linear-incr", "oa", create_oa_linear_incr},
+    {"oa-quadratic", "oa", create_oa_quadratic},
+    {"oa-doublehash", "oa", create_oa_doublehash},
+    {"oa-robinhood", "oa", create_oa_robinhood},
+    {"swiss", "oa", create_swiss},
+};
+#define NUM_BACKENDS (sizeof(BACKENDS) / sizeof(BACKENDS[0]))
+
+/* ========== workload ========== */
+
+typedef enum
+{
+    KEYS_INT = 0,
+    KEYS_STRING = 1,
+    KEYS_COLLIDE = 2 /* 只在 --keys collide 时运行，不包含在 all 中 */
+} KeyType;
+
+static const char *KEY_NAMES[] = {"int", "string", "collide"};
+
+typedef enum
+{
+    DIST_UNIFORM = 0,
+    DIST_ZIPF = 1
+} KeyDist;
+
+#define STR_KEY_LEN 16 /* "k:" + 13 digits + '\0' */
+#define MAX_LAT_SAMPLES 200000
+#define LAT_WINDOW 256 // ops per window for the worst-case pause column
+
+typedef struct
+{
+    KeyType type;
+    size_t n;
+    int *ints;     /* n distinct int keys */
+    char *strs;    /* n distinct string keys, stride bytes each */
+    size_t stride; /* STR_KEY_LEN, or longer for collision keys */
+} KeySet;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static inline uint64_t rng_next(void)
+{
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ull;
+}
+
+static inline double rng_unit(void)
+{
+    return (rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* ========== colliding keys for unseeded FNV-1a ========== */
+
+#define COLLIDE_BLOCK 5         // printable bytes appended per stage
+#define COLLIDE_CANDIDATES (1u << 18)
+
+static const char COLLIDE_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static void collide_block(uint32_t stage, uint32_t j, char out[COLLIDE_BLOCK])
+{
+    // 30 bits per candidate: collisions between identical blocks are rare and skipped
+    uint64_t z = ((uint64_t)stage << 32 | j) * 0x9E3779B97F4A7C15ull;
+    z ^= z >> 29;
+    for (int c = 0; c < COLLIDE_BLOCK; c++)
+        out[c] = COLLIDE_ALPHABET[(z >> (6 * c)) & 63];
+}
+
+/* FNV-1a 的低 32 位状态只依赖低 32 位，逐字节更新 */
+static uint32_t fnv_low32(uint32_t h, const char *p, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ (unsigned char)p[i]) * 16777619u;
+    return h;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Joux 多重碰撞：每一阶段从当前状态出发，生日搜索两个不同的块 A、B 使状态相同，
+ * k 个阶段的 A/B 任意组合得到 2^k 个低 32 位哈希全部相同的键（与表容量无关，掩码后落在同一个桶）
+ */
+static bool collide_keys(KeySet *ks, size_t n)
+{
+    size_t stages = 0;
+    while (((size_t)1 << stages) < n)
+        stages++;
+    ks->stride = stages * COLLIDE_BLOCK + 1;
+    ks->strs = malloc(n * ks->stride);
+    char (*pairs)[2][COLLIDE_BLOCK] = malloc((stages ? stages : 1) * sizeof *pairs);
+    uint64_t *cand = malloc(COLLIDE_CANDIDATES * sizeof(uint64_t));
+    if (!ks->strs || !pairs || !cand)
+    {
+        free(pairs);
+        free(cand);
+        return false;
+    }
+
+    uint32_t state = 2166136261u;
+    for (size_t st = 0; st < stages; st++)
+    {
+        bool found = false;
+        for (uint32_t salt = 0; !found; salt++)
+        {
+            uint32_t stage_id = (uint32_t)st | salt << 16;
+            for (uint32_t j = 0; j < COLLIDE_CANDIDATES; j++)
+            {
+                char blk[COLLIDE_BLOCK];
+                collide_block(stage_id, j, blk);
+                cand[j] = (uint64_t)fnv_low32(state, blk, COLLIDE_BLOCK) << 32 | j;
+            }
+            qsort(cand, COLLIDE_CANDIDATES, sizeof(uint64_t), cmp_u64);
+            for (uint32_t j = 1; j < COLLIDE_CANDIDATES && !found; j++)
+            {
+                if (cand[j] >> 32 != cand[j - 1] >> 32)
+                    continue;
+                collide_block(stage_id, (uint32_t)cand[j - 1], pairs[st][0]);
+                collide_block(stage_id, (uint32_t)cand[j], pairs[st][1]);
+                found = memcmp(pairs[st][0], pairs[st][1], COLLIDE_BLOCK) != 0;
+            }
+        }
+        state = fnv_low32(state, pairs[st][0], COLLIDE_BLOCK);
+    }
+    free(cand);
+
+    // key i picks block A or B at stage s by bit s of i
+    for (size_t i = 0; i < n; i++)
+    {
+        char *k = ks->strs + i * ks->stride;
+        for (size_t st = 0; st < stages; st++)
+            memcpy(k + st * COLLIDE_BLOCK, pairs[st][(i >> st) & 1], COLLIDE_BLOCK);
+        k[stages * COLLIDE_BLOCK] = '\0';
+    }
+    free(pairs);
+    return true;
+}
+
+static bool keyset_init(KeySet *ks, KeyType type, size_t n)
+{
+    ks->type = type;
+    ks->n = n;
+    ks->ints = NULL;
+    ks->strs = NULL;
+    ks->stride = STR_KEY_LEN;
+    if (type == KEYS_COLLIDE)
+        return collide_keys(ks, n);
+    if (type == KEYS_INT)
+    {
+        ks->ints = malloc(n * sizeof(int));
+        if (!ks->ints)
+            return false;
+        // odd multiplier is a bijection on uint32_t: distinct but scattered keys
+        for (size_t i = 0; i < n; i++)
+            ks->ints[i] = (int)(uint32_t)((uint32_t)i * 2654435761u);
+    }
+    else
+    {
+        ks->strs = malloc(n * STR_KEY_LEN);
+        if (!ks->strs)
+            return false;
+        for (size_t i = 0; i < n; i++)
+            snprintf(ks->strs + i * ks->stride, STR_KEY_LEN, "k:%013lu",
+                     (unsigned long)((uint32_t)i * 2654435761u));
+    }
+    return true;
+}
+
+static void keyset_free(KeySet *ks)
+{
+    free(ks->ints);
+    free(ks->strs);
+    ks->ints = NULL;
+    ks->strs = NULL;
+}
+
+static inline const void *keyset_key(const KeySet *ks, size_t i, size_t *keysz)
+{
+    if (ks->type == KEYS_INT)
+    {
+        *keysz = sizeof(int);
+        return &ks->ints[i];
+    }
+    const char *s = ks->strs + i * ks->stride;
+    *keysz = strlen(s) + 1;
+    return s;
+}
+
+/*
+ * Zipfian rank generator (Gray et al., "Quickly generating billion-record
+ * synthetic databases"), the same one YCSB uses. Rank 0 is the hottest key.
+ */
+typedef struct
+{
+    size_t n;
+    double theta, alpha, zetan, eta;
+} Zipf;
+
+static void zipf_init(Zipf *z, size_t n, double theta)
+{
+    double zeta2 = 1.0 + pow(0.5, theta);
+    double zetan = 0.0;
+    for (size_t i = 1; i <= n; i++)
+        zetan += 1.0 / pow((double)i, theta);
+    z->n = n;
+    z->theta = theta;
+    z->zetan = zetan;
+    z->alpha = 1.0 / (1.0 - theta);
+    z->eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+}
+
+static inline size_t zipf_next(const Zipf *z)
+{
+    double u = rng_unit();
+    double uz = u * z->zetan;
+    if (uz < 1.0)
+        return 0;
+    if (uz < 1.0 + pow(0.5, z->theta))
+        return 1;
+    size_t r = (size_t)(z->n * pow(z->eta * u - z->eta + 1.0, z->alpha));
+    return r < z->n ? r : z->n - 1;
+}
+
+/* key indices for search/update; indices >= n denote misses */
+static size_t *make_stream(size_t n, KeyDist dist, double theta, double miss_ratio)
+{
+    size_t *stream = malloc(n * sizeof(size_t));
+    if (!stream)
+        return NULL;
+    Zipf z = {0};
+    if (dist == DIST_ZIPF)
+        zipf_init(&z, n, theta);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (miss_ratio > 0 && rng_unit() < miss_ratio)
+            stream[i] = n + (rng_next() % n);
+        else
+            stream[i] = (dist == DIST_ZIPF) ? zipf_next(&z) : (size_t)(rng_next() % n);
+    }
+    return stream;
+}
+
+/* ========== measurement ========== */
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static size_t peak_rss_kb(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return (size_t)ru.ru_maxrss / 1024; /* bytes on macOS */
+#else
+    return (size_t)ru.ru_maxrss;        /* KiB on Linux */
+#endif
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+typedef enum
+{
+    OP_INSERT,
+    OP_SEARCH,
+    OP_SEARCH_BATCH,
+    OP_UPDATE,
+    OP_DELETE
+} OpKind;
+
+static const char *OP_NAMES[] = {"insert", "search", "sbatch", "update", "delete"};
+
+#define BATCH_CHUNK 256 // keys per hashtable_search_batch call
+
+typedef struct
+{
+    double ns_per_op;
+    uint32_t p50, p99;
+    uint64_t max_window; // slowest run of LAT_WINDOW consecutive ops (rehash pauses)
+    double allocs_per_op;
+    size_t failures;
+} PhaseResult;
+
+/* 取得第 idx 个键；idx >= n 时在 miss_int / miss_buf 中合成一个从未插入的键 */
+static inline const void *workload_key(const KeySet *ks, size_t idx, int *miss_int,
+                                       char *miss_buf, size_t *keysz)
+{
+    if (idx < ks->n)
+        return keyset_key(ks, idx, keysz);
+    if (ks->type == KEYS_INT)
+    {
+        *miss_int = ~(int)(uint32_t)((uint32_t)(idx - ks->n) * 2654435761u);
+        *keysz = sizeof(int);
+        return miss_int;
+    }
+    snprintf(miss_buf, STR_KEY_LEN, "m:%013lu", (unsigned long)(idx - ks->n));
+    *keysz = strlen(miss_buf) + 1;
+    return miss_buf;
+}
+
+/* 执行一次操作；返回是否成功（miss 查询返回 false） */
+static inline bool run_op(HashTable *ht, OpKind op, const KeySet *ks, size_t idx,
+                          char *miss_buf)
+{
+    size_t keysz;
+    int miss_int;
+    const void *key = workload_key(ks, idx, &miss_int, miss_buf, &keysz);
+
+    switch (op)
+    {
+    case OP_INSERT:
+        return hashtable_insert(ht, key, keysz, (void *)(uintptr_t)(idx + 1));
+    case OP_SEARCH:
+        return hashtable_search(ht, key, keysz) != NULL;
+    case OP_UPDATE:
+        return hashtable_update(ht, key, keysz, (void *)(uintptr_t)(idx + 2));
+    default:
+        return hashtable_delete(ht, key, keysz);
+    }
+}
+
+/* 以 BATCH_CHUNK 为一批调用 hashtable_search_batch；不统计单次延迟 */
+static PhaseResult run_batch_phase(HashTable *ht, const KeySet *ks, const size_t *stream)
+{
+    PhaseResult res = {0};
+    size_t n = ks->n;
+    const void *keys[BATCH_CHUNK];
+    size_t keyszs[BATCH_CHUNK];
+    void *out[BATCH_CHUNK];
+    int miss_ints[BATCH_CHUNK];
+    char miss_bufs[BATCH_CHUNK][STR_KEY_LEN];
+
+    size_t allocs_before = g_alloc_count;
+    uint64_t t0 = now_ns();
+    for (size_t base = 0; base < n; base += BATCH_CHUNK)
+    {
+        size_t m = n - base < BATCH_CHUNK ? n - base : BATCH_CHUNK;
+        for (size_t i = 0; i < m; i++)
+            keys[i] = workload_key(ks, stream[base + i], &miss_ints[i], miss_bufs[i], &keyszs[i]);
+        uint64_t s = now_ns();
+        hashtable_search_batch(ht, keys, keyszs, m, out);
+        uint64_t d = now_ns() - s;
+        if (d > res.max_window)
+            res.max_window = d;
+        for (size_t i = 0; i < m; i++)
+            if ((out[i] != NULL) != (stream[base + i] < n))
+                res.failures++;
+    }
+    uint64_t t1 = now_ns();
+    res.ns_per_op = (double)(t1 - t0) / n;
+    res.allocs_per_op = (double)(g_alloc_count - allocs_before) / n;
+    return res;
+}
+
+static PhaseResult run_phase(HashTable *ht, OpKind op, const KeySet *ks,
+                             const size_t *stream, uint32_t *lat)
+{
+    PhaseResult res = {0};
+    size_t n = ks->n;
+    size_t stride = n / MAX_LAT_SAMPLES + 1;
+    size_t nsamples = 0;
+    char miss_buf[STR_KEY_LEN];
+
+    size_t allocs_before = g_alloc_count;
+    uint64_t t0 = now_ns();
+    uint64_t window_start = t0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i % LAT_WINDOW == 0 && i)
+        {
+            uint64_t t = now_ns();
+            if (t - window_start > res.max_window)
+                res.max_window = t - window_start;
+            window_start = t;
+        }
+        size_t idx = stream ? stream[i] : i;
+        bool ok;
+        if (i % stride == 0)
+        {
+            uint64_t s = now_ns();
+            ok = run_op(ht, op, ks, idx, miss_buf);
+            uint64_t d = now_ns() - s;
+            lat[nsamples++] = d > UINT32_MAX ? UINT32_MAX : (uint32_t)d;
+        }
+        else
+        {
+            ok = run_op(ht, op, ks, idx, miss_buf);
+        }
+        // a failure is any result that disagrees with the workload (hit vs miss)
+        if (ok != (idx < n))
+            res.failures++;
+    }
+    uint64_t t1 = now_ns();
+    if (t1 - window_start > res.max_window)
+        res.max_window = t1 - window_start;
+    size_t allocs = g_alloc_count - allocs_before;
+
+    qsort(lat, nsamples, sizeof(uint32_t), cmp_u32);
+    res.ns_per_op = (double)(t1 - t0) / n;
+    res.p50 = lat[nsamples / 2];
+    res.p99 = lat[(nsamples * 99) / 100];
+    res.allocs_per_op = (double)allocs / n;
+    return res;
+}
+
+typedef struct
+{
+    const char *backend;
+    int keys;   /* -1 = all */
+    int dist;   /* -1 = all */
+    size_t min_size;
+    size_t max_size;
+    double zipf_theta;
+    const struct HashChoice *hash;
+} BenchConfig;
+
+typedef struct HashChoice
+{
+    const char *name;
+    hash_func_t fn;
+    hash_seeded_func_t seeded; /* 非 NULL 时放进 HashKeyOps.hash_seeded，每张表随机种子 */
+} HashChoice;
+
+static const HashChoice HASHES[] = {
+    {"fnv1a", hash_fnv1a, NULL},
+    {"fast", hash_fast, NULL},
+    {"fnv1a-seeded", hash_fnv1a, hash_fnv1a_seeded},
+    {"fast-seeded", hash_fast, hash_fast_seeded},
+};
+#define NUM_HASHES (sizeof(HASHES) / sizeof(HASHES[0]))
+
+/* 每个哈希函数在不同键长下的 ns/hash 与 GB/s */
+static void run_hash_speed(void)
+{
+    static const size_t lens[] = {4, 8, 16, 32, 64, 128, 256, 1024, 4096};
+    enum { BUF = 8192, BYTES_PER_RUN = 256 << 20 };
+    unsigned char *buf = malloc(BUF);
+    for (size_t i = 0; i < BUF; i++)
+        buf[i] = (unsigned char)rng_next();
+
+    printf("%-12s %8s %10s %8s\n", "hash", "keylen", "ns/hash", "GB/s");
+    for (size_t h = 0; h < NUM_HASHES; h++)
+    {
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+        {
+            size_t len = lens[l];
+            size_t iters = BYTES_PER_RUN / (len < 64 ? 64 : len);
+            size_t sink = 0;
+            uint64_t t0 = now_ns();
+            // vary the start offset so the key is not a loop invariant
+            if (HASHES[h].seeded)
+                for (size_t i = 0; i < iters; i++)
+                    sink += HASHES[h].seeded(buf + (i & 1023), len, 0x243F6A8885A308D3ull);
+            else
+                for (size_t i = 0; i < iters; i++)
+                    sink += HASHES[h].fn(buf + (i & 1023), len);
+            uint64_t t1 = now_ns();
+            double ns = (double)(t1 - t0) / iters;
+            printf("%-12s %8zu %10.2f %8.2f%s\n", HASHES[h].name, len, ns, len / ns,
+                   sink == 42 ? " " : "");
+        }
+    }
+    free(buf);
+}
+
+/* ========== typed vs generic ========== */
+
+typedef struct
+{
+    double x, y, z;
+    int id;
+} BenchPoint;
+
+HASHTABLE_DEFINE(BenchPointMap, int, BenchPoint, ht_typed_hash_int, HT_TYPED_EQ)
+
+#define TYPED_OPS 4
+static const char *TYPED_OP_NAMES[TYPED_OPS] = {"insert", "search", "update", "delete"};
+
+/* 通用表：值是指向 BenchPoint 的指针，点预先放在一个数组里（不把 malloc 算进去） */
+static void typed_run_generic(const int *keys, const size_t *stream, size_t n, BenchPoint *points,
+                              double ns[TYPED_OPS], size_t *sink)
+{
+    HashKeyOps kops = {.hash = hash_int32, .eq = compare_int};
+    HashTable *ht = hashtable_oa_create(8, 0.5, kops, PROBE_LINEAR, NULL);
+    uint64_t t0 = now_ns();
+    for (size_t i = 0; i < n; i++)
+        hashtable_insert(ht, &keys[i], sizeof(int), &points[i]);
+    uint64_t t1 = now_ns();
+    for (size_t i = 0; i < n; i++)
+    {
+        int miss = ~keys[stream[i] % n];
+        const int *k = stream[i] < n ? &keys[stream[i]] : &miss;
+        BenchPoint *p = hashtable_search(ht, k, sizeof(int));
+        *sink += p ? (size_t)p->id : 1;
+    }
+    uint64_t t2 = now_ns();
+    for (size_t i = 0; i < n; i++)
+        hashtable_update(ht, &keys[stream[i] % n], sizeof(int), &points[i]);
+    uint64_t t3 = now_ns();
+    for (size_t i = 0; i < n; i++)
+        hashtable_delete(ht, &keys[i], sizeof(int));
+    uint64_t t4 = now_ns();
+    hashtable_destroy(&ht);
+    ns[0] = (double)(t1 - t0) / n;
+    ns[1] = (double)(t2 - t1) / n;
+    ns[2] = (double)(t3 - t2) / n;
+    ns[3] = (double)(t4 - t3) / n;
+}
+
+static void typed_run_typed(const int *keys, const size_t *stream, size_t n, BenchPoint *points,
+                            double ns[TYPED_OPS], size_t *sink)
+{
+    BenchPointMap *m = BenchPointMap_create(8, 0.5);
+    uint64_t t0 = now_ns();
+    for (size_t i = 0; i < n; i++)
+        BenchPointMap_insert(m, keys[i], points[i]);
+    uint64_t t1 = now_ns();
+    for (size_t i = 0; i < n; i++)
+    {
+        int k = stream[i] < n ? keys[stream[i]] : ~keys[stream[i] % n];
+        BenchPoint *p = BenchPointMap_search(m, k);
+        *sink += p ? (size_t)p->id : 1;
+    }
+    uint64_t t2 = now_ns();
+    for (size_t i = 0; i < n; i++)
+        BenchPointMap_update(m, keys[stream[i] % n], points[i]);
+    uint64_t t3 = now_ns();
+    for (size_t i = 0; i < n; i++)
+        BenchPointMap_erase(m, keys[i]);
+    uint64_t t4 = now_ns();
+    BenchPointMap_destroy(&m);
+    ns[0] = (double)(t1 - t0) / n;
+    ns[1] = (double)(t2 - t1) / n;
+    ns[2] = (double)(t3 - t2) / n;
+    ns[3] = (double)(t4 - t3) / n;
+}
+
+/* int -> 32 字节结构体：HASHTABLE_DEFINE 生成的表与 hashtable_oa_create 的 ns/op 对比 */
+static void run_typed_compare(size_t min_size, size_t max_size)
+{
+    printf("%-8s %10s  %-6s %12s %12s %8s\n", "table", "n", "op", "generic(ns)", "typed(ns)",
+           "speedup");
+    for (size_t n = min_size; n <= max_size; n *= 10)
+    {
+        KeySet ks;
+        size_t *stream = make_stream(n, DIST_UNIFORM, 0.99, 0.1);
+        BenchPoint *points = malloc(n * sizeof(BenchPoint));
+        if (!keyset_init(&ks, KEYS_INT, n) || !stream || !points)
+        {
+            fprintf(stderr, "Failed to allocate workload (n=%zu)\n", n);
+            exit(1);
+        }
+        for (size_t i = 0; i < n; i++)
+            points[i] = (BenchPoint){(double)i, 0, 0, (int)i};
+
+        double generic[TYPED_OPS], typed[TYPED_OPS];
+        size_t sink = 0;
+        typed_run_generic(ks.ints, stream, n, points, generic, &sink);
+        typed_run_typed(ks.ints, stream, n, points, typed, &sink);
+        for (int op = 0; op < TYPED_OPS; op++)
+            printf("%-8s %10zu  %-6s %12.1f %12.1f %7.2fx%s\n", "int->pt", n, TYPED_OP_NAMES[op],
+                   generic[op], typed[op], generic[op] / typed[op], sink == 42 ? " " : "");
+        fflush(stdout);
+
+        free(points);
+        free(stream);
+        keyset_free(&ks);
+        if (n > SIZE_MAX / 10)
+            break;
+    }
+}
+
+/* ========== snapshot open vs rebuild ========== */
+
+static double snapshot_search_ns(HashTable *ht, const KeySet *ks, const size_t *stream, size_t n,
+                                 size_t *sink)
+{
+    uint64_t t0 = now_ns();
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t keysz;
+        const void *key = keyset_key(ks, stream[i] % n, &keysz);
+        *sink += (size_t)(uintptr_t)hashtable_search(ht, key, keysz);
+    }
+    return (double)(now_ns() - t0) / n;
+}
+
+/* 字符串键 -> 下标：重建（逐个插入 swiss 表）与保存/打开快照的耗时，以及各自的查找 ns/op */
+static void run_snapshot_compare(size_t min_size, size_t max_size)
+{
+    char path[64];
+    snprintf(path, sizeof path, "/tmp/bench_snapshot_%ld.bin", (long)getpid());
+    printf("%10s %12s %10s %10s %12s %12s %9s\n", "n", "rebuild(ms)", "save(ms)", "open(us)",
+           "search_mem", "search_mmap", "file_MB");
+    for (size_t n = min_size; n <= max_size; n *= 10)
+    {
+        KeySet ks;
+        size_t *stream = make_stream(n, DIST_UNIFORM, 0.99, 0.0);
+        if (!keyset_init(&ks, KEYS_STRING, n) || !stream)
+        {
+            fprintf(stderr, "Failed to allocate workload (n=%zu)\n", n);
+            exit(1);
+        }
+        HashKeyOps kops = {.hash = hash_fast, .eq = compare_string};
+        uint64_t t0 = now_ns();
+        HashTable *ht = hashtable_swiss_create(16, 0.875, kops);
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t keysz;
+            const void *key = keyset_key(&ks, i, &keysz);
+            hashtable_insert(ht, key, keysz, (void *)(uintptr_t)(i + 1));
+        }
+        uint64_t t1 = now_ns();
+        bool saved = hashtable_save(ht, path);
+        uint64_t t2 = now_ns();
+        HashTable *m = saved ? hashtable_open_mmap(path) : NULL;
+        uint64_t t3 = now_ns();
+        if (!m)
+        {
+            fprintf(stderr, "Snapshot failed (n=%zu)\n", n);
+            exit(1);
+        }
+
+        size_t sink = 0;
+        double mem_ns = snapshot_search_ns(ht, &ks, stream, n, &sink);
+        double map_ns = snapshot_search_ns(m, &ks, stream, n, &sink);
+        printf("%10zu %12.2f %10.2f %10.1f %12.1f %12.1f %9.1f%s\n", n, (t1 - t0) / 1e6,
+               (t2 - t1) / 1e6, (t3 - t2) / 1e3, mem_ns, map_ns,
+               hashtable_get_stats(m).bytes_used / (1024.0 * 1024.0), sink == 42 ? " " : "");
+        fflush(stdout);
+
+        hashtable_destroy(&m);
+        hashtable_destroy(&ht);
+        remove(path);
+        free(stream);
+        keyset_free(&ks);
+        if (n > SIZE_MAX / 10)
+            break;
+    }
+}
+
+/* ========== bulk build vs inserts ========== */
+
+static bool backend_selected(const Backend *be, const char *sel)
+{
+    return !sel || strcmp(sel, "all") == 0 || strcmp(sel, be->name) == 0 ||
+           strcmp(sel, be->family) == 0;
+}
+
+/* 每个后端：n 次 hashtable_insert 与一次 hashtable_build 的 ns/键和扩容次数 */
+static void run_build_compare(const char *backend, size_t min_size, size_t max_size)
+{
+    printf("%-14s %10s %12s %12s %8s %10s %10s\n", "backend", "n", "insert(ns)", "build(ns)",
+           "speedup", "resizes_i", "resizes_b");
+    for (size_t n = min_size; n <= max_size; n *= 10)
+    {
+        KeySet ks;
+        const void **keys = malloc(n * sizeof(void *));
+        size_t *keyszs = malloc(n * sizeof(size_t));
+        void **vals = malloc(n * sizeof(void *));
+        if (!keyset_init(&ks, KEYS_INT, n) || !keys || !keyszs || !vals)
+        {
+            fprintf(stderr, "Failed to allocate workload (n=%zu)\n", n);
+            exit(1);
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            keys[i] = keyset_key(&ks, i, &keyszs[i]);
+            vals[i] = (void *)(uintptr_t)(i + 1);
+        }
+
+        HashKeyOps kops = {.hash = hash_fast, .eq = compare_int};
+        for (size_t b = 0; b < NUM_BACKENDS; b++)
+        {
+            if (!backend_selected(&BACKENDS[b], backend))
+                continue;
+            HashTable *ht = BACKENDS[b].create(kops);
+            uint64_t t0 = now_ns();
+            for (size_t i = 0; i < n; i++)
+                hashtable_insert(ht, keys[i], keyszs[i], vals[i]);
+            uint64_t t1 = now_ns();
+            size_t resizes_insert = hashtable_get_stats(ht).resize_count;
+            hashtable_destroy(&ht);
+
+            ht = BACKENDS[b].create(kops);
+            uint64_t t2 = now_ns();
+            size_t built = hashtable_build(ht, keys, keyszs, vals, n);
+            uint64_t t3 = now_ns();
+            size_t resizes_build = hashtable_get_stats(ht).resize_count;
+            hashtable_destroy(&ht);
+
+            double ins = (double)(t1 - t0) / n, bld = (double)(t3 - t2) / n;
+            printf("%-14s %10zu %12.1f %12.1f %7.2fx %10zu %10zu%s\n", BACKENDS[b].name, n, ins,
+                   bld, ins / bld, resizes_insert, resizes_build, built == n ? "" : " FAILED");
+            fflush(stdout);
+        }
+
+        free(keys);
+        free(keyszs);
+        free(vals);
+        keyset_free(&ks);
+        if (n > SIZE_MAX / 10)
+            break;
+    }
+}
+
+static int run_config(const Backend *be, KeyType kt, KeyDist dist, size_t n, double theta,
+                      const HashChoice *hash)
+{
+    KeySet ks;
+    if (!keyset_init(&ks, kt, n))
+    {
+        fprintf(stderr, "Failed to allocate key set (n=%zu)\n", n);
+        return 1;
+    }
+    size_t *search_stream = make_stream(n, dist, theta, 0.1);
+    size_t *update_stream = make_stream(n, dist, theta, 0.0);
+    uint32_t *lat = malloc(MAX_LAT_SAMPLES * sizeof(uint32_t) + sizeof(uint32_t));
+    if (!search_stream || !update_stream || !lat)
+    {
+        fprintf(stderr, "Failed to allocate workload (n=%zu)\n", n);
+        return 1;
+    }
+
+    HashKeyOps kops = {
+        .hash = hash->fn,
+        .eq = kt == KEYS_INT ? compare_int : compare_string,
+        .destroy_key = NULL,
+        .destroy_val = NULL,
+        .hash_seeded = hash->seeded};
+
+    size_t rss_before = peak_rss_kb();
+    HashTable *ht = be->create(kops);
+    if (!ht)
+    {
+        fprintf(stderr, "Failed to create backend %s\n", be->name);
+        return 1;
+    }
+
+    PhaseResult res[5];
+    res[OP_INSERT] = run_phase(ht, OP_INSERT, &ks, NULL, lat);
+    res[OP_SEARCH] = run_phase(ht, OP_SEARCH, &ks, search_stream, lat);
+    res[OP_SEARCH_BATCH] = run_batch_phase(ht, &ks, search_stream);
+    res[OP_UPDATE] = run_phase(ht, OP_UPDATE, &ks, update_stream, lat);
+    size_t rss_peak = peak_rss_kb();
+    res[OP_DELETE] = run_phase(ht, OP_DELETE, &ks, NULL, lat);
+    hashtable_destroy(&ht);
+
+    for (int op = OP_INSERT; op <= OP_DELETE; op++)
+    {
+        printf("%-14s %-7s %-7s %10zu  %-6s %9.1f %8u %8u %10.1f %9.2f %10.1f %10.1f %9zu\n",
+               be->name, KEY_NAMES[kt],
+               dist == DIST_ZIPF ? "zipf" : "uniform", n, OP_NAMES[op],
+               res[op].ns_per_op, res[op].p50, res[op].p99, res[op].max_window / 1000.0,
+               res[op].allocs_per_op,
+               rss_peak / 1024.0, (rss_peak - rss_before) / 1024.0,
+               res[op].failures);
+    }
+    fflush(stdout);
+
+    free(lat);
+    free(search_stream);
+    free(update_stream);
+    keyset_free(&ks);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [--backend NAME|chaining|oa|all] [--keys int|string|collide|all]\n"
+           "          [--dist uniform|zipf|all] [--min-size N] [--max-size N]\n"
+           "          [--zipf-theta T] [--hash NAME] [--hash-speed] [--typed] [--snapshot]\n"
+           "          [--build]\n"
+           "Backends:", prog);
+    for (size_t i = 0; i < NUM_BACKENDS; i++)
+        printf(" %s", BACKENDS[i].name);
+    printf("\nHashes:");
+    for (size_t i = 0; i < NUM_HASHES; i++)
+        printf(" %s", HASHES[i].name);
+    printf("\nSizes run in powers of ten from --min-size (default 1e3) to --max-size\n"
+           "(default 1e6, or 1e3 with --keys collide; pass 100000000 for the full 1e8 sweep).\n");
+}
+
+int main(int argc, char **argv)
+{
+    BenchConfig cfg = {NULL, -1, -1, 1000, 0, 0.99, &HASHES[0]};
+    bool typed = false;
+    bool snapshot = false;
+    bool build = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--performance") == 0)
+            continue; // accepted for compatibility with the old perf targets
+        if (strcmp(arg, "--hash-speed") == 0)
+        {
+            run_hash_speed();
+            return 0;
+        }
+        if (strcmp(arg, "--typed") == 0)
+        {
+            typed = true;
+            continue;
+        }
+        if (strcmp(arg, "--snapshot") == 0)
+        {
+            snapshot = true;
+            continue;
+        }
+        if (strcmp(arg, "--build") == 0)
+        {
+            build = true;
+            continue;
+        }
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0 || !val)
+        {
+            usage(argv[0]);
+            return strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0 ? 0 : 1;
+        }
+        i++;
+        if (strcmp(arg, "--backend") == 0)
+            cfg.backend = val;
+        else if (strcmp(arg, "--keys") == 0)
+            cfg.keys = strcmp(val, "int") == 0      ? KEYS_INT
+                       : strcmp(val, "string") == 0 ? KEYS_STRING
+                       : strcmp(val, "collide") == 0 ? KEYS_COLLIDE
+                                                    : -1;
+        else if (strcmp(arg, "--dist") == 0)
+            cfg.dist = strcmp(val, "uniform") == 0 ? DIST_UNIFORM : strcmp(val, "zipf") == 0 ? DIST_ZIPF : -1;
+        else if (strcmp(arg, "--min-size") == 0)
+            cfg.min_size = strtoull(val, NULL, 10);
+        else if (strcmp(arg, "--max-size") == 0)
+            cfg.max_size = strtoull(val, NULL, 10);
+        else if (strcmp(arg, "--zipf-theta") == 0)
+            cfg.zipf_theta = strtod(val, NULL);
+        else if (strcmp(arg, "--hash") == 0)
+        {
+            cfg.hash = NULL;
+            for (size_t h = 0; h < NUM_HASHES; h++)
+                if (strcmp(val, HASHES[h].name) == 0)
+                    cfg.hash = &HASHES[h];
+            if (!cfg.hash)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.min_size == 0)
+        cfg.min_size = 1;
+    if (cfg.max_size == 0)
+        cfg.max_size = cfg.keys == KEYS_COLLIDE ? 1000 : 1000000; // unseeded collisions are O(n^2)
+    if (typed)
+    {
+        run_typed_compare(cfg.min_size, cfg.max_size);
+        return 0;
+    }
+    if (snapshot)
+    {
+        run_snapshot_compare(cfg.min_size, cfg.max_size);
+        return 0;
+    }
+    if (build)
+    {
+        run_build_compare(cfg.backend, cfg.min_size, cfg.max_size);
+        return 0;
+    }
+    if (cfg.zipf_theta <= 0.0 || cfg.zipf_theta >= 1.0)
+    {
+        fprintf(stderr, "--zipf-theta must be in (0, 1)\n");
+        return 1;
+    }
+
+    printf("# hash: %s\n", cfg.hash->name);
+    printf("%-14s %-7s %-7s %10s  %-6s %9s %8s %8s %10s %9s %10s %10s %9s\n",
+           "backend", "keys", "dist", "n", "op", "ns/op", "p50(ns)", "p99(ns)",
+           "maxwin(us)", "allocs/op", "peakRSS_MB", "table_MB", "failures");
+    fflush(stdout);
+
+    int rc = 0;
+    for (size_t b = 0; b < NUM_BACKENDS; b++)
+    {
+        if (!backend_selected(&BACKENDS[b], cfg.backend))
+            continue;
+        for (int kt = KEYS_INT; kt <= KEYS_COLLIDE; kt++)
+        {
+            if (cfg.keys >= 0 ? cfg.keys != kt : kt == KEYS_COLLIDE)
+                continue;
+            for (int dist = DIST_UNIFORM; dist <= DIST_ZIPF; dist++)
+            {
+                if (cfg.dist >= 0 && cfg.dist != dist)
+                    continue;
+                for (size_t n = cfg.min_size; n <= cfg.max_size; n *= 10)
+                {
+                    // a fresh process per run keeps peak RSS and heap state independent
+                    pid_t pid = fork();
+                    if (pid < 0)
+                    {
+                        perror("fork");
+                        return 1;
+                    }
+                    if (pid == 0)
+                    {
+                        rng_state ^= n;
+                        _exit(run_config(&BACKENDS[b], (KeyType)kt, (KeyDist)dist, n, cfg.zipf_theta,
+                                         cfg.hash));
+                    }
+                    int status = 0;
+                    waitpid(pid, &status, 0);
+                    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                    {
+                        fprintf(stderr, "%s/%s/%s n=%zu failed\n", BACKENDS[b].name,
+                                KEY_NAMES[kt],
+                                dist == DIST_ZIPF ? "zipf" : "uniform", n);
+                        rc = 1;
+                    }
+                    if (n > SIZE_MAX / 10)
+                        break;
+                }
+            }
+        }
+    }
+    return rc;
+}
@@ -1,8 +1,18 @@
+#include <string.h>
 #include "hash.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(HASH_NO_AVX2)
+#define HASH_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
 size_t hash_fnv1a(const void *key, size_t key_size) {
+    return hash_fnv1a_seeded(key, key_size, 0);
+}
+
+size_t hash_fnv1a_seeded(const void *key, size_t key_size, uint64_t seed) {
     const unsigned char *bytes = (const unsigned char *)key;
-    size_t hash = 2166136261u;  // FNV offset basis
+    size_t hash = 2166136261u ^ (size_t)seed;  // FNV offset basis
 
     for (size_t i = 0; i < key_size; i++) {
         hash ^= bytes[i];
@@ -11,31 +21,246 @@ size_t hash_fnv1a(const void *key, size_t key_size) {
     return hash;
 }
 
+/* ========== 64 位乘法工具 ========== */
+
+/* 64×64 → 128 位乘积的高 64 位 */
+static inline uint64_t mul_hi64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32, b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    return hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+/* 128 位乘积的高低两半异或（wyhash 的 mum）：一次乘法让每个输入位影响全部 64 位输出 */
+static inline uint64_t mum(uint64_t a, uint64_t b) {
+    return (a * b) ^ mul_hi64(a, b);
+}
+
 size_t hash_division(const void *key, size_t key_size, size_t table_size) {
-    return hash_fnv1a(key, key_size) % table_size;
+    return hash_division_seeded(key, key_size, table_size, 0);
+}
+
+size_t hash_division_seeded(const void *key, size_t key_size, size_t table_size, uint64_t seed) {
+    return hash_fnv1a_seeded(key, key_size, seed) % table_size;
 }
 
 size_t hash_multiplication(const void *key, size_t key_size, size_t table_size) {
-    size_t key_hash = hash_fnv1a(key, key_size);
-    // 使用整数运算模拟乘法散列（避免浮点运算）
-    uint64_t hash_val = (uint64_t)key_hash * 2654435769u;  // 黄金比例 * 2^32
-    return (size_t)((hash_val >> 32) * table_size >> 32);
+    return hash_multiplication_seeded(key, key_size, table_size, 0);
+}
+
+size_t hash_multiplication_seeded(const void *key, size_t key_size, size_t table_size,
+                                  uint64_t seed) {
+    // 乘以 2^64 / φ 打散全部 64 位，再取 h × table_size 的高 64 位，结果落在 [0, table_size)
+    uint64_t h = (uint64_t)hash_fnv1a_seeded(key, key_size, seed) * 0x9E3779B97F4A7C15ull;
+    return (size_t)mul_hi64(h, table_size);
 }
 
 size_t hash_string_djb2(const char *str) {
-    size_t hash = 5381;  // 经过测试的质数
+    return hash_string_djb2_seeded(str, 0);
+}
+
+size_t hash_string_djb2_seeded(const char *str, uint64_t seed) {
+    // a different start value alone keeps equal-length collisions colliding:
+    // the seed is also mixed into every character, one byte at a time.
+    // Characters are read as plain char, like the original unseeded djb2, so
+    // seed 0 keeps its values for bytes >= 0x80 where char is signed
+    size_t hash = 5381 ^ (size_t)seed;  // 经过测试的质数
+    uint64_t s = seed;
     int c;
     while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+        hash = ((hash << 5) + hash) + (c ^ (s & 0xff)); // hash * 33 + c
+        s = (s >> 8) | (s << 56);
     }
     return hash;
 }
 
 size_t hash_string_fnv1a(const char *str) {
-    size_t hash = 2166136261u;    // FNV offset basis
+    return hash_string_fnv1a_seeded(str, 0);
+}
+
+size_t hash_string_fnv1a_seeded(const char *str, uint64_t seed) {
+    size_t hash = 2166136261u ^ (size_t)seed;    // FNV offset basis
     while (*str) {
         hash ^= (unsigned char)*str++;  // 先异或
         hash *= 16777619;               // 再乘 FNV prime
     }
     return hash;
-}
\ No newline at end of file
+}
+
+/* ========== hash_fast：wyhash / xxh3 风格 ========== */
+
+// wyhash secrets
+#define HASH_S0 0xa0761d6478bd642full
+#define HASH_S1 0xe7037ed1a0b428dbull
+#define HASH_S2 0x8ebc6af09c88c6e3ull
+#define HASH_S3 0x589965cc75374cc3ull
+
+#define HASH_LONG_KEY 256     // longer keys use the 4-lane accumulator
+#define HASH_STRIPE 32        // bytes per accumulator step (one AVX2 register)
+#define HASH_BLOCK_STRIPES 16 // accumulators are scrambled after every block
+#define HASH_KEY_STEP 0x9E3779B97F4A7C15ull // per-stripe change of the lane keys
+#define HASH_PRIME32 0x9E3779B1u
+
+/* 按本机字节序读取（x86 与常见 ARM 均为小端） */
+static inline uint64_t read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+static inline uint64_t read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+static inline uint64_t mix_u64(uint64_t v, uint64_t seed) {
+    return mum(v ^ seed ^ HASH_S0, HASH_S1);
+}
+
+size_t hash_int32(const void *key, size_t key_size) {
+    return hash_int32_seeded(key, key_size, 0);
+}
+
+size_t hash_int32_seeded(const void *key, size_t key_size, uint64_t seed) {
+    (void)key_size;
+    return (size_t)mix_u64(read32((const unsigned char *)key), seed ^ 4);
+}
+
+size_t hash_int64(const void *key, size_t key_size) {
+    return hash_int64_seeded(key, key_size, 0);
+}
+
+size_t hash_int64_seeded(const void *key, size_t key_size, uint64_t seed) {
+    (void)key_size;
+    return (size_t)mix_u64(read64((const unsigned char *)key), seed ^ 8);
+}
+
+/*
+ * 长键：4 个 64 位累加器，每步吃 32 字节（xxh3 的做法）
+ *   acc[j]   += lo32(d[j] ^ k[j]) × hi32(d[j] ^ k[j])
+ *   acc[j^1] += d[j]
+ * 每个 stripe 的 k 都不同，调换数据块的顺序会改变结果
+ */
+static void accumulate_scalar(uint64_t acc[4], uint64_t k[4], const unsigned char *p,
+                              size_t nstripes) {
+    for (size_t s = 0; s < nstripes; s++, p += HASH_STRIPE) {
+        for (int j = 0; j < 4; j++) {
+            uint64_t d = read64(p + 8 * j);
+            uint64_t dk = d ^ k[j];
+            acc[j ^ 1] += d;
+            acc[j] += (dk & 0xffffffffu) * (dk >> 32);
+            k[j] += HASH_KEY_STEP;
+        }
+    }
+}
+
+#ifdef HASH_AVX2_DISPATCH
+/* 与 accumulate_scalar 逐位相同的 AVX2 版本：一条指令处理 4 个通道 */
+__attribute__((target("avx2")))
+static void accumulate_avx2(uint64_t acc[4], uint64_t k[4], const unsigned char *p,
+                            size_t nstripes) {
+    __m256i vacc = _mm256_loadu_si256((const __m256i *)acc);
+    __m256i vkey = _mm256_loadu_si256((const __m256i *)k);
+    const __m256i step = _mm256_set1_epi64x((long long)HASH_KEY_STEP);
+    for (size_t s = 0; s < nstripes; s++, p += HASH_STRIPE) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)p);
+        __m256i dk = _mm256_xor_si256(d, vkey);
+        __m256i prod = _mm256_mul_epu32(dk, _mm256_srli_epi64(dk, 32));
+        __m256i swapped = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+        vacc = _mm256_add_epi64(vacc, _mm256_add_epi64(prod, swapped));
+        vkey = _mm256_add_epi64(vkey, step);
+    }
+    _mm256_storeu_si256((__m256i *)acc, vacc);
+    _mm256_storeu_si256((__m256i *)k, vkey);
+}
+#endif
+
+static inline void accumulate(uint64_t acc[4], uint64_t k[4], const unsigned char *p,
+                              size_t nstripes) {
+#ifdef HASH_AVX2_DISPATCH
+    if (__builtin_cpu_supports("avx2")) {
+        accumulate_avx2(acc, k, p, nstripes);
+        return;
+    }
+#endif
+    accumulate_scalar(acc, k, p, nstripes);
+}
+
+static uint64_t hash_long(const unsigned char *p, size_t len, uint64_t seed) {
+    uint64_t acc[4] = {HASH_S0, HASH_S1 ^ seed, HASH_S2, HASH_S3 ^ seed};
+    uint64_t k[4] = {HASH_S1 ^ seed, HASH_S2, HASH_S3 ^ seed, HASH_S0};
+    size_t nstripes = len / HASH_STRIPE;
+
+    for (size_t done = 0; done < nstripes; done += HASH_BLOCK_STRIPES) {
+        size_t n = nstripes - done < HASH_BLOCK_STRIPES ? nstripes - done : HASH_BLOCK_STRIPES;
+        accumulate(acc, k, p + done * HASH_STRIPE, n);
+        // scramble so long inputs cannot cancel out in the sums
+        for (int j = 0; j < 4; j++)
+            acc[j] = (acc[j] ^ (acc[j] >> 47)) * HASH_PRIME32;
+    }
+    if (len % HASH_STRIPE)
+        accumulate_scalar(acc, k, p + len - HASH_STRIPE, 1); // overlapping last stripe
+
+    uint64_t h = mum(acc[0] ^ HASH_S1, acc[1] ^ HASH_S2) ^ mum(acc[2] ^ HASH_S3, acc[3] ^ HASH_S0);
+    return mum(h ^ len, HASH_S1);
+}
+
+static uint64_t hash_fast_impl(const void *key, size_t len, uint64_t seed) {
+    const unsigned char *p = (const unsigned char *)key;
+    const uint64_t key_seed = seed;
+    uint64_t a, b;
+
+    // integer keys: a single 128-bit multiply
+    if (len == 4)
+        return mix_u64(read32(p), seed ^ 4);
+    if (len == 8)
+        return mix_u64(read64(p), seed ^ 8);
+
+    seed ^= HASH_S0;
+    if (len <= 16) {
+        if (len >= 4) {
+            // two overlapping 4-byte reads from each end cover 4..16 bytes
+            size_t mid = (len >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + mid);
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else if (len <= HASH_LONG_KEY) {
+        // 32 bytes per step in two independent multiply chains
+        const unsigned char *q = p;
+        size_t i = len;
+        uint64_t seed1 = seed;
+        for (; i > 32; i -= 32, q += 32) {
+            seed = mum(read64(q) ^ HASH_S1, read64(q + 8) ^ seed);
+            seed1 = mum(read64(q + 16) ^ HASH_S2, read64(q + 24) ^ seed1);
+        }
+        // both chains start from the same value: fold the caller's seed back in, or
+        // 17..32-byte keys (no full step) would cancel it out; seed 0 is unaffected
+        seed ^= seed1 ^ key_seed;
+        if (i > 16) {
+            seed = mum(read64(q) ^ HASH_S1, read64(q + 8) ^ seed);
+        }
+        a = read64(p + len - 16);
+        b = read64(p + len - 8);
+    } else {
+        return hash_long(p, len, seed);
+    }
+    return mum(HASH_S1 ^ len, mum(a ^ HASH_S1, b ^ seed));
+}
+
+size_t hash_fast(const void *key, size_t key_size) {
+    return (size_t)hash_fast_impl(key, key_size, 0);
+}
+
+size_t hash_fast_seeded(const void *key, size_t key_size, uint64_t seed) {
+    return (size_t)hash_fast_impl(key, key_size, seed);
+}
@@ -1,6 +1,7 @@
 #ifndef HASH_H
 #define HASH_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 size_t hash_fnv1a(const void *key, size_t key_size); 
@@ -10,4 +11,36 @@ size_t hash_multiplication(const void *key, size_t key_size, size_t table_size);
 size_t hash_string_djb2(const char *str);
 size_t hash_string_fnv1a(const char *str);
 
-#endif
\ No newline at end of file
+/*
+ * 快速 64 位哈希（wyhash / xxh3 风格），签名与 hash_func_t 相同，可直接放进 HashKeyOps.hash
+ * - 4 / 8 字节键（int、int64、指针）：一次 64×64→128 位乘法
+ * - 不超过 256 字节（HASH_LONG_KEY）：每步 32 字节，两条独立的乘法链
+ * - 更长的键：4 个 64 位累加器每步 32 字节，CPU 支持 AVX2 时运行期切换到向量版本
+ *   （两条路径结果逐位相同；编译时加 -DHASH_NO_AVX2 可关闭）
+ * - 高位与低位都充分混合：掩码取桶和按高位分片都可直接使用
+ */
+size_t hash_fast(const void *key, size_t key_size);
+
+/* 已知键为 4 / 8 字节整数时的专用版本，结果与 hash_fast 相同 */
+size_t hash_int32(const void *key, size_t key_size);
+size_t hash_int64(const void *key, size_t key_size);
+
+/*
+ * 带种子的版本，签名与 hash_seeded_func_t 相同，可放进 HashKeyOps.hash_seeded
+ * - seed 为 0 时结果与对应的无种子版本相同
+ *   （djb2 与原版一样按 char 读取字符，char 有符号时 >= 0x80 的字节按负数参与）
+ * - 键集合固定时，换一个种子就换一套冲突：攻击者不知道种子就无法离线构造大量冲突键
+ * - FNV-1a / djb2 只把种子混进初始值（djb2 另外逐字节异或），对能观察到表行为的攻击者并不安全；
+ *   面向不可信输入时优先用 hash_fast_seeded，种子在整个 64 位状态上参与每一步乘法
+ */
+size_t hash_fnv1a_seeded(const void *key, size_t key_size, uint64_t seed);
+size_t hash_division_seeded(const void *key, size_t key_size, size_t table_size, uint64_t seed);
+size_t hash_multiplication_seeded(const void *key, size_t key_size, size_t table_size,
+                                  uint64_t seed);
+size_t hash_string_djb2_seeded(const char *str, uint64_t seed);
+size_t hash_string_fnv1a_seeded(const char *str, uint64_t seed);
+size_t hash_fast_seeded(const void *key, size_t key_size, uint64_t seed);
+size_t hash_int32_seeded(const void *key, size_t key_size, uint64_t seed);
+size_t hash_int64_seeded(const void *key, size_t key_size, uint64_t seed);
+
+#endif
@@ -39,6 +39,59 @@ bool hashtable_update(HashTable *ht, const void *key, size_t keysz, void *new_va
     return ht->ops.update(ht->impl, key, keysz, new_value);
 }
 
+size_t hashtable_search_batch(HashTable *ht, const void **keys, const size_t *keyszs,
+                              size_t n, void **out)
+{
+    if (!ht || !keys || !keyszs || !out) return 0;
+    if (ht->ops.search_batch)
+        return ht->ops.search_batch(ht->impl, keys, keyszs, n, out);
+
+    size_t found = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = ht->ops.search(ht->impl, keys[i], keyszs[i]);
+        found += out[i] != NULL;
+    }
+    return found;
+}
+
+size_t hashtable_insert_batch(HashTable *ht, const void **keys, const size_t *keyszs,
+                              void **values, size_t n)
+{
+    if (!ht || !keys || !keyszs || !values) return 0;
+    if (ht->ops.insert_batch)
+        return ht->ops.insert_batch(ht->impl, keys, keyszs, values, n);
+
+    size_t inserted = 0;
+    for (size_t i = 0; i < n; i++)
+        inserted += ht->ops.insert(ht->impl, keys[i], keyszs[i], values[i]);
+    return inserted;
+}
+
+size_t hashtable_build(HashTable *ht, const void **keys, const size_t *keyszs,
+                       void **values, size_t n)
+{
+    if (!ht || !keys || !keyszs || !values) return 0;
+    if (ht->ops.build)
+        return ht->ops.build(ht->impl, keys, keyszs, values, n);
+    // best effort: if the table cannot be pre-sized, the inserts still grow it
+    if (ht->ops.reserve)
+        ht->ops.reserve(ht->impl, ht->ops.size(ht->impl) + n);
+    return hashtable_insert_batch(ht, keys, keyszs, values, n);
+}
+
+bool hashtable_reserve(HashTable *ht, size_t n)
+{
+    if (!ht || !ht->ops.reserve) return false;
+    return ht->ops.reserve(ht->impl, n);
+}
+
+bool hashtable_shrink_to_fit(HashTable *ht)
+{
+    if (!ht || !ht->ops.shrink_to_fit) return false;
+    return ht->ops.shrink_to_fit(ht->impl);
+}
+
 size_t hashtable_size(const HashTable *ht) 
 {
     if (!ht) return 0;
@@ -63,6 +116,25 @@ bool hashtable_is_empty(const HashTable *ht)
     return ht->ops.size == 0;
 }
 
+bool hashtable_foreach(HashTable *ht, hashtable_visit_t visit, void *ctx)
+{
+    if (!ht || !visit) return false;
+    return ht->ops.foreach(ht->impl, visit, ctx);
+}
+
+HashIter hashtable_iter_begin(HashTable *ht)
+{
+    (void)ht; // every backend starts from slot / bucket 0
+    HashIter it = {0, NULL, 0, NULL, 0, NULL};
+    return it;
+}
+
+bool hashtable_iter_next(HashTable *ht, HashIter *it)
+{
+    if (!ht || !it) return false;
+    return ht->ops.iter_next(ht->impl, it);
+}
+
 HashStats hashtable_get_stats(const HashTable *ht)
 {
     return(ht->ops.stats(ht->impl));
@@ -77,13 +149,26 @@ void hashtable_print_stats(const HashTable *ht)
         "    - Used buckets: %zu\n"
         "    - Max chain or probe: %zu\n"
         "    - Average chain length: %.2f\n"
-        "    - Collision count: %zu", 
+        "    - Collision count: %zu\n"
+        "    - Tombstones: %zu\n"
+        "    - Avg probe (hit / miss): %.2f / %.2f\n"
+        "    - Resize count: %zu\n"
+        "    - Bytes used: %zu\n"
+        "    - Histogram:",
         hashstats.total_elements, 
         hashstats.used_buckets, 
         hashstats.max_chain_or_probe, 
         hashstats.average_chain_length, 
-        hashstats.collision_count
+        hashstats.collision_count,
+        hashstats.tombstones,
+        hashstats.avg_probe_success,
+        hashstats.avg_probe_failure,
+        hashstats.resize_count,
+        hashstats.bytes_used
     );
+    for (size_t i = 0; i < HT_HIST_BUCKETS; i++)
+        printf(" %zu%s:%zu", i, i == HT_HIST_BUCKETS - 1 ? "+" : "", hashstats.histogram[i]);
+    printf("\n");
 }
 
 bool hashtable_insert_string(HashTable *ht, const char *key, void *value)
@@ -19,6 +19,46 @@ void *hashtable_search(HashTable *ht, const void *key, size_t keysz);
 bool hashtable_delete(HashTable *ht, const void *key, size_t keysz);
 bool hashtable_update(HashTable *ht, const void *key, size_t keysz, void *new_value);
 
+/*
+ * 批量接口：先计算所有键的哈希并预取槽位，再逐个解析，适合大量独立查找
+ * search_batch: out[i] 为 keys[i] 对应的值（不存在为 NULL），返回命中个数
+ * insert_batch: 语义同逐个 hashtable_insert，返回成功插入/更新的个数
+ */
+size_t hashtable_search_batch(HashTable *ht, const void **keys, const size_t *keyszs,
+                              size_t n, void **out);
+size_t hashtable_insert_batch(HashTable *ht, const void **keys, const size_t *keyszs,
+                              void **values, size_t n);
+
+/*
+ * 批量建表：按 hashtable_size(ht) + n 和负载因子一次把表扩到位，再插入全部键值
+ * （过程中不再逐步翻倍、反复 rehash）；重复键按 hashtable_insert 的语义覆盖。
+ * 分片表先按哈希把键分到各分片，再由多个线程并行填充互不相交的分片。
+ * 返回成功插入/覆盖的个数
+ */
+size_t hashtable_build(HashTable *ht, const void **keys, const size_t *keyszs,
+                       void **values, size_t n);
+
+/*
+ * 容量控制
+ * - hashtable_reserve：一次扩到能容纳共 n 个元素的容量，之后插入到 n 个都不再扩容；
+ *   链地址法还会把它记为下限，删除时不会缩到它以下（其余后端本来就不自动缩容）
+ * - hashtable_shrink_to_fit：清除下限，把容量缩到恰好装下当前元素（开放地址表顺带清掉墓碑）
+ * 后端不支持（如只读快照）或分配失败时返回 false，表保持原样
+ */
+bool hashtable_reserve(HashTable *ht, size_t n);
+bool hashtable_shrink_to_fit(HashTable *ht);
+
+/*
+ * 遍历：每个元素恰好访问一次，顺序为存储顺序（不是插入顺序）
+ * - hashtable_foreach：对每个元素调用 visit，visit 返回 false 时提前停止（此时返回 false）
+ * - 游标：HashIter it = hashtable_iter_begin(ht); while (hashtable_iter_next(ht, &it)) use(it.key, it.value);
+ * 遍历期间（包括 visit 回调里）不能插入或删除；查找和 update 可以
+ * key 指向表内保存的键，下一次修改表之前有效
+ */
+bool hashtable_foreach(HashTable *ht, hashtable_visit_t visit, void *ctx);
+HashIter hashtable_iter_begin(HashTable *ht);
+bool hashtable_iter_next(HashTable *ht, HashIter *it);
+
 /* 状态查询 */
 size_t hashtable_size(const HashTable *ht);
 size_t hashtable_capacity(const HashTable *ht);
@@ -9,6 +9,7 @@
 #include "hashtable_internal.h"
 #include "../dynamic_array/dynamic_array.h"
 #include "../doubly_circular_list/doubly_circular_list.h"
+#include "../common/arena.h"
 
 typedef struct HashTableChaining
 {
@@ -18,15 +19,61 @@ typedef struct HashTableChaining
     double max_load_factor;
     size_t collision_count;
     HashKeyOps keyops;
+    KeyStore keys;
+    ResizeMode resize;
+    DynamicArray *old_buckets; // RESIZE_INCREMENTAL: buckets being drained, NULL otherwise
+    size_t old_capacity;
+    size_t migrate_pos;        // old buckets [0, migrate_pos) have been moved
+    size_t min_capacity;       // initial capacity / reserve: erase never shrinks below it
+    size_t lists;              // bucket lists allocated so far (old + new buckets)
+
+    // statistics, kept up to date on every change so chaining_stats is O(1)
+    size_t hist[HT_HIST_BUCKETS]; // buckets (old + new) by chain length
+    size_t pos_sum;               // sum of L(L+1)/2 over all buckets
+    size_t max_chain;             // longest chain since the last rehash
+    size_t resizes;
+
+    // HashNodes and list nodes come from node_alloc / link_alloc: the table's own slab
+    // pools by default, or the caller's allocator (then both pools stay empty)
+    Allocator node_alloc;
+    Allocator link_alloc;
+    Pool node_pool;
+    Pool link_pool;
 } HashTableChaining;
 
 typedef struct HashNode
 {
-    void *key;
+    HtKey key; // short keys inline in the node, longer ones in the table's KeyStore
     void *value;
     size_t key_size;
 } HashNode;
 
+static inline const void *node_key(const HashTableChaining *htc, const HashNode *hn)
+{
+    return keystore_get(&htc->keys, &hn->key, hn->key_size);
+}
+
+// buckets moved per operation while an incremental resize is running
+#define CHAINING_MIGRATE_BUCKETS 8
+
+// hysteresis: grow on insert above max_load_factor, shrink on erase below
+// max_load_factor * CHAINING_SHRINK_RATIO; after halving the load is still well under the grow point
+#define CHAINING_SHRINK_RATIO 0.25
+
+// approximate footprint of the list header / node behind each bucket / element
+#define LIST_HEADER_BYTES (4 * sizeof(void *))
+#define LIST_NODE_BYTES (3 * sizeof(void *))
+
+/* 某个桶的链长从 from 变为 to：更新直方图、Σ L(L+1)/2 与最大链长 */
+static inline void stats_chain(HashTableChaining *htc, size_t from, size_t to)
+{
+    htc->hist[ht_hist_bin(from)]--;
+    htc->hist[ht_hist_bin(to)]++;
+    htc->pos_sum = htc->pos_sum - from * (from + 1) / 2 + to * (to + 1) / 2;
+    if (to > htc->max_chain)
+        htc->max_chain = to;
+}
+
 static size_t next_capacity(size_t cur)
 {
     return cur ? (cur << 1) : 8; // minimum capacity 8
@@ -37,139 +84,275 @@ static size_t prev_capacity(size_t cur)
     return (cur > 8) ? (cur >> 1) : 8;
 }
 
-static bool chaining_rehash(HashTableChaining *htc, size_t new_capacity, const HashKeyOps *keyops)
+/* 桶数组里先全部放 NULL，某个桶第一次插入时才创建它的链表（rehash 不再一次建 capacity 个链表） */
+static DynamicArray *buckets_create(size_t capacity)
 {
-    if (new_capacity < 8)
-        new_capacity = 8;
+    DynamicArray *buckets = array_create(capacity);
+    if (!buckets)
+        return NULL;
 
-    // create new buckets
-    DynamicArray *new_buckets = array_create(new_capacity);
-    if (!new_buckets)
-        return false;
+    for (size_t i = 0; i < capacity; i++)
+        array_push_back(buckets, NULL); // cannot fail, the capacity is already there
+    return buckets;
+}
 
-    // init list
-    for (size_t i = 0; i < new_capacity; i++)
+/* 桶数组的第 idx 项；直接读 data，空桶（NULL）是常态，不经 array_get_at 的检查和告警 */
+static inline DoublyCircularList *bucket_slot(const DynamicArray *buckets, size_t idx)
+{
+    return (DoublyCircularList *)buckets->data[idx];
+}
+
+/* buckets[idx] 的链表，尚未创建时为 NULL；create 为 true 时按需创建（失败仍返回 NULL） */
+static DoublyCircularList *bucket_at(HashTableChaining *htc, DynamicArray *buckets, size_t idx,
+                                     bool create)
+{
+    DoublyCircularList *lst = bucket_slot(buckets, idx);
+    if (!lst && create)
     {
-        DoublyCircularList *lst = list_create(keyops->eq);
+        lst = list_create_with_allocator(htc->keyops.eq, &htc->link_alloc);
+        if (lst)
+        {
+            buckets->data[idx] = lst;
+            htc->lists++;
+        }
+    }
+    return lst;
+}
 
+/* 销毁桶数组；nodes 为 true 时连同链表中的节点（键/值）一起释放 */
+static void buckets_destroy(HashTableChaining *htc, DynamicArray **pbuckets, bool nodes)
+{
+    DynamicArray *buckets = *pbuckets;
+    if (!buckets)
+        return;
+    for (size_t i = 0; i < array_size(buckets); i++)
+    {
+        DoublyCircularList *lst = bucket_slot(buckets, i);
         if (!lst)
+            continue;
+        while (nodes && !list_is_empty(lst))
         {
-            for (size_t j = 0; j < i; j++)
-            {
-                DoublyCircularList *to_destroy = array_get_at(htc->buckets, j);
-                if (to_destroy) {
-                    list_destroy(&to_destroy);
-                }
-            }
-            array_destroy(&new_buckets);
-            return false;
+            HashNode *hn = (HashNode *)list_pop_front(lst);
+            if (!hn) break;
+            keystore_release(&htc->keys, &hn->key, hn->key_size);
+            if (htc->keyops.destroy_val) htc->keyops.destroy_val(hn->value);
+            allocator_free(&htc->node_alloc, hn, sizeof(HashNode));
         }
-
-        array_push_back(new_buckets, lst);
+        list_destroy(&lst);
+        htc->lists--;
     }
+    array_destroy(pbuckets);
+}
 
-    // rehash
-    htc->collision_count = 0;
-    for (size_t i = 0; i < htc->capacity; i++)
+/* 把旧表第 i 个桶中的节点全部挂到新表 */
+static void migrate_bucket(HashTableChaining *htc, size_t i)
+{
+    DoublyCircularList *oldlst = bucket_slot(htc->old_buckets, i);
+    size_t n = oldlst ? list_size(oldlst) : 0;
+    for (size_t j = 0; j < n; j++)
     {
-        DoublyCircularList *oldlst = (DoublyCircularList *)array_get_at(htc->buckets, i);
+        HashNode *hn = (HashNode *)list_get_head(oldlst);
+        list_remove_head(oldlst);
+
+        size_t idx = ht_hash(&htc->keyops, node_key(htc, hn), hn->key_size) % htc->capacity;
+        DoublyCircularList *newlst = bucket_at(htc, htc->buckets, idx, true);
+        size_t len = list_size(newlst);
+        if (len > 0)
+            htc->collision_count++;
+        list_insert_tail(newlst, hn);
+        stats_chain(htc, n - j, n - j - 1);
+        stats_chain(htc, len, len + 1);
+    }
+}
 
-        size_t n = list_size(oldlst);
-        for (size_t j = 0; j < n; j++)
-        {
-            HashNode *hn = (HashNode *)list_get_head(oldlst);
-            list_remove_head(oldlst);
-
-            size_t idx = keyops->hash(hn->key, hn->key_size) % new_capacity;
-            DoublyCircularList *newlst = (DoublyCircularList *)array_get_at(new_buckets, idx);
-            if (list_size(newlst) > 0)
-                htc->collision_count++;
-            list_insert_tail(newlst, hn);
-        }
-        list_destroy(&oldlst);
+/* 迁移最多 max_buckets 个旧桶，旧表搬空后释放 */
+static void chaining_migrate(HashTableChaining *htc, size_t max_buckets)
+{
+    size_t pos = htc->migrate_pos;
+    size_t end = (max_buckets > htc->old_capacity - pos) ? htc->old_capacity : pos + max_buckets;
+    for (; pos < end; pos++)
+        migrate_bucket(htc, pos);
+    htc->migrate_pos = pos;
+
+    if (pos == htc->old_capacity)
+    {
+        buckets_destroy(htc, &htc->old_buckets, false);
+        htc->hist[0] -= htc->old_capacity; // every old bucket is empty by now
+        htc->old_capacity = 0;
+        htc->migrate_pos = 0;
     }
+}
+
+static bool chaining_rehash(HashTableChaining *htc, size_t new_capacity)
+{
+    if (new_capacity < 8)
+        new_capacity = 8;
+    if (new_capacity == htc->capacity)
+        return true;
+
+    // a pending migration has to finish before the next one can start
+    if (htc->old_buckets)
+        chaining_migrate(htc, SIZE_MAX);
+
+    // create new buckets
+    DynamicArray *new_buckets = buckets_create(new_capacity);
+    if (!new_buckets)
+        return false;
 
-    // replace bucket in hashtable
-    array_destroy(&htc->buckets);
+    htc->old_buckets = htc->buckets;
+    htc->old_capacity = htc->capacity;
+    htc->migrate_pos = 0;
     htc->buckets = new_buckets;
     htc->capacity = new_capacity;
+    htc->collision_count = 0;
+    htc->hist[0] += new_capacity;
+    htc->max_chain = 0;
+    htc->resizes++;
 
+    // all at once: move every bucket now
+    if (htc->resize != RESIZE_INCREMENTAL)
+        chaining_migrate(htc, SIZE_MAX);
     return true;
 }
 
+/* 键所在的桶：增量扩容期间，尚未迁移的旧桶中的键仍留在旧表；桶还没有链表时为 NULL */
+static DoublyCircularList *bucket_for(HashTableChaining *htc, const void *key, size_t keysz,
+                                      bool create)
+{
+    size_t hash = ht_hash(&htc->keyops, key, keysz);
+    if (htc->old_buckets)
+    {
+        size_t old_idx = hash % htc->old_capacity;
+        if (old_idx >= htc->migrate_pos)
+            return bucket_at(htc, htc->old_buckets, old_idx, create);
+    }
+    return bucket_at(htc, htc->buckets, hash % htc->capacity, create);
+}
+
+/* 桶内按键查找，返回链表节点；沿 next 指针走，每步 O(1) */
+static Node *bucket_find(HashTableChaining *htc, DoublyCircularList *lst, const void *key)
+{
+    if (!lst)
+        return NULL;
+    for (Node *nd = list_first_node(lst); nd; nd = list_next_node(lst, nd))
+    {
+        HashNode *hn = (HashNode *)list_node_data(nd);
+        if (htc->keyops.eq(key, node_key(htc, hn)) == 0)
+            return nd;
+    }
+    return NULL;
+}
+
 static bool chaining_insert(void *impl, const void *key, size_t keysz, void *value)
 {
     HashTableChaining *htc = (HashTableChaining *)impl;
-    HashKeyOps *keyops = &htc->keyops;
-    size_t idx = keyops->hash(key, keysz) % htc->capacity;
-    DoublyCircularList *lst = (DoublyCircularList *)array_get_at(htc->buckets, idx);
+    if (htc->old_buckets)
+        chaining_migrate(htc, CHAINING_MIGRATE_BUCKETS);
+    DoublyCircularList *lst = bucket_for(htc, key, keysz, true);
+    if (!lst)
+        return false;
 
     // find key and modify
-    size_t n = list_size(lst);
-    for (size_t i = 0; i < n; i++)
+    Node *found = bucket_find(htc, lst, key);
+    if (found)
     {
-        HashNode *hn = (HashNode *)list_get_at(lst, i);
-        if (keyops->eq(key, hn->key) == 0)
-        {
-            hn->value = value;
-            return true;
-        }
+        ((HashNode *)list_node_data(found))->value = value;
+        return true;
     }
+    size_t n = list_size(lst);
     if (n > 0)
     {
         htc->collision_count++; // not empty
     }
 
     // key doesn't exist
-    HashNode *hn = malloc(sizeof(HashNode));
+    HashNode *hn = allocator_alloc(&htc->node_alloc, sizeof(HashNode));
     if (!hn)
         return false;
-    hn->key = malloc(keysz);
-    if (!hn->key)
+    if (!keystore_put(&htc->keys, &hn->key, key, keysz))
     {
-        free(hn);
+        allocator_free(&htc->node_alloc, hn, sizeof(HashNode));
         return false;
     }
-    memcpy(hn->key, key, keysz);
     hn->key_size = keysz;
     hn->value = value;
 
     // insert
-    list_insert_tail(lst, hn);
-    htc->size++;
-
-    // rehash
-    double alpha = (double)htc->size / (double)htc->capacity;
-    if (alpha > htc->max_load_factor)
+    if (!list_insert_tail(lst, hn))
     {
-        chaining_rehash(htc, next_capacity(htc->capacity), keyops);
-    }
-    else if (alpha < 0.25)
-    {
-        chaining_rehash(htc, prev_capacity(htc->capacity), keyops);
+        keystore_release(&htc->keys, &hn->key, keysz);
+        allocator_free(&htc->node_alloc, hn, sizeof(HashNode));
+        return false;
     }
+    htc->size++;
+    stats_chain(htc, n, n + 1);
+
+    // grow only; shrinking is left to erase
+    if ((double)htc->size > htc->max_load_factor * (double)htc->capacity)
+        chaining_rehash(htc, next_capacity(htc->capacity));
+
+    return true;
+}
+
+/* 装下 n 个元素而不超过 max_load_factor 的最少桶数（至少 8），溢出时返回 0 */
+static size_t capacity_for(const HashTableChaining *htc, size_t n)
+{
+    double want = (double)n / htc->max_load_factor;
+    if (want >= (double)SIZE_MAX)
+        return 0;
+    size_t cap = (size_t)want;
+    if ((double)cap < want)
+        cap++;
+    return cap < 8 ? 8 : cap;
+}
+
+/*
+ * 预留共 n 个元素的空间：一次换成 n / max_load_factor 个桶（增量模式也立即迁完），
+ * 并把下限提高到这个容量，之后删除也不会缩到它以下
+ */
+static bool chaining_reserve(void *impl, size_t n)
+{
+    HashTableChaining *htc = (HashTableChaining *)impl;
+    size_t cap = capacity_for(htc, n);
+    if (!cap)
+        return false;
+    if (cap > htc->capacity && !chaining_rehash(htc, cap))
+        return false;
+    // only a capacity the table actually has becomes the floor
+    if (cap > htc->min_capacity)
+        htc->min_capacity = cap;
+    if (htc->old_buckets)
+        chaining_migrate(htc, SIZE_MAX);
+    return true;
+}
 
+/* 清除下限，换成恰好装下当前元素的桶数 */
+static bool chaining_shrink_to_fit(void *impl)
+{
+    HashTableChaining *htc = (HashTableChaining *)impl;
+    size_t cap = capacity_for(htc, htc->size);
+    if (cap < htc->capacity && !chaining_rehash(htc, cap))
+        return false;
+    htc->min_capacity = 8;
+    if (htc->old_buckets)
+        chaining_migrate(htc, SIZE_MAX);
     return true;
 }
 
-static inline size_t idx_for(HashTableChaining *htc, const void *key, size_t keysz)
+static inline DoublyCircularList *lookup_bucket(HashTableChaining *htc, const void *key, size_t keysz)
 {
-    return htc->keyops.hash(key, keysz) % htc->capacity;
+    if (htc->old_buckets)
+        chaining_migrate(htc, CHAINING_MIGRATE_BUCKETS);
+    return bucket_for(htc, key, keysz, false);
 }
 
 static void *chaining_search(void *impl, const void *key, size_t keysz)
 {
     HashTableChaining *htc = (HashTableChaining *)impl;
 
-    DoublyCircularList *lst = (DoublyCircularList *)array_get_at(htc->buckets, idx_for(htc, key, keysz));
-    size_t n = list_size(lst);
-    for (size_t i = 0; i < n; i++)
-    {
-        HashNode *hn = (HashNode *)list_get_at(lst, i);
-        if (htc->keyops.eq(key, hn->key) == 0)
-            return hn->value;
-    }
-    return NULL;
+    DoublyCircularList *lst = lookup_bucket(htc, key, keysz);
+    Node *nd = bucket_find(htc, lst, key);
+    return nd ? ((HashNode *)list_node_data(nd))->value : NULL;
 }
 
 static bool chaining_erase(void *impl, const void *key, size_t keysz)
@@ -177,46 +360,41 @@ static bool chaining_erase(void *impl, const void *key, size_t keysz)
     HashTableChaining *htc = (HashTableChaining *)impl;
     HashKeyOps keyops = htc->keyops;
 
-    DoublyCircularList *lst = (DoublyCircularList *)array_get_at(htc->buckets, idx_for(htc, key, keysz));
+    DoublyCircularList *lst = lookup_bucket(htc, key, keysz);
+    Node *nd = bucket_find(htc, lst, key);
+    if (!nd)
+        return false;
+
+    HashNode *hn = (HashNode *)list_node_data(nd);
     size_t n = list_size(lst);
-    for (size_t i = 0; i < n; i++)
+    keystore_release(&htc->keys, &hn->key, hn->key_size);
+    if (keyops.destroy_val)
+        keyops.destroy_val(hn->value);
+
+    list_remove_node(lst, nd);
+    allocator_free(&htc->node_alloc, hn, sizeof(HashNode));
+    htc->size--;
+    stats_chain(htc, n, n - 1);
+
+    if (!htc->old_buckets && htc->capacity > htc->min_capacity &&
+        (double)htc->size < htc->max_load_factor * CHAINING_SHRINK_RATIO * (double)htc->capacity)
     {
-        HashNode *hn = (HashNode *)list_get_at(lst, i);
-        if (keyops.eq(key, hn->key) == 0)
-        {
-            if (keyops.destroy_key)
-                keyops.destroy_key(hn->key);
-            else
-                free(hn->key);
-            if (keyops.destroy_val)
-                keyops.destroy_val(hn->value);
-
-            list_remove_at(lst, i);
-            free(hn);
-            htc->size--;
-            return true;
-        }
+        size_t cap = prev_capacity(htc->capacity);
+        chaining_rehash(htc, cap < htc->min_capacity ? htc->min_capacity : cap);
     }
-    return false;
+    return true;
 }
 
 static bool chaining_update(void *impl, const void *key, size_t keysz, void *new_value)
 {
     HashTableChaining *htc = (HashTableChaining *)impl;
-    HashKeyOps keyops = htc->keyops;
 
-    DoublyCircularList *lst = (DoublyCircularList *)array_get_at(htc->buckets, idx_for(htc, key, keysz));
-    size_t n = list_size(lst);
-    for (size_t i = 0; i < n; i++)
-    {
-        HashNode *hn = (HashNode *)list_get_at(lst, i);
-        if (keyops.eq(key, hn->key) == 0)
-        {
-            hn->value = new_value;
-            return true;
-        }
-    }
-    return false;
+    DoublyCircularList *lst = lookup_bucket(htc, key, keysz);
+    Node *nd = bucket_find(htc, lst, key);
+    if (!nd)
+        return false;
+    ((HashNode *)list_node_data(nd))->value = new_value;
+    return true;
 }
 
 static size_t chaining_size(const void *impl)
@@ -237,61 +415,85 @@ static double chaining_load_factor(const void *impl)
 
 static HashStats chaining_stats(const void *impl)
 {
-    HashTableChaining *htc = (const HashTableChaining*)impl;
+    const HashTableChaining *htc = (const HashTableChaining*)impl;
     HashStats hs = {0};
 
+    size_t nbuckets = htc->capacity + htc->old_capacity;
     hs.total_elements = htc->size;
     hs.collision_count = htc->collision_count;
-    hs.used_buckets = array_size(htc->buckets);
+    hs.used_buckets = nbuckets - htc->hist[0];
+    hs.average_chain_length = (double)htc->size / htc->capacity;
+    hs.max_chain_or_probe = htc->max_chain;
+    memcpy(hs.histogram, htc->hist, sizeof(hs.histogram));
+
+    // a hit on the i-th node of a chain inspects i nodes; a miss walks the whole chain
+    hs.avg_probe_success = htc->size ? (double)htc->pos_sum / htc->size : 0.0;
+    hs.avg_probe_failure = (double)htc->size / nbuckets;
+    hs.resize_count = htc->resizes;
+    hs.bytes_used = sizeof(HashTableChaining) + htc->keys.bytes
+                  + nbuckets * sizeof(void *) + htc->lists * LIST_HEADER_BYTES;
+    if (htc->node_alloc.ctx == &htc->node_pool)
+        hs.bytes_used += htc->node_pool.bytes + htc->link_pool.bytes;
+    else
+        hs.bytes_used += (htc->lists + htc->size) * LIST_NODE_BYTES + htc->size * sizeof(HashNode);
+    return hs;
+}
 
-    // calculate average and max chain length
-    size_t sum_length = 0;
-    size_t max_length = 0;
-    size_t n = array_capacity(htc->buckets);
-    for (size_t i = 0; i < n; i++)
+static bool chaining_foreach(void *impl, hashtable_visit_t visit, void *ctx)
+{
+    HashTableChaining *htc = (HashTableChaining *)impl;
+    // a lookup in visit would migrate buckets under the scan; move everything first
+    if (htc->old_buckets)
+        chaining_migrate(htc, SIZE_MAX);
+    for (size_t i = 0; i < htc->capacity; i++)
     {
-        size_t chain_length = list_size(array_get_at(htc->buckets, i));
-        sum_length += chain_length;
-        if (max_length < chain_length)
+        DoublyCircularList *lst = bucket_slot(htc->buckets, i);
+        if (i + 1 < htc->capacity)
+            HT_PREFETCH(bucket_slot(htc->buckets, i + 1)); // next list header
+        if (!lst)
+            continue;
+        for (Node *nd = list_first_node(lst); nd; nd = list_next_node(lst, nd))
         {
-            max_length = chain_length;
+            HashNode *hn = (HashNode *)list_node_data(nd);
+            HT_PREFETCH(list_next_node(lst, nd));
+            if (!visit(node_key(htc, hn), hn->key_size, hn->value, ctx))
+                return false;
         }
     }
-    hs.average_chain_length = n ? (double)sum_length / n : 0.0;
-    hs.max_chain_or_probe = max_length;
+    return true;
+}
 
-    return hs;
+static bool chaining_iter_next(void *impl, HashIter *it)
+{
+    HashTableChaining *htc = (HashTableChaining *)impl;
+    if (htc->old_buckets)
+        chaining_migrate(htc, SIZE_MAX);
+    // it->node is the next node of bucket pos - 1, NULL once that bucket is done
+    Node *nd = (Node *)it->node;
+    while (!nd)
+    {
+        if (it->pos >= htc->capacity)
+            return false;
+        DoublyCircularList *lst = bucket_slot(htc->buckets, it->pos++);
+        nd = lst ? list_first_node(lst) : NULL;
+    }
+    HashNode *hn = (HashNode *)list_node_data(nd);
+    it->node = list_next_node(bucket_slot(htc->buckets, it->pos - 1), nd);
+    it->key = node_key(htc, hn);
+    it->keysz = hn->key_size;
+    it->value = hn->value;
+    return true;
 }
 
 void chaining_destroy(void **pimpl)
 {
     if (!pimpl || !*pimpl) return;
     HashTableChaining *htc = (HashTableChaining*)(*pimpl);
-    if (!htc->buckets) {
-        free(htc);
-        *pimpl = NULL;
-        return;
-    }
-    HashKeyOps keyops = htc->keyops;
-    
-    for (size_t i = 0; i < htc->buckets->size; i++)
-    {
-        DoublyCircularList *lst = array_get_at(htc->buckets, i);
-        if (!lst) {
-            continue;
-        }
-        while (!list_is_empty(lst)) 
-        {
-            HashNode *hn = (HashNode*)list_pop_front(lst);
-            if (!hn) break;
-            if (keyops.destroy_key) keyops.destroy_key(hn->key); 
-            else if (hn->key) free(hn->key);
-            if (keyops.destroy_val) keyops.destroy_val(hn->value);
-            free(hn);
-        }
-        list_destroy((DoublyCircularList**)&(htc->buckets->data[i]));
-    }
-    array_destroy(&(htc->buckets));
+    buckets_destroy(htc, &htc->buckets, true);
+    buckets_destroy(htc, &htc->old_buckets, true);
+    keystore_destroy(&htc->keys);
+    pool_destroy(&htc->node_pool);
+    pool_destroy(&htc->link_pool);
     free(htc);
     *pimpl = NULL;
 }
@@ -300,6 +502,26 @@ HashTable *hashtable_chaining_create(
     size_t initial_capacity,
     double max_load_factor,
     HashKeyOps keyops)
+{
+    return hashtable_chaining_create_ex(initial_capacity, max_load_factor, keyops,
+                                        RESIZE_ALL_AT_ONCE);
+}
+
+HashTable *hashtable_chaining_create_ex(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops,
+    ResizeMode resize)
+{
+    return hashtable_chaining_create_alloc(initial_capacity, max_load_factor, keyops, resize, NULL);
+}
+
+HashTable *hashtable_chaining_create_alloc(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops,
+    ResizeMode resize,
+    const Allocator *alloc)
 {
     if (initial_capacity == 0)
         initial_capacity = 8;
@@ -310,26 +532,39 @@ HashTable *hashtable_chaining_create(
     impl->max_load_factor = max_load_factor;
     impl->capacity = initial_capacity;
     impl->size = 0;
+    impl->collision_count = 0;
+    keyops = ht_seed_keyops(keyops);
     impl->keyops = keyops;
+    keystore_init(&impl->keys, keyops.destroy_key);
+    impl->resize = resize;
+    impl->old_buckets = NULL;
+    impl->old_capacity = 0;
+    impl->migrate_pos = 0;
+    impl->min_capacity = initial_capacity; // a pre-sized table keeps its buckets
+    impl->lists = 0;
+    memset(impl->hist, 0, sizeof(impl->hist));
+    impl->hist[0] = initial_capacity;
+    impl->pos_sum = 0;
+    impl->max_chain = 0;
+    impl->resizes = 0;
+    pool_init(&impl->node_pool, sizeof(HashNode), 0);
+    pool_init(&impl->link_pool, list_node_size(), 0);
+    if (alloc && alloc->alloc)
+    {
+        impl->node_alloc = *alloc;
+        impl->link_alloc = *alloc;
+    }
+    else
+    {
+        impl->node_alloc = pool_allocator(&impl->node_pool);
+        impl->link_alloc = pool_allocator(&impl->link_pool);
+    }
 
-    impl->buckets = array_create(initial_capacity);
-    for (size_t i = 0; i < initial_capacity; i++)
+    impl->buckets = buckets_create(initial_capacity);
+    if (!impl->buckets)
     {
-        DoublyCircularList *lst = list_create(keyops.eq);
-        if (!lst)
-        {
-            for (size_t j = 0; j < i; j++)
-            {
-                DoublyCircularList *to_destroy = array_get_at(impl->buckets, j);
-                if (to_destroy) {
-                    list_destroy(&to_destroy);
-                }
-            }
-            array_destroy(&impl->buckets);
-            free(impl);
-            return NULL;
-        }
-        array_push_back(impl->buckets, lst);
+        free(impl);
+        return NULL;
     }
 
     HashOps ops = {
@@ -337,12 +572,16 @@ HashTable *hashtable_chaining_create(
         .search = chaining_search,
         .erase = chaining_erase,
         .update = chaining_update,
+        .reserve = chaining_reserve,
+        .shrink_to_fit = chaining_shrink_to_fit,
         .size = chaining_size,
         .capacity = chaining_capacity,
         .load_factor = chaining_load_factor,
         .stats = chaining_stats,
+        .foreach = chaining_foreach,
+        .iter_next = chaining_iter_next,
         .destroy = chaining_destroy,
     };
 
     return ht_create_from_impl(impl, ops, keyops);
-}
\ No newline at end of file
+}
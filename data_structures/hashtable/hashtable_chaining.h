@@ -1,6 +1,7 @@
 // hashtable_chaining.h
 #pragma once
 #include "hashtable.h"
+#include "../common/arena.h"
 
 /*
  * 链地址法（拉链法）哈希表
@@ -14,8 +15,8 @@ typedef struct HashTableChaining HashTableChaining;
 
 /**
  * 创建链地址法哈希表
- * @param initial_capacity 初始桶数（建议 >= 8）
- * @param max_load_factor  最大负载因子（常用 0.75）
+ * @param initial_capacity 初始桶数（建议 >= 8），同时是自动缩容的下限（见 hashtable_shrink_to_fit）
+ * @param max_load_factor  最大负载因子（常用 0.75）；删除后负载低于它的 1/4 时缩容
  * @param keyops           键相关回调（hash/eq/destroy）
  * @return 以统一接口 HashTable* 返回
  */
@@ -23,4 +24,35 @@ HashTable *hashtable_chaining_create(
     size_t initial_capacity,
     double max_load_factor,
     HashKeyOps keyops
-);
\ No newline at end of file
+);
+
+/**
+ * 创建链地址法哈希表，并指定扩容方式
+ * @param resize RESIZE_ALL_AT_ONCE：一次性把所有节点挂到新桶（hashtable_chaining_create 的行为）
+ *               RESIZE_INCREMENTAL：新旧桶数组并存，之后每次增删改查迁移若干个旧桶，
+ *               尚未迁移的键仍在旧桶中查找
+ * 其余参数同 hashtable_chaining_create
+ */
+HashTable *hashtable_chaining_create_ex(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops,
+    ResizeMode resize
+);
+
+
+/**
+ * 创建链地址法哈希表，并指定节点的分配器
+ * @param alloc NULL：哈希节点和链表节点分别来自表内的两个 slab 池（Pool），
+ *              插入/删除不再逐个 malloc/free，空出的节点留在池里复用，表销毁时整体释放
+ *              （hashtable_chaining_create / _create_ex 的行为）；
+ *              非 NULL：两种节点都从 alloc 分配，例如多张表共用一个 Arena，alloc 的内容被复制
+ * 其余参数同 hashtable_chaining_create_ex
+ */
+HashTable *hashtable_chaining_create_alloc(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops,
+    ResizeMode resize,
+    const Allocator *alloc
+);
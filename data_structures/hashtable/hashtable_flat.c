@@ -0,0 +1,543 @@
+// data_structures/hashtable/hashtable_flat.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "hashtable_flat.h"
+#include "hashtable_internal.h"
+
+#define FLAT_NIL UINT32_MAX
+#define FLAT_FREE UINT32_MAX // keysz of a node on the free list
+#define FLAT_MIN_CAPACITY 8
+
+typedef struct FlatNode
+{
+    size_t hash;   // cached full hash
+    HtKey key;     // short keys inline, longer ones in the table's KeyStore
+    void *value;
+    uint32_t keysz; // FLAT_FREE marks a node on the free list
+    uint32_t next; // next node in the chain (or in the free list)
+} FlatNode;
+
+typedef struct HashTableFlat
+{
+    uint32_t *heads;   // capacity bucket heads, FLAT_NIL when empty
+    FlatNode *nodes;   // node pool
+    size_t node_used;  // nodes[0, node_used) have been handed out
+    size_t node_cap;
+    uint32_t free_head;
+    size_t size;
+    size_t capacity;   // power of two
+    size_t mask;
+    double max_load_factor;
+    size_t collision_count;
+    size_t resizes;
+    HashKeyOps keyops;
+    KeyStore keys;
+} HashTableFlat;
+
+static inline const void *node_key(const HashTableFlat *htf, const FlatNode *fn)
+{
+    return keystore_get(&htf->keys, &fn->key, fn->keysz);
+}
+
+static size_t round_up_pow2(size_t n)
+{
+    size_t cap = FLAT_MIN_CAPACITY;
+    while (cap < n)
+        cap <<= 1;
+    return cap;
+}
+
+static uint32_t *alloc_heads(size_t capacity)
+{
+    uint32_t *heads = malloc(capacity * sizeof(uint32_t));
+    if (!heads)
+        return NULL;
+    // FLAT_NIL is all ones
+    memset(heads, 0xFF, capacity * sizeof(uint32_t));
+    return heads;
+}
+
+// rebuilds every chain into new_heads (already filled with FLAT_NIL) and takes them over; cannot fail
+static void flat_relink(HashTableFlat *htf, uint32_t *new_heads, size_t new_capacity)
+{
+    // nodes stay where they are; only the chains are rebuilt from cached hashes
+    size_t mask = new_capacity - 1;
+    htf->collision_count = 0;
+    for (size_t i = 0; i < htf->node_used; i++)
+    {
+        FlatNode *fn = &htf->nodes[i];
+        if (fn->keysz == FLAT_FREE)
+            continue;
+        size_t b = fn->hash & mask;
+        if (new_heads[b] != FLAT_NIL)
+            htf->collision_count++;
+        fn->next = new_heads[b];
+        new_heads[b] = (uint32_t)i;
+    }
+
+    free(htf->heads);
+    htf->heads = new_heads;
+    htf->capacity = new_capacity;
+    htf->mask = mask;
+    htf->resizes++;
+}
+
+static bool flat_rehash(HashTableFlat *htf, size_t new_capacity)
+{
+    uint32_t *new_heads = alloc_heads(new_capacity);
+    if (!new_heads)
+        return false;
+    flat_relink(htf, new_heads, new_capacity);
+    return true;
+}
+
+static uint32_t alloc_node(HashTableFlat *htf)
+{
+    if (htf->free_head != FLAT_NIL)
+    {
+        uint32_t idx = htf->free_head;
+        htf->free_head = htf->nodes[idx].next;
+        return idx;
+    }
+    if (htf->node_used == htf->node_cap)
+    {
+        size_t new_cap = htf->node_cap ? htf->node_cap * 2 : FLAT_MIN_CAPACITY;
+        if (new_cap > FLAT_NIL)
+            new_cap = FLAT_NIL; // FLAT_NIL itself is never a valid index
+        if (new_cap <= htf->node_cap)
+            return FLAT_NIL;
+        FlatNode *new_nodes = realloc(htf->nodes, new_cap * sizeof(FlatNode));
+        if (!new_nodes)
+            return FLAT_NIL;
+        htf->nodes = new_nodes;
+        htf->node_cap = new_cap;
+    }
+    return (uint32_t)htf->node_used++;
+}
+
+/* 预留共 n 个元素：桶数组一次 rehash 到位，节点池一次分配够 n 个节点 */
+static bool flat_reserve(void *impl, size_t n)
+{
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    if (n >= FLAT_NIL)
+        return false;
+    if (n > htf->node_cap)
+    {
+        FlatNode *new_nodes = realloc(htf->nodes, n * sizeof(FlatNode));
+        if (!new_nodes)
+            return false;
+        htf->nodes = new_nodes;
+        htf->node_cap = n;
+    }
+    size_t cap = htf->capacity;
+    while ((double)n > htf->max_load_factor * cap && cap <= SIZE_MAX / 2)
+        cap <<= 1;
+    return cap == htf->capacity || flat_rehash(htf, cap);
+}
+
+/* 把存活节点压到节点池前部并截掉其余部分，桶数组换成装下当前元素的最小容量 */
+static bool flat_shrink_to_fit(void *impl)
+{
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    size_t cap = FLAT_MIN_CAPACITY;
+    while ((double)htf->size > htf->max_load_factor * cap && cap <= SIZE_MAX / 2)
+        cap <<= 1;
+    if (cap > htf->capacity)
+        cap = htf->capacity;
+    // compaction moves nodes, so the new heads must exist before anything is touched
+    uint32_t *new_heads = alloc_heads(cap);
+    if (!new_heads)
+        return false;
+
+    size_t live = 0;
+    for (size_t i = 0; i < htf->node_used; i++)
+    {
+        if (htf->nodes[i].keysz == FLAT_FREE)
+            continue;
+        if (live != i)
+            htf->nodes[live] = htf->nodes[i];
+        live++;
+    }
+    htf->node_used = live;
+    htf->free_head = FLAT_NIL;
+    size_t node_cap = live < FLAT_MIN_CAPACITY ? FLAT_MIN_CAPACITY : live;
+    if (node_cap < htf->node_cap)
+    {
+        FlatNode *new_nodes = realloc(htf->nodes, node_cap * sizeof(FlatNode));
+        if (new_nodes) // keeping the larger block is harmless
+        {
+            htf->nodes = new_nodes;
+            htf->node_cap = node_cap;
+        }
+    }
+
+    // the chains point at the old node positions, so they are rebuilt either way
+    flat_relink(htf, new_heads, cap);
+    return true;
+}
+
+static inline void free_node(HashTableFlat *htf, uint32_t idx)
+{
+    FlatNode *fn = &htf->nodes[idx];
+    fn->value = NULL;
+    fn->keysz = FLAT_FREE;
+    fn->next = htf->free_head;
+    htf->free_head = idx;
+}
+
+/* 返回指向“指向目标节点的下标”的指针（链首或前驱的 next），找不到时 *link == FLAT_NIL */
+static uint32_t *find_link(HashTableFlat *htf, const void *key, size_t hash)
+{
+    uint32_t *link = &htf->heads[hash & htf->mask];
+    while (*link != FLAT_NIL)
+    {
+        FlatNode *fn = &htf->nodes[*link];
+        if (fn->hash == hash && htf->keyops.eq(key, node_key(htf, fn)) == 0)
+            return link;
+        link = &fn->next;
+    }
+    return link;
+}
+
+static bool flat_insert_hashed(HashTableFlat *htf, const void *key, size_t keysz,
+                               size_t hash, void *value)
+{
+    if (keysz >= FLAT_FREE)
+        return false;
+
+    uint32_t *link = find_link(htf, key, hash);
+    if (*link != FLAT_NIL)
+    {
+        FlatNode *fn = &htf->nodes[*link];
+        if (htf->keyops.destroy_val && fn->value && fn->value != value)
+            htf->keyops.destroy_val(fn->value);
+        fn->value = value;
+        return true;
+    }
+
+    // alloc_node may move the pool, so the link pointer is not reused past this point
+    uint32_t idx = alloc_node(htf);
+    if (idx == FLAT_NIL)
+        return false;
+    FlatNode *fn = &htf->nodes[idx];
+    if (!keystore_put(&htf->keys, &fn->key, key, keysz))
+    {
+        free_node(htf, idx);
+        return false;
+    }
+
+    size_t b = hash & htf->mask;
+    fn->hash = hash;
+    fn->value = value;
+    fn->keysz = (uint32_t)keysz;
+    fn->next = htf->heads[b];
+    if (htf->heads[b] != FLAT_NIL)
+        htf->collision_count++;
+    htf->heads[b] = idx;
+    htf->size++;
+
+    if ((double)htf->size / (double)htf->capacity > htf->max_load_factor)
+        flat_rehash(htf, htf->capacity << 1);
+    return true;
+}
+
+static bool flat_insert(void *impl, const void *key, size_t keysz, void *value)
+{
+    if (!impl)
+        return false;
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    return flat_insert_hashed(htf, key, keysz, ht_hash(&htf->keyops, key, keysz), value);
+}
+
+static void flat_hash_prefetch(HashTableFlat *htf, const void **keys, const size_t *keyszs,
+                               size_t m, size_t *hashes)
+{
+    for (size_t i = 0; i < m; i++)
+    {
+        hashes[i] = ht_hash(&htf->keyops, keys[i], keyszs[i]);
+        HT_PREFETCH(&htf->heads[hashes[i] & htf->mask]);
+    }
+}
+
+/*
+ * 批量查找分三轮：算哈希并预取桶头 → 读桶头并预取链首节点 → 沿链比较
+ * 每一轮发出的访存彼此独立，可以同时在途
+ */
+static size_t flat_search_batch(void *impl, const void **keys, const size_t *keyszs,
+                                size_t n, void **out)
+{
+    if (!impl)
+        return 0;
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    size_t hashes[HT_BATCH];
+    uint32_t heads[HT_BATCH];
+    size_t found = 0;
+    for (size_t base = 0; base < n; base += HT_BATCH)
+    {
+        size_t m = n - base < HT_BATCH ? n - base : HT_BATCH;
+        flat_hash_prefetch(htf, keys + base, keyszs + base, m, hashes);
+        for (size_t i = 0; i < m; i++)
+        {
+            heads[i] = htf->heads[hashes[i] & htf->mask];
+            if (heads[i] != FLAT_NIL)
+                HT_PREFETCH(&htf->nodes[heads[i]]);
+        }
+        for (size_t i = 0; i < m; i++)
+        {
+            void *value = NULL;
+            for (uint32_t idx = heads[i]; idx != FLAT_NIL; idx = htf->nodes[idx].next)
+            {
+                FlatNode *fn = &htf->nodes[idx];
+                if (fn->hash == hashes[i] &&
+                    htf->keyops.eq(keys[base + i], node_key(htf, fn)) == 0)
+                {
+                    value = fn->value;
+                    found++;
+                    break;
+                }
+            }
+            out[base + i] = value;
+        }
+    }
+    return found;
+}
+
+static size_t flat_insert_batch(void *impl, const void **keys, const size_t *keyszs,
+                                void **vals, size_t n)
+{
+    if (!impl)
+        return 0;
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    size_t hashes[HT_BATCH];
+    size_t inserted = 0;
+    for (size_t base = 0; base < n; base += HT_BATCH)
+    {
+        size_t m = n - base < HT_BATCH ? n - base : HT_BATCH;
+        flat_hash_prefetch(htf, keys + base, keyszs + base, m, hashes);
+        for (size_t i = 0; i < m; i++)
+            inserted += flat_insert_hashed(htf, keys[base + i], keyszs[base + i], hashes[i],
+                                           vals[base + i]);
+    }
+    return inserted;
+}
+
+static void *flat_search(void *impl, const void *key, size_t keysz)
+{
+    if (!impl)
+        return NULL;
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    size_t hash = ht_hash(&htf->keyops, key, keysz);
+    uint32_t idx = htf->heads[hash & htf->mask];
+    while (idx != FLAT_NIL)
+    {
+        FlatNode *fn = &htf->nodes[idx];
+        if (fn->hash == hash && htf->keyops.eq(key, node_key(htf, fn)) == 0)
+            return fn->value;
+        idx = fn->next;
+    }
+    return NULL;
+}
+
+static bool flat_erase(void *impl, const void *key, size_t keysz)
+{
+    if (!impl)
+        return false;
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    HashKeyOps keyops = htf->keyops;
+
+    uint32_t *link = find_link(htf, key, ht_hash(&keyops, key, keysz));
+    if (*link == FLAT_NIL)
+        return false;
+    uint32_t idx = *link;
+    FlatNode *fn = &htf->nodes[idx];
+
+    keystore_release(&htf->keys, &fn->key, fn->keysz);
+    if (keyops.destroy_val)
+        keyops.destroy_val(fn->value);
+
+    *link = fn->next; // unlink
+    free_node(htf, idx);
+    htf->size--;
+    return true;
+}
+
+static bool flat_update(void *impl, const void *key, size_t keysz, void *new_value)
+{
+    if (!impl)
+        return false;
+    HashTableFlat *htf = (HashTableFlat *)impl;
+
+    uint32_t *link = find_link(htf, key, ht_hash(&htf->keyops, key, keysz));
+    if (*link == FLAT_NIL)
+        return false;
+    FlatNode *fn = &htf->nodes[*link];
+    if (fn->value == new_value)
+        return true;
+    if (htf->keyops.destroy_val && fn->value)
+        htf->keyops.destroy_val(fn->value);
+    fn->value = new_value;
+    return true;
+}
+
+static size_t flat_size(const void *impl)
+{
+    if (!impl) return 0;
+    return ((const HashTableFlat *)impl)->size;
+}
+
+static size_t flat_capacity(const void *impl)
+{
+    if (!impl) return 0;
+    return ((const HashTableFlat *)impl)->capacity;
+}
+
+static double flat_load_factor(const void *impl)
+{
+    if (!impl) return -1.;
+    const HashTableFlat *htf = (const HashTableFlat *)impl;
+    return (double)htf->size / htf->capacity;
+}
+
+static HashStats flat_stats(const void *impl)
+{
+    const HashTableFlat *htf = (const HashTableFlat *)impl;
+    HashStats hs = {0};
+
+    hs.total_elements = htf->size;
+    hs.collision_count = htf->collision_count;
+
+    size_t max_length = 0;
+    size_t pos_sum = 0;
+    for (size_t b = 0; b < htf->capacity; b++)
+    {
+        size_t chain_length = 0;
+        for (uint32_t idx = htf->heads[b]; idx != FLAT_NIL; idx = htf->nodes[idx].next)
+            chain_length++;
+        if (chain_length)
+            hs.used_buckets++;
+        if (max_length < chain_length)
+            max_length = chain_length;
+        hs.histogram[ht_hist_bin(chain_length)]++;
+        pos_sum += chain_length * (chain_length + 1) / 2;
+    }
+    hs.max_chain_or_probe = max_length;
+    hs.average_chain_length = htf->capacity ? (double)htf->size / htf->capacity : 0.0;
+    hs.avg_probe_success = htf->size ? (double)pos_sum / htf->size : 0.0;
+    hs.avg_probe_failure = hs.average_chain_length;
+    hs.resize_count = htf->resizes;
+    hs.bytes_used = sizeof(HashTableFlat) + htf->capacity * sizeof(uint32_t)
+                  + htf->node_cap * sizeof(FlatNode) + htf->keys.bytes;
+    return hs;
+}
+
+static bool flat_foreach(void *impl, hashtable_visit_t visit, void *ctx)
+{
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    // the node pool is dense: walk it instead of the bucket chains
+    for (size_t i = 0; i < htf->node_used; i++)
+    {
+        const FlatNode *fn = &htf->nodes[i];
+        if (fn->keysz != FLAT_FREE && !visit(node_key(htf, fn), fn->keysz, fn->value, ctx))
+            return false;
+    }
+    return true;
+}
+
+static bool flat_iter_next(void *impl, HashIter *it)
+{
+    HashTableFlat *htf = (HashTableFlat *)impl;
+    for (size_t i = it->pos; i < htf->node_used; i++)
+    {
+        const FlatNode *fn = &htf->nodes[i];
+        if (fn->keysz == FLAT_FREE)
+            continue;
+        it->pos = i + 1;
+        it->key = node_key(htf, fn);
+        it->keysz = fn->keysz;
+        it->value = fn->value;
+        return true;
+    }
+    it->pos = htf->node_used;
+    return false;
+}
+
+static void flat_destroy(void **pimpl)
+{
+    if (!pimpl || !*pimpl) return;
+    HashTableFlat *htf = (HashTableFlat *)(*pimpl);
+    HashKeyOps keyops = htf->keyops;
+
+    for (size_t i = 0; i < htf->node_used; i++)
+    {
+        FlatNode *fn = &htf->nodes[i];
+        if (fn->keysz == FLAT_FREE)
+            continue;
+        keystore_release(&htf->keys, &fn->key, fn->keysz);
+        if (keyops.destroy_val) keyops.destroy_val(fn->value);
+    }
+    keystore_destroy(&htf->keys);
+    free(htf->nodes);
+    free(htf->heads);
+    free(htf);
+    *pimpl = NULL;
+}
+
+HashTable *hashtable_flat_create(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops)
+{
+    HashTableFlat *impl = malloc(sizeof(HashTableFlat));
+    if (!impl)
+        return NULL;
+
+    impl->capacity = round_up_pow2(initial_capacity);
+    impl->mask = impl->capacity - 1;
+    impl->heads = alloc_heads(impl->capacity);
+    if (!impl->heads)
+    {
+        free(impl);
+        return NULL;
+    }
+    impl->nodes = NULL;
+    impl->node_used = 0;
+    impl->node_cap = 0;
+    impl->free_head = FLAT_NIL;
+    impl->size = 0;
+    impl->max_load_factor = max_load_factor <= 0 ? 1.0 : max_load_factor;
+    impl->collision_count = 0;
+    impl->resizes = 0;
+    keyops = ht_seed_keyops(keyops);
+    impl->keyops = keyops;
+    keystore_init(&impl->keys, keyops.destroy_key);
+
+    HashOps ops = {
+        .insert = flat_insert,
+        .search = flat_search,
+        .erase = flat_erase,
+        .update = flat_update,
+        .search_batch = flat_search_batch,
+        .insert_batch = flat_insert_batch,
+        .reserve = flat_reserve,
+        .shrink_to_fit = flat_shrink_to_fit,
+        .size = flat_size,
+        .capacity = flat_capacity,
+        .load_factor = flat_load_factor,
+        .stats = flat_stats,
+        .foreach = flat_foreach,
+        .iter_next = flat_iter_next,
+        .destroy = flat_destroy,
+    };
+
+    HashTable *ht = ht_create_from_impl(impl, ops, keyops);
+    if (!ht)
+    {
+        free(impl->heads);
+        free(impl);
+    }
+    return ht;
+}
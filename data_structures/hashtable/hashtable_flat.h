@@ -0,0 +1,27 @@
+// hashtable_flat.h
+#pragma once
+#include "hashtable.h"
+
+/*
+ * 扁平链地址法哈希表（cache 友好）
+ * - heads: 连续的 uint32_t 数组，每个桶只存链首节点在节点池中的下标
+ * - nodes: 单一的节点池（连续内存），节点通过 next 下标串成链
+ * - 节点缓存完整哈希值：比较时先比哈希再调用 eq，扩容时无需重新计算哈希
+ * - 删除的节点挂到空闲链表上复用；扩容只重建 heads，节点本身不移动
+ * - 容量始终为 2 的幂，桶下标用掩码计算
+ */
+
+typedef struct HashTableFlat HashTableFlat;
+
+/**
+ * 创建扁平链地址法哈希表
+ * @param initial_capacity 初始桶数（向上取整到 2 的幂，最小 8）
+ * @param max_load_factor  最大负载因子（常用 0.75~1.0）；<= 0 时取 1.0
+ * @param keyops           键相关回调（hash/eq/destroy）
+ * @return 以统一接口 HashTable* 返回
+ */
+HashTable *hashtable_flat_create(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops
+);
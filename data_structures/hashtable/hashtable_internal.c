@@ -1,4 +1,7 @@
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "hashtable_internal.h"
 
 HashTable *ht_create_from_impl(void *impl, HashOps ops, HashKeyOps kops)
@@ -12,4 +15,162 @@ HashTable *ht_create_from_impl(void *impl, HashOps ops, HashKeyOps kops)
     ht->ops = ops;
     ht->kops = kops;
     return ht;
-}
\ No newline at end of file
+}
+
+static uint64_t seed_state = 0;
+
+static uint64_t seed_entropy(void)
+{
+    uint64_t v = 0;
+    FILE *f = fopen("/dev/urandom", "rb");
+    if (f)
+    {
+        if (fread(&v, sizeof v, 1, f) != 1)
+            v = 0;
+        fclose(f);
+    }
+    // no /dev/urandom: time and ASLR-dependent addresses are weaker but still per-process
+    if (v == 0)
+        v = (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)&v ^ ((uint64_t)(uintptr_t)&seed_state << 32);
+    return v | 1; // nonzero marks the state as initialized
+}
+
+uint64_t ht_random_seed(void)
+{
+    uint64_t s = __atomic_load_n(&seed_state, __ATOMIC_RELAXED);
+    if (s == 0)
+    {
+        uint64_t fresh = seed_entropy();
+        __atomic_compare_exchange_n(&seed_state, &s, fresh, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+    // splitmix64: consecutive states give independent-looking outputs
+    uint64_t z = __atomic_add_fetch(&seed_state, 0x9E3779B97F4A7C15ull, __ATOMIC_RELAXED);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return z ? z : 1; // 0 would mean "pick a seed" again
+}
+
+#define KEY_ARENA_CHUNK_SIZE (64 * 1024)
+
+struct KeyArenaChunk
+{
+    KeyArenaChunk *next;
+    size_t used;
+    size_t cap;
+    unsigned char data[];
+};
+
+static inline size_t key_class(size_t keysz)
+{
+    return keysz ? (keysz - 1) / KEY_ARENA_CLASS_SIZE : 0;
+}
+
+static void *key_arena_alloc(KeyStore *ks, size_t keysz)
+{
+    KeyArena *a = &ks->arena;
+    size_t cls = key_class(keysz);
+    if (cls >= KEY_ARENA_NUM_CLASSES)
+    {
+        void *p = malloc(keysz);
+        if (p)
+            ks->bytes += keysz;
+        return p;
+    }
+
+    if (a->free_lists[cls])
+    {
+        void *p = a->free_lists[cls];
+        a->free_lists[cls] = *(void **)p;
+        return p;
+    }
+
+    size_t bytes = (cls + 1) * KEY_ARENA_CLASS_SIZE;
+    KeyArenaChunk *c = a->chunks;
+    if (!c || c->cap - c->used < bytes)
+    {
+        c = malloc(sizeof(KeyArenaChunk) + KEY_ARENA_CHUNK_SIZE);
+        if (!c)
+            return NULL;
+        c->next = a->chunks;
+        c->used = 0;
+        c->cap = KEY_ARENA_CHUNK_SIZE;
+        a->chunks = c;
+        ks->bytes += sizeof(KeyArenaChunk) + KEY_ARENA_CHUNK_SIZE;
+    }
+    void *p = c->data + c->used;
+    c->used += bytes;
+    return p;
+}
+
+static void key_arena_free(KeyStore *ks, void *p, size_t keysz)
+{
+    KeyArena *a = &ks->arena;
+    size_t cls = key_class(keysz);
+    if (cls >= KEY_ARENA_NUM_CLASSES)
+    {
+        free(p);
+        ks->bytes -= keysz;
+        return;
+    }
+    *(void **)p = a->free_lists[cls];
+    a->free_lists[cls] = p;
+}
+
+void keystore_init(KeyStore *ks, key_destroy_t destroy_key)
+{
+    memset(&ks->arena, 0, sizeof(ks->arena));
+    ks->destroy_key = destroy_key;
+    ks->bytes = 0;
+}
+
+bool keystore_put(KeyStore *ks, HtKey *dst, const void *key, size_t keysz)
+{
+    if (keystore_is_inline(ks, keysz))
+    {
+        memcpy(dst->bytes, key, keysz);
+        return true;
+    }
+    void *p;
+    if (ks->destroy_key)
+    {
+        p = malloc(keysz ? keysz : 1);
+        if (p)
+            ks->bytes += keysz;
+    }
+    else
+    {
+        p = key_arena_alloc(ks, keysz);
+    }
+    if (!p)
+        return false;
+    memcpy(p, key, keysz);
+    dst->ptr = p;
+    return true;
+}
+
+void keystore_release(KeyStore *ks, HtKey *k, size_t keysz)
+{
+    if (ks->destroy_key)
+    {
+        ks->destroy_key(k->ptr);
+        ks->bytes -= keysz;
+    }
+    else if (!keystore_is_inline(ks, keysz))
+    {
+        key_arena_free(ks, k->ptr, keysz);
+    }
+}
+
+void keystore_destroy(KeyStore *ks)
+{
+    KeyArenaChunk *c = ks->arena.chunks;
+    while (c)
+    {
+        KeyArenaChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    memset(&ks->arena, 0, sizeof(ks->arena));
+    ks->bytes = 0;
+}
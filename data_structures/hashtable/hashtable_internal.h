@@ -1,30 +1,169 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 typedef size_t (*hash_func_t)(const void *key, size_t keysz);
+typedef size_t (*hash_seeded_func_t)(const void *key, size_t keysz, uint64_t seed);
 typedef int (*key_compare_t)(const void *k1, const void *k2);
 typedef void (*key_destroy_t)(void *key);
 typedef void (*value_destroy_t)(void *value);
 
+/*
+ * 键操作
+ * - hash_seeded 非 NULL 时优先于 hash：表用 hash_seeded(key, keysz, seed) 计算哈希
+ *   seed 为 0 时建表会换成随机种子，每张表各不相同，攻击者无法预先构造出全部冲突的键；
+ *   需要可复现的结果时传入非 0 的固定种子
+ * - 只设置 hash 时行为与以前一致
+ */
 typedef struct
 {
     hash_func_t hash;
     key_compare_t eq;
     key_destroy_t destroy_key;
     value_destroy_t destroy_val;
+    hash_seeded_func_t hash_seeded;
+    uint64_t seed;
 } HashKeyOps;
 
+/* 表内计算键哈希的唯一入口 */
+static inline size_t ht_hash(const HashKeyOps *k, const void *key, size_t keysz)
+{
+    return k->hash_seeded ? k->hash_seeded(key, keysz, k->seed) : k->hash(key, keysz);
+}
+
+/* 每次调用返回一个不同的随机 64 位种子（/dev/urandom 初始化，之后 splitmix64），线程安全 */
+uint64_t ht_random_seed(void);
+
+/* 建表时调用：设置了 hash_seeded 且 seed 为 0 时填入随机种子 */
+static inline HashKeyOps ht_seed_keyops(HashKeyOps k)
+{
+    if (k.hash_seeded && k.seed == 0)
+        k.seed = ht_random_seed();
+    return k;
+}
+
+/* 扩容方式：一次性 rehash，或新旧表并存、每次操作搬迁一部分的渐进式 rehash */
+typedef enum
+{
+    RESIZE_ALL_AT_ONCE = 0,
+    RESIZE_INCREMENTAL = 1
+} ResizeMode;
+
+/* 直方图的格数；最后一格统计所有 >= HT_HIST_BUCKETS - 1 的长度 */
+#define HT_HIST_BUCKETS 16
+
+/*
+ * 统计信息；OA 与链地址法在增删时增量维护，读取为 O(1)
+ * 探测长度均以“检查的槽位/节点个数”计，命中初始槽位为 1
+ */
 typedef struct
 {
     size_t total_elements;       /* 表中元素个数 */
     size_t used_buckets;         /* 被占用的桶数（开放寻址为非空槽位） */
-    size_t max_chain_or_probe;   /* 链地址：最大链长；开放寻址：最大探测长度 */
+    size_t max_chain_or_probe;   /* 链地址：最大链长；开放寻址：最大探测长度（自上次 rehash 起的最大值） */
     double average_chain_length; /* 链地址：平均链长；开放寻址：可置 0 或平均探测 */
     size_t collision_count;      /* 累计冲突次数 */
+
+    /* 链地址：histogram[i] 为长度为 i 的桶数；开放寻址：探测长度为 i 的元素数 */
+    size_t histogram[HT_HIST_BUCKETS];
+    size_t tombstones;           /* 墓碑（已删除）槽位数 */
+    double avg_probe_success;    /* 查找已有键的平均探测长度 */
+    double avg_probe_failure;    /* 查找不存在的键的平均探测长度（开放寻址按实际未命中的查找统计） */
+    size_t resize_count;         /* 扩容/缩容（rehash）次数 */
+    size_t bytes_used;           /* 表结构 + 表内保存的键占用的字节数（不含值） */
 } HashStats;
 
+static inline size_t ht_hist_bin(size_t len)
+{
+    return len < HT_HIST_BUCKETS - 1 ? len : HT_HIST_BUCKETS - 1;
+}
+
+/*
+ * 表内保存的键拷贝（HtKey + 键长）
+ * - 不超过 HT_INLINE_KEY_SIZE 字节的键直接存在槽位/节点里：插入不 malloc，比较不跳指针
+ *   （int、短字符串等走 hashtable_insert_int/_string 的键都落在这里）
+ * - 更大的键放进每张表自己的 KeyArena：按 16 字节分级，删除的块挂回空闲链表复用
+ * - 设置了 keyops.destroy_key 时所有键仍单独 malloc，destroy_key 拿到的总是可释放的指针
+ * HT_INLINE_KEY_SIZE 可在编译时用 -D 修改（不小于指针大小）
+ */
+#ifndef HT_INLINE_KEY_SIZE
+#define HT_INLINE_KEY_SIZE 16
+#endif
+
+typedef union HtKey
+{
+    void *ptr;
+    unsigned char bytes[HT_INLINE_KEY_SIZE];
+} HtKey;
+
+#define KEY_ARENA_CLASS_SIZE 16
+#define KEY_ARENA_NUM_CLASSES 16 /* 超过 16 * 16 = 256 字节的键直接 malloc */
+
+typedef struct KeyArenaChunk KeyArenaChunk;
+
+typedef struct
+{
+    KeyArenaChunk *chunks;
+    void *free_lists[KEY_ARENA_NUM_CLASSES];
+} KeyArena;
+
+typedef struct
+{
+    KeyArena arena;
+    key_destroy_t destroy_key;
+    size_t bytes; /* 不在槽位内的键占用的字节数（arena 块 + 单独分配的键） */
+} KeyStore;
+
+void keystore_init(KeyStore *ks, key_destroy_t destroy_key);
+/* 把 key 拷贝进 dst（内联或 arena/堆），失败返回 false */
+bool keystore_put(KeyStore *ks, HtKey *dst, const void *key, size_t keysz);
+/* 释放 keystore_put 保存的键（必要时调用 destroy_key） */
+void keystore_release(KeyStore *ks, HtKey *k, size_t keysz);
+/* 释放 arena 的全部内存；调用前应先对表中所有键调用 keystore_release */
+void keystore_destroy(KeyStore *ks);
+
+static inline bool keystore_is_inline(const KeyStore *ks, size_t keysz)
+{
+    return !ks->destroy_key && keysz <= HT_INLINE_KEY_SIZE;
+}
+
+/* 取得键的地址，传给 keyops.eq / keyops.hash */
+static inline const void *keystore_get(const KeyStore *ks, const HtKey *k, size_t keysz)
+{
+    return keystore_is_inline(ks, keysz) ? (const void *)k->bytes : k->ptr;
+}
+
+/*
+ * 批量操作每轮处理的键数：先算完这一轮所有键的哈希并预取各自的初始槽位，
+ * 再逐个解析，多个独立查找的内存延迟得以重叠
+ */
+#define HT_BATCH 16
+
+#if defined(__GNUC__)
+#define HT_PREFETCH(addr) __builtin_prefetch((addr))
+#else
+#define HT_PREFETCH(addr) ((void)(addr))
+#endif
+
+/* 遍历回调：key/keysz 为表内保存的键，返回 false 时停止遍历 */
+typedef bool (*hashtable_visit_t)(const void *key, size_t keysz, void *value, void *ctx);
+
+/*
+ * 遍历游标（hashtable_iter_begin / hashtable_iter_next）
+ * pos/node/shard 由各后端解释；每次 next 成功后 key/keysz/value 为当前元素
+ */
+typedef struct HashIter
+{
+    size_t pos;   /* 下一个要检查的槽位/桶 */
+    void *node;   /* 链地址法：当前桶里下一个链表节点 */
+    size_t shard; /* 分片表：当前分片 */
+    const void *key;
+    size_t keysz;
+    void *value;
+} HashIter;
+
 typedef struct
 {
     bool (*insert)(void *impl, const void *key, size_t keysz, void *val);
@@ -32,11 +171,29 @@ typedef struct
     bool (*erase)(void *impl, const void *key, size_t keysz);
     bool (*update)(void *impl, const void *key, size_t keysz, void *new_val);
 
+    /* 批量接口，可为 NULL（由 hashtable.c 逐个调用 search/insert） */
+    size_t (*search_batch)(void *impl, const void **keys, const size_t *keyszs, size_t n,
+                           void **out);
+    size_t (*insert_batch)(void *impl, const void **keys, const size_t *keyszs,
+                           void **vals, size_t n);
+
+    /* 预留空间：一次调整到能容纳共 n 个元素的容量，之后插入到 n 个都不再扩容；可为 NULL */
+    bool (*reserve)(void *impl, size_t n);
+    /* 批量建表，可为 NULL（由 hashtable.c 用 reserve + insert_batch 完成） */
+    size_t (*build)(void *impl, const void **keys, const size_t *keyszs, void **vals, size_t n);
+    /* 清除 reserve / 初始容量留下的下限，把容量缩到恰好装下当前元素；可为 NULL */
+    bool (*shrink_to_fit)(void *impl);
+
     size_t (*size)(const void *impl);
     size_t (*capacity)(const void *impl);
     double (*load_factor)(const void *impl);
     HashStats (*stats)(const void *impl);
 
+    /* 按存储顺序访问每个元素各一次，回调中不能修改表；visit 返回 false 时停止并返回 false */
+    bool (*foreach)(void *impl, hashtable_visit_t visit, void *ctx);
+    /* 把 it 推进到下一个元素；没有更多元素时返回 false */
+    bool (*iter_next)(void *impl, HashIter *it);
+
     void (*destroy)(void **impl);
 } HashOps;
 
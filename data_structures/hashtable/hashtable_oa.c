@@ -16,12 +16,25 @@ typedef enum
 
 typedef struct HashNode
 {
-    void *key;
+    HtKey key;   // short keys inline, longer ones in the table's KeyStore
     void *value;
     size_t keysz;
+    size_t hash; // cached h1(key): checked before eq, reused by rehash
     SlotState state;
+    uint32_t dist; // probe steps from the home slot (fits in the padding)
 } HashNode;
 
+/* 增量维护的统计；探测长度 = dist + 1 */
+typedef struct
+{
+    size_t hist[HT_HIST_BUCKETS]; // elements per probe length
+    size_t dist_sum;              // sum of dist over all elements
+    size_t max_probe;             // since the last rehash
+    size_t misses;                // lookups (incl. inserts of new keys) that found nothing
+    size_t miss_probes;           // slots inspected by those lookups
+    size_t resizes;
+} OAStats;
+
 typedef struct HashTableOA
 {
     HashNode *table;
@@ -30,100 +43,261 @@ typedef struct HashTableOA
     size_t tombstones;
     double max_load_factor;
     ProbeStrategy probe;
-    hash_func_t h1;
     hash_func_t h2;
     HashKeyOps keyops;
+    KeyStore keys;
+    ResizeMode resize;
+    HashNode *old_table; // RESIZE_INCREMENTAL: table being drained, NULL otherwise
+    size_t old_capacity;
+    size_t old_size;     // live entries still in old_table
+    size_t migrate_pos;  // old_table[0, migrate_pos) has been moved
+    OAStats stats;
 } HashTableOA;
 
-static inline size_t gcd_size(size_t a, size_t b) {
-    while (b) { size_t t = a % b; a = b; b = t; }
-    return a;
-}
+/* 插入位置：新表中的空槽/墓碑及其探测步数 */
+typedef struct
+{
+    size_t slot; // SIZE_MAX when the table is full
+    size_t dist;
+} InsertPos;
+
+// slots of old_table moved per operation while an incremental resize is running
+#define OA_MIGRATE_SLOTS 16
 
 static size_t next_capacity(size_t cur)
 {
     return cur ? (cur << 1) : 8; // minimum capacity 8
 }
 
-static size_t prev_capacity(size_t cur)
+static size_t round_up_pow2(size_t n)
 {
-    return (cur > 8) ? (cur >> 1) : 8;
+    size_t cap = 1;
+    while (cap < n)
+        cap <<= 1;
+    return cap;
 }
 
-static size_t next_idx(HashTableOA *htoa, size_t start, size_t step, size_t h2)
+/*
+ * 探测序列的增量（capacity 为 2 的幂，下一槽位 = (idx + 增量) & mask）
+ * - 线性：每步 +1
+ * - 二次：第 i 步 +i，即三角数偏移 i(i+1)/2，在 2 的幂容量下保证遍历所有槽位
+ * - 双散列：固定奇数步长 dh_step（与 2 的幂互素），每次查找只算一次
+ */
+static inline size_t probe_inc(const HashTableOA *htoa, size_t step, size_t dh_step)
 {
-    size_t cap = htoa->capacity;
-    if (htoa->probe == PROBE_LINEAR)
+    switch (htoa->probe)
     {
-        return (start % cap + step % cap) % cap;
+    case PROBE_QUADRATIC:
+        return step;
+    case PROBE_DOUBLEHASH:
+        return dh_step;
+    default:
+        return 1;
     }
-    else if (htoa->probe == PROBE_QUADRATIC)
-    {
-        size_t s = step % cap;
-        return (start + (s * s) % cap) % cap;
-    }
-    else
+}
+
+static inline void stats_add(HashTableOA *htoa, size_t dist)
+{
+    OAStats *st = &htoa->stats;
+    st->hist[ht_hist_bin(dist + 1)]++;
+    st->dist_sum += dist;
+    if (dist + 1 > st->max_probe)
+        st->max_probe = dist + 1;
+}
+
+static inline void stats_remove(HashTableOA *htoa, size_t dist)
+{
+    OAStats *st = &htoa->stats;
+    st->hist[ht_hist_bin(dist + 1)]--;
+    st->dist_sum -= dist;
+}
+
+/*
+ * Robin Hood 查找（线性探测）：槽位按到各自初始位置的距离有序排列，
+ * 遇到空槽，或遇到距离比当前探测距离更小的键（更“富”）即可确定 key 不存在
+ * 增量扩容期间旧表里会有迁移留下的墓碑，直接跳过
+ */
+static size_t rh_find(const HashTableOA *htoa, const HashNode *table, size_t capacity,
+                      const void *key, size_t hash, size_t *probes)
+{
+    size_t mask = capacity - 1;
+    size_t idx = hash & mask;
+    *probes = capacity;
+    for (size_t dist = 0; dist < capacity; dist++)
     {
-        // PROBE_DOUBLEHASH
-        if (!h2)
+        const HashNode *hn = &table[idx];
+        *probes = dist + 1;
+        if (hn->state == SLOT_EMPTY)
             return SIZE_MAX;
-        if (cap < 2) return SIZE_MAX;
-        start %= cap;
-
-        // 先得到一个 1..cap-1 的候选步长
-        size_t step2 = 1 + (h2 % (cap - 1));
-
-        // 关键：确保与 cap 互素
-        if (gcd_size(step2, cap) != 1) {
-            // 简单做法：逐步 +1 直到互素
-            do {
-                step2++;
-                if (step2 == cap) step2 = 1; // 保持在 1..cap-1
-            } while (gcd_size(step2, cap) != 1);
+        if (hn->state == SLOT_OCCUPIED)
+        {
+            if (hn->dist < dist)
+                return SIZE_MAX; // early termination
+            if (hn->hash == hash &&
+                htoa->keyops.eq(keystore_get(&htoa->keys, &hn->key, hn->keysz), key) == 0)
+                return idx;
         }
+        idx = (idx + 1) & mask;
+    }
+    return SIZE_MAX;
+}
 
-        // 计算 (start + i * step2) % cap
-        step %= cap; // 防溢也防无谓的大数运算
-        size_t inc = ((step % cap) * (step2 % cap)) % cap;
-        return (start + inc) % cap;
+/*
+ * Robin Hood 插入：沿线性探测前进，遇到距离比手中元素更小的槽位就交换，
+ * 继续为被换出的元素找位置（劫富济贫，使各键的探测距离趋于平均）
+ * 调用方保证 key 不在表中且表中至少有一个空槽
+ */
+static void rh_place(HashTableOA *htoa, const HashNode *src)
+{
+    HashNode *table = htoa->table;
+    size_t mask = htoa->capacity - 1;
+    HashNode cur = *src;
+    cur.state = SLOT_OCCUPIED;
+    cur.dist = 0;
+    size_t idx = cur.hash & mask;
+    for (;;)
+    {
+        HashNode *hn = &table[idx];
+        if (hn->state != SLOT_OCCUPIED)
+        {
+            *hn = cur;
+            stats_add(htoa, cur.dist);
+            return;
+        }
+        if (hn->dist < cur.dist)
+        {
+            HashNode tmp = *hn;
+            stats_remove(htoa, tmp.dist);
+            stats_add(htoa, cur.dist);
+            *hn = cur;
+            cur = tmp;
+        }
+        cur.dist++;
+        idx = (idx + 1) & mask;
     }
 }
 
-static size_t idx_for(HashTableOA *htoa, const void *key, size_t keysz)
+/* Robin Hood 删除：把后续距离非零的元素逐个前移一格，不留墓碑 */
+static void rh_backward_shift(HashTableOA *htoa, size_t idx)
 {
-    if (!htoa)
-        return SIZE_MAX;
     HashNode *table = htoa->table;
-    size_t start = htoa->h1(key, keysz) % htoa->capacity;
+    size_t mask = htoa->capacity - 1;
+    size_t next = (idx + 1) & mask;
+    while (table[next].state == SLOT_OCCUPIED && table[next].dist > 0)
+    {
+        table[idx] = table[next];
+        stats_remove(htoa, table[idx].dist);
+        table[idx].dist--;
+        stats_add(htoa, table[idx].dist);
+        idx = next;
+        next = (next + 1) & mask;
+    }
+    memset(&table[idx], 0, sizeof(HashNode)); // SLOT_EMPTY
+}
+
+/*
+ * 沿探测序列查找 key（hash 为已算好的 h1）
+ * - 找到返回其槽位；否则返回第一个墓碑或空槽（供插入），表满返回 SIZE_MAX
+ * - dist 输出返回槽位的探测步数，probes 输出实际检查过的槽位数
+ * - find_existing 为 false 时调用方保证 key 不在表中（rehash），跳过所有比较
+ * - PROBE_ROBINHOOD 只返回命中的槽位，插入位置由 rh_place 决定
+ * - h2 只在第一次冲突时才计算
+ */
+static size_t probe_table(const HashTableOA *htoa, const HashNode *table, size_t capacity,
+                          const void *key, size_t keysz, size_t hash, bool find_existing,
+                          size_t *dist, size_t *probes)
+{
+    if (htoa->probe == PROBE_ROBINHOOD)
+        return find_existing ? rh_find(htoa, table, capacity, key, hash, probes) : SIZE_MAX;
+
+    size_t mask = capacity - 1;
+    size_t idx = hash & mask;
     size_t first_tomb = SIZE_MAX;
-    size_t h2 = htoa->h2 ? htoa->h2(key, keysz) : 0;
-    for (size_t step = 0; step < htoa->capacity; step++)
+    size_t tomb_step = 0;
+    size_t dh_step = 1;
+    *probes = capacity;
+    for (size_t step = 0; step < capacity; step++)
     {
-        size_t idx = next_idx(htoa, start, step, h2);
+        if (step)
+        {
+            if (step == 1 && htoa->probe == PROBE_DOUBLEHASH)
+                dh_step = htoa->h2(key, keysz) | 1;
+            idx = (idx + probe_inc(htoa, step, dh_step)) & mask;
+        }
         if (table[idx].state == SLOT_OCCUPIED)
         {
-            if (htoa->keyops.eq(table[idx].key, key) == 0)
+            if (find_existing && table[idx].hash == hash &&
+                htoa->keyops.eq(keystore_get(&htoa->keys, &table[idx].key, table[idx].keysz),
+                                key) == 0)
             {
+                *dist = step;
+                *probes = step + 1;
                 return idx;
             }
         }
         else if (table[idx].state == SLOT_TOMBSTONE)
         {
             if (first_tomb == SIZE_MAX)
+            {
                 first_tomb = idx;
+                tomb_step = step;
+            }
         }
         else
         {
             // SLOT_EMPTY
-            return (first_tomb == SIZE_MAX) ? idx : first_tomb;
+            *probes = step + 1;
+            if (first_tomb != SIZE_MAX)
+            {
+                *dist = tomb_step;
+                return first_tomb;
+            }
+            *dist = step;
+            return idx;
         }
     }
     // the last tomb
+    *dist = tomb_step;
     if (first_tomb != SIZE_MAX)
         return first_tomb;
     return SIZE_MAX;
 }
 
+static inline size_t idx_for_hash(HashTableOA *htoa, const void *key, size_t keysz,
+                                  size_t hash, bool find_existing, size_t *dist, size_t *probes)
+{
+    if (!htoa)
+        return SIZE_MAX;
+    return probe_table(htoa, htoa->table, htoa->capacity, key, keysz, hash, find_existing,
+                       dist, probes);
+}
+
+/* 把 src 放入当前表（调用方保证 key 不在表中）；表满返回 false */
+static bool place_node(HashTableOA *htoa, const HashNode *src)
+{
+    if (htoa->probe == PROBE_ROBINHOOD)
+    {
+        if (htoa->size - htoa->old_size >= htoa->capacity)
+            return false;
+        rh_place(htoa, src);
+        return true;
+    }
+    // only double hashing reads the key here, to compute h2
+    size_t dist, probes;
+    size_t idx = idx_for_hash(htoa, keystore_get(&htoa->keys, &src->key, src->keysz),
+                              src->keysz, src->hash, false, &dist, &probes);
+    if (idx == SIZE_MAX)
+        return false;
+    HashNode *dst = &htoa->table[idx];
+    if (dst->state == SLOT_TOMBSTONE && htoa->tombstones)
+        htoa->tombstones--;
+    *dst = *src;
+    dst->state = SLOT_OCCUPIED;
+    dst->dist = (uint32_t)dist;
+    stats_add(htoa, dist);
+    return true;
+}
+
 static bool oa_rehash(HashTableOA *htoa, size_t new_capacity)
 {
     if (!htoa)
@@ -132,6 +306,7 @@ static bool oa_rehash(HashTableOA *htoa, size_t new_capacity)
     size_t old_capacity = htoa->capacity;
     size_t old_size = htoa->size;
     size_t old_tombstones = htoa->tombstones;
+    OAStats old_stats = htoa->stats;
 
     HashNode *new_tab = (HashNode *)calloc(new_capacity, sizeof(HashNode));
     if (!new_tab)
@@ -140,51 +315,181 @@ static bool oa_rehash(HashTableOA *htoa, size_t new_capacity)
     htoa->capacity = new_capacity;
     htoa->size = 0;
     htoa->tombstones = 0;
+    // placement statistics are rebuilt as the entries are re-inserted
+    memset(htoa->stats.hist, 0, sizeof(htoa->stats.hist));
+    htoa->stats.dist_sum = 0;
+    htoa->stats.max_probe = 0;
 
     for (size_t i = 0; i < old_capacity; i++)
     {
-        HashNode old_hn = old_tab[i];
-        if (old_hn.state == SLOT_OCCUPIED)
+        const HashNode *old_hn = &old_tab[i];
+        if (old_hn->state == SLOT_OCCUPIED)
         {
-            size_t idx = idx_for(htoa, old_hn.key, old_hn.keysz);
-            if (idx == SIZE_MAX)
+            if (!place_node(htoa, old_hn))
             {
                 free(new_tab);
                 htoa->table = old_tab;
                 htoa->capacity = old_capacity;
                 htoa->size = old_size;
                 htoa->tombstones = old_tombstones;
+                htoa->stats = old_stats;
                 return false;
             }
-            HashNode *dst = &htoa->table[idx];
-            dst->key = old_hn.key;
-            dst->keysz = old_hn.keysz;
-            dst->value = old_hn.value;
-            dst->state = SLOT_OCCUPIED;
             htoa->size++;
         }
     }
     free(old_tab);
+    htoa->stats.resizes++;
     return true;
 }
 
-static bool oa_insert(void *impl, const void *key, size_t keysz, void *val)
+/* 增量扩容：把旧表中最多 max_slots 个槽位搬到新表，旧表搬空后释放 */
+static void oa_migrate(HashTableOA *htoa, size_t max_slots)
 {
-    if (!impl)
+    HashNode *old_tab = htoa->old_table;
+    size_t old_capacity = htoa->old_capacity;
+    size_t pos = htoa->migrate_pos;
+    size_t end = (max_slots > old_capacity - pos) ? old_capacity : pos + max_slots;
+
+    for (; pos < end && htoa->old_size; pos++)
+    {
+        HashNode *hn = &old_tab[pos];
+        if (hn->state != SLOT_OCCUPIED)
+            continue;
+        // the new table is at least twice as large, so a slot always exists
+        stats_remove(htoa, hn->dist);
+        place_node(htoa, hn);
+        htoa->old_size--;
+        // a tombstone keeps probe chains in the old table intact for later lookups
+        hn->value = NULL;
+        hn->state = SLOT_TOMBSTONE;
+    }
+    htoa->migrate_pos = pos;
+
+    if (htoa->old_size == 0)
+    {
+        free(old_tab);
+        htoa->old_table = NULL;
+        htoa->old_capacity = 0;
+        htoa->migrate_pos = 0;
+    }
+}
+
+static bool oa_start_resize(HashTableOA *htoa, size_t new_capacity)
+{
+    HashNode *new_tab = (HashNode *)calloc(new_capacity, sizeof(HashNode));
+    if (!new_tab)
         return false;
+    htoa->old_table = htoa->table;
+    htoa->old_capacity = htoa->capacity;
+    htoa->old_size = htoa->size;
+    htoa->migrate_pos = 0;
+    htoa->table = new_tab;
+    htoa->capacity = new_capacity;
+    htoa->tombstones = 0; // tombstones of the old table are dropped with it
+    htoa->stats.max_probe = 0;
+    htoa->stats.resizes++;
+    return true;
+}
+
+static bool oa_grow(HashTableOA *htoa)
+{
+    if (htoa->resize != RESIZE_INCREMENTAL)
+        return oa_rehash(htoa, next_capacity(htoa->capacity));
+
+    // a pending migration has to finish before the next one can start
+    if (htoa->old_table)
+    {
+        oa_migrate(htoa, SIZE_MAX);
+        if ((double)(htoa->size + htoa->tombstones) / htoa->capacity <= htoa->max_load_factor)
+            return true;
+    }
+    return oa_start_resize(htoa, next_capacity(htoa->capacity));
+}
+
+/* 预留共 n 个元素的空间：最多一次 rehash（顺带清掉墓碑），增量模式下也一次完成 */
+static bool oa_reserve(void *impl, size_t n)
+{
     HashTableOA *htoa = (HashTableOA *)impl;
+    if (htoa->old_table)
+        oa_migrate(htoa, SIZE_MAX);
+    size_t cap = htoa->capacity;
+    while ((double)n > htoa->max_load_factor * cap && cap <= SIZE_MAX / 2)
+        cap <<= 1;
+    if (cap == htoa->capacity && (double)(n + htoa->tombstones) <= htoa->max_load_factor * cap)
+        return true;
+    return oa_rehash(htoa, cap);
+}
+
+/* 换成装下当前元素的最小容量，同时清掉墓碑 */
+static bool oa_shrink_to_fit(void *impl)
+{
+    HashTableOA *htoa = (HashTableOA *)impl;
+    if (htoa->old_table)
+        oa_migrate(htoa, SIZE_MAX);
+    size_t cap = 8;
+    while ((double)htoa->size > htoa->max_load_factor * cap && cap <= SIZE_MAX / 2)
+        cap <<= 1;
+    if (cap >= htoa->capacity)
+    {
+        if (htoa->tombstones == 0)
+            return true;
+        cap = htoa->capacity;
+    }
+    return oa_rehash(htoa, cap);
+}
+
+/*
+ * 查找 key：先查新表，增量扩容期间再查旧表
+ * 返回命中的节点（可能位于旧表），找不到返回 NULL 并计入未命中统计；
+ * pos 非 NULL 时输出新表中可供插入的位置
+ */
+static HashNode *find_node(HashTableOA *htoa, const void *key, size_t keysz,
+                           size_t hash, InsertPos *pos)
+{
+    size_t dist = 0, probes, old_probes = 0;
+    size_t idx = idx_for_hash(htoa, key, keysz, hash, true, &dist, &probes);
+    if (pos)
+    {
+        pos->slot = idx;
+        pos->dist = dist;
+    }
+    if (idx != SIZE_MAX && htoa->table[idx].state == SLOT_OCCUPIED)
+        return &htoa->table[idx];
+    if (htoa->old_table)
+    {
+        idx = probe_table(htoa, htoa->old_table, htoa->old_capacity, key, keysz, hash, true,
+                          &dist, &old_probes);
+        if (idx != SIZE_MAX && htoa->old_table[idx].state == SLOT_OCCUPIED)
+            return &htoa->old_table[idx];
+    }
+    htoa->stats.misses++;
+    htoa->stats.miss_probes += probes + old_probes;
+    return NULL;
+}
+
+static inline HashNode *lookup(HashTableOA *htoa, const void *key, size_t keysz)
+{
+    if (htoa->old_table)
+        oa_migrate(htoa, OA_MIGRATE_SLOTS);
+    return find_node(htoa, key, keysz, ht_hash(&htoa->keyops, key, keysz), NULL);
+}
+
+static bool oa_insert_hashed(HashTableOA *htoa, const void *key, size_t keysz,
+                             size_t hash, void *val)
+{
     HashKeyOps keyops = htoa->keyops;
+    if (htoa->old_table)
+        oa_migrate(htoa, OA_MIGRATE_SLOTS);
     if ((double)(htoa->size + htoa->tombstones) / htoa->capacity > htoa->max_load_factor)
     {
-        if (!oa_rehash(htoa, next_capacity(htoa->capacity)))
+        if (!oa_grow(htoa))
             return false;
     }
 
-    size_t idx = idx_for(htoa, key, keysz);
-    if (idx == SIZE_MAX)
-        return false;
-    HashNode *hn = &htoa->table[idx];
-    if (hn->state == SLOT_OCCUPIED)
+    InsertPos pos;
+    HashNode *hn = find_node(htoa, key, keysz, hash, &pos);
+    if (hn)
     {
         if (keyops.destroy_val && hn->value && hn->value != val)
         {
@@ -193,66 +498,141 @@ static bool oa_insert(void *impl, const void *key, size_t keysz, void *val)
         hn->value = val;
         return true;
     }
+    else if (htoa->probe == PROBE_ROBINHOOD)
+    {
+        HashNode node = {.keysz = keysz, .hash = hash, .value = val};
+        if (!keystore_put(&htoa->keys, &node.key, key, keysz)) return false;
+        if (!place_node(htoa, &node))
+        {
+            keystore_release(&htoa->keys, &node.key, keysz);
+            return false;
+        }
+        htoa->size++;
+        return true;
+    }
     else
     {
+        if (pos.slot == SIZE_MAX)
+            return false;
+        hn = &htoa->table[pos.slot];
+        if (!keystore_put(&htoa->keys, &hn->key, key, keysz)) return false;
         if (hn->state == SLOT_TOMBSTONE && htoa->tombstones)
             htoa->tombstones--;
-        hn->key = malloc(keysz);
-        if (!hn->key) return false;
-        memcpy(hn->key, key, keysz);
         hn->keysz = keysz;
+        hn->hash = hash;
         hn->value = val;
         hn->state = SLOT_OCCUPIED;
+        hn->dist = (uint32_t)pos.dist;
+        stats_add(htoa, pos.dist);
 
         htoa->size++;
         return true;
     }
 }
 
+static bool oa_insert(void *impl, const void *key, size_t keysz, void *val)
+{
+    if (!impl)
+        return false;
+    HashTableOA *htoa = (HashTableOA *)impl;
+    return oa_insert_hashed(htoa, key, keysz, ht_hash(&htoa->keyops, key, keysz), val);
+}
+
+/* 批量操作的第一阶段：算出一轮键的哈希并预取各自在新表中的初始槽位 */
+static void oa_hash_prefetch(HashTableOA *htoa, const void **keys, const size_t *keyszs,
+                             size_t m, size_t *hashes)
+{
+    size_t mask = htoa->capacity - 1;
+    for (size_t i = 0; i < m; i++)
+    {
+        hashes[i] = ht_hash(&htoa->keyops, keys[i], keyszs[i]);
+        HT_PREFETCH(&htoa->table[hashes[i] & mask]);
+    }
+}
+
+static size_t oa_search_batch(void *impl, const void **keys, const size_t *keyszs,
+                              size_t n, void **out)
+{
+    if (!impl) return 0;
+    HashTableOA *htoa = (HashTableOA *)impl;
+    size_t hashes[HT_BATCH];
+    size_t found = 0;
+    for (size_t base = 0; base < n; base += HT_BATCH)
+    {
+        size_t m = n - base < HT_BATCH ? n - base : HT_BATCH;
+        // same migration budget as m single lookups
+        if (htoa->old_table)
+            oa_migrate(htoa, OA_MIGRATE_SLOTS * m);
+        oa_hash_prefetch(htoa, keys + base, keyszs + base, m, hashes);
+        for (size_t i = 0; i < m; i++)
+        {
+            HashNode *hn = find_node(htoa, keys[base + i], keyszs[base + i], hashes[i], NULL);
+            out[base + i] = hn ? hn->value : NULL;
+            found += hn != NULL;
+        }
+    }
+    return found;
+}
+
+static size_t oa_insert_batch(void *impl, const void **keys, const size_t *keyszs,
+                              void **vals, size_t n)
+{
+    if (!impl) return 0;
+    HashTableOA *htoa = (HashTableOA *)impl;
+    size_t hashes[HT_BATCH];
+    size_t inserted = 0;
+    for (size_t base = 0; base < n; base += HT_BATCH)
+    {
+        size_t m = n - base < HT_BATCH ? n - base : HT_BATCH;
+        oa_hash_prefetch(htoa, keys + base, keyszs + base, m, hashes);
+        for (size_t i = 0; i < m; i++)
+            inserted += oa_insert_hashed(htoa, keys[base + i], keyszs[base + i], hashes[i],
+                                         vals[base + i]);
+    }
+    return inserted;
+}
+
 static void *oa_search(void *impl, const void *key, size_t keysz)
 {
     if (!impl) return NULL;
     HashTableOA *htoa = (HashTableOA*)impl;
-    HashNode *table = htoa->table;
 
-    size_t idx = idx_for(htoa, key, keysz);
-    if (idx == SIZE_MAX) return NULL;
-    HashNode hn = table[idx];
-    if (hn.state != SLOT_OCCUPIED) return NULL;
-    if (htoa->keyops.eq(hn.key, key) != 0) return NULL;
-    return hn.value;
+    HashNode *hn = lookup(htoa, key, keysz);
+    return hn ? hn->value : NULL;
 }
 
 static bool oa_erase(void *impl, const void *key, size_t keysz)
 {
     if (!impl) return false;
     HashTableOA *htoa = (HashTableOA*)impl;
-    HashNode *table = htoa->table;
 
-    size_t idx = idx_for(htoa, key, keysz);
-    if (idx == SIZE_MAX) return false;
-    HashNode *hn = &table[idx];
-    if (hn->state != SLOT_OCCUPIED) return false; 
-    if (htoa->keyops.eq(hn->key, key) != 0) return false;
+    HashNode *hn = lookup(htoa, key, keysz);
+    if (!hn) return false;
+    bool in_old = htoa->old_table && hn >= htoa->old_table &&
+                  hn < htoa->old_table + htoa->old_capacity;
 
-    if (htoa->keyops.destroy_key)
-    {
-        htoa->keyops.destroy_key(hn->key);
-    } else {
-        free(hn->key);
-    }
+    keystore_release(&htoa->keys, &hn->key, hn->keysz);
     if (htoa->keyops.destroy_val)
     {
         htoa->keyops.destroy_val(hn->value);
     }
     
-    hn->key = NULL;
+    htoa->size--;
+    stats_remove(htoa, hn->dist);
+    if (!in_old && htoa->probe == PROBE_ROBINHOOD)
+    {
+        rh_backward_shift(htoa, (size_t)(hn - htoa->table));
+        return true;
+    }
+
     hn->value = NULL;
     hn->keysz = 0;
+    hn->hash = 0;
     hn->state = SLOT_TOMBSTONE;
-
-    htoa->size--;
-    htoa->tombstones++;
+    if (in_old)
+        htoa->old_size--;
+    else
+        htoa->tombstones++;
     return true;
 }
 
@@ -260,12 +640,8 @@ static bool oa_update(void *impl, const void *key, size_t keysz, void *new_value
 {
     if (!impl) return false;
     HashTableOA *htoa = (HashTableOA*)impl;
-    HashNode *table = htoa->table;
-    size_t idx = idx_for(htoa, key, keysz);
-    if (idx == SIZE_MAX) return false;
-    HashNode *hn = &table[idx];
-    if (hn->state != SLOT_OCCUPIED) return false;
-    if (htoa->keyops.eq(key, hn->key) != 0) return false;
+    HashNode *hn = lookup(htoa, key, keysz);
+    if (!hn) return false;
 
     if (hn->value == new_value) return true;
     if (htoa->keyops.destroy_val && hn->value) {
@@ -296,34 +672,37 @@ static double oa_load_factor(const void *impl)
 
 static HashStats oa_stats(const void *impl)
 {
-    printf("not implemented for OA!");
-    HashStats hs={0};
+    HashStats hs = {0};
+    if (!impl) return hs;
+    const HashTableOA *htoa = (const HashTableOA *)impl;
+    const OAStats *st = &htoa->stats;
+
+    hs.total_elements = htoa->size;
+    hs.used_buckets = htoa->size;
+    hs.max_chain_or_probe = st->max_probe;
+    hs.collision_count = htoa->size - st->hist[1]; // entries not in their home slot
+    memcpy(hs.histogram, st->hist, sizeof(hs.histogram));
+    hs.tombstones = htoa->tombstones;
+    hs.avg_probe_success = htoa->size ? 1.0 + (double)st->dist_sum / htoa->size : 0.0;
+    hs.average_chain_length = hs.avg_probe_success;
+    hs.avg_probe_failure = st->misses ? (double)st->miss_probes / st->misses : 0.0;
+    hs.resize_count = st->resizes;
+    hs.bytes_used = sizeof(HashTableOA) + htoa->capacity * sizeof(HashNode) +
+                    htoa->old_capacity * sizeof(HashNode) + htoa->keys.bytes;
     return hs;
 }
 
-void oa_destroy(void **pimpl)
+static void oa_destroy_entries(HashTableOA *htoa, HashNode *table, size_t cap)
 {
-    if (!pimpl || !*pimpl) return;
-    HashTableOA *impl = *pimpl;
-    HashNode *table = impl->table;
-    size_t cap = impl->capacity;
-    HashKeyOps keyops = impl->keyops;
+    HashKeyOps keyops = htoa->keyops;
     for (size_t i = 0; i < cap; i++)
     {
         HashNode *hn = &table[i];
 
         if (hn->state == SLOT_OCCUPIED) 
         {
-            if (keyops.destroy_key) 
-            {
-                keyops.destroy_key(hn->key);
-            }
-            else
-            {
-                free(hn->key);
-            }
-            hn->key = NULL;
-            
+            keystore_release(&htoa->keys, &hn->key, hn->keysz);
+
             if (keyops.destroy_val)
             {
                 keyops.destroy_val(hn->value);
@@ -333,8 +712,68 @@ void oa_destroy(void **pimpl)
             hn = NULL;
         }
     }
-    
-    free(table);
+}
+
+// slots ahead of the cursor whose out-of-line keys are prefetched while streaming the table
+#define OA_SCAN_PREFETCH 8
+
+static inline void oa_prefetch_key(const HashTableOA *htoa, size_t i)
+{
+    if (i < htoa->capacity && htoa->table[i].state == SLOT_OCCUPIED)
+        HT_PREFETCH(keystore_get(&htoa->keys, &htoa->table[i].key, htoa->table[i].keysz));
+}
+
+static bool oa_foreach(void *impl, hashtable_visit_t visit, void *ctx)
+{
+    HashTableOA *htoa = (HashTableOA *)impl;
+    // a lookup in visit would migrate slots under the scan; move everything first
+    if (htoa->old_table)
+        oa_migrate(htoa, SIZE_MAX);
+    // one linear pass over the slot array
+    for (size_t i = 0; i < htoa->capacity; i++)
+    {
+        const HashNode *hn = &htoa->table[i];
+        oa_prefetch_key(htoa, i + OA_SCAN_PREFETCH);
+        if (hn->state == SLOT_OCCUPIED &&
+            !visit(keystore_get(&htoa->keys, &hn->key, hn->keysz), hn->keysz, hn->value, ctx))
+            return false;
+    }
+    return true;
+}
+
+static bool oa_iter_next(void *impl, HashIter *it)
+{
+    HashTableOA *htoa = (HashTableOA *)impl;
+    if (htoa->old_table)
+        oa_migrate(htoa, SIZE_MAX);
+    for (size_t i = it->pos; i < htoa->capacity; i++)
+    {
+        const HashNode *hn = &htoa->table[i];
+        oa_prefetch_key(htoa, i + OA_SCAN_PREFETCH);
+        if (hn->state != SLOT_OCCUPIED)
+            continue;
+        it->pos = i + 1;
+        it->key = keystore_get(&htoa->keys, &hn->key, hn->keysz);
+        it->keysz = hn->keysz;
+        it->value = hn->value;
+        return true;
+    }
+    it->pos = htoa->capacity;
+    return false;
+}
+
+void oa_destroy(void **pimpl)
+{
+    if (!pimpl || !*pimpl) return;
+    HashTableOA *impl = *pimpl;
+    oa_destroy_entries(impl, impl->table, impl->capacity);
+    free(impl->table);
+    if (impl->old_table)
+    {
+        oa_destroy_entries(impl, impl->old_table, impl->old_capacity);
+        free(impl->old_table);
+    }
+    keystore_destroy(&impl->keys);
     free(impl);
     *pimpl = NULL;
 }
@@ -347,8 +786,20 @@ HashTable *hashtable_oa_create(
     hash_func_t secondary_hash /* 可为 NULL；双散列时必须提供 */
 )
 {
-    if (initial_capacity == 0)
-        initial_capacity = 8;
+    return hashtable_oa_create_ex(initial_capacity, max_load_factor, keyops,
+                                  probe, secondary_hash, RESIZE_ALL_AT_ONCE);
+}
+
+HashTable *hashtable_oa_create_ex(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops,
+    ProbeStrategy probe,
+    hash_func_t secondary_hash,
+    ResizeMode resize)
+{
+    // power-of-two capacity lets probing use a mask instead of modulo
+    initial_capacity = initial_capacity ? round_up_pow2(initial_capacity) : 8;
     HashTableOA *impl = malloc(sizeof(HashTableOA));
     if (!impl)
         return NULL;
@@ -369,18 +820,31 @@ HashTable *hashtable_oa_create(
         return NULL;
     }
     impl->probe = probe ? probe : PROBE_LINEAR;
-    impl->h1 = keyops.hash;
     impl->h2 = secondary_hash;
+    keyops = ht_seed_keyops(keyops);
     impl->keyops = keyops;
+    keystore_init(&impl->keys, keyops.destroy_key);
+    impl->resize = resize;
+    impl->old_table = NULL;
+    impl->old_capacity = 0;
+    impl->old_size = 0;
+    impl->migrate_pos = 0;
+    memset(&impl->stats, 0, sizeof(impl->stats));
     HashOps ops = {
         .insert = oa_insert,
         .search = oa_search,
         .erase = oa_erase,
         .update = oa_update,
+        .search_batch = oa_search_batch,
+        .insert_batch = oa_insert_batch,
+        .reserve = oa_reserve,
+        .shrink_to_fit = oa_shrink_to_fit,
         .size = oa_size,
         .capacity = oa_capacity,
         .load_factor = oa_load_factor,
         .stats = oa_stats,
+        .foreach = oa_foreach,
+        .iter_next = oa_iter_next,
         .destroy = oa_destroy,
     };
 
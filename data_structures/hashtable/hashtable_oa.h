@@ -3,9 +3,15 @@
 #include "hashtable.h"
 
 /*
- * 开放地址法哈希表（线性/二次/双散列）
+ * 开放地址法哈希表（线性/二次/双散列/Robin Hood）
  * - 槽位数组（连续内存）+ SLOT_EMPTY/OCCUPIED/TOMBSTONE
+ * - 容量始终为 2 的幂：下标用掩码计算，二次探测使用三角数序列（可遍历全部槽位），
+ *   双散列步长取奇数（必与容量互质）
+ * - 每个槽位缓存完整的 h1 哈希：探测时先比哈希再调用 eq，rehash 时不重算 h1
  * - 通过探测函数选择策略；双散列需传入 secondary_hash（h2）
+ * - Robin Hood：线性探测 + 每槽记录探测距离，插入时距离大的元素抢占距离小的槽位；
+ *   删除用后移（backward shift）代替墓碑，查找遇到距离更小的槽位即提前结束，
+ *   负载因子可设到 0.9 以上
  */
 
 typedef struct HashTableOA HashTableOA;
@@ -14,17 +20,18 @@ typedef enum
 {
     PROBE_LINEAR = 0,
     PROBE_QUADRATIC = 1,
-    PROBE_DOUBLEHASH = 2
+    PROBE_DOUBLEHASH = 2,
+    PROBE_ROBINHOOD = 3
 } ProbeStrategy;
 
 /**
  * 创建开放地址法哈希表
- * @param initial_capacity 初始容量（建议取素数或 2 的幂，视探测策略而定）
+ * @param initial_capacity 初始容量（向上取整为 2 的幂，0 表示默认值 8）
  * @param max_load_factor  负载因子阈值（如 0.5~0.8）；可另设墓碑比例阈值（在 .c 实现）
  * @param keyops           键相关回调（hash/eq/destroy）
- * @param probe            探测函数（线性/二次/双散列）
+ * @param probe            探测函数（线性/二次/双散列/Robin Hood）
  * @param secondary_hash   双散列的 h2，可为 NULL（当非双散列时）
- *        典型用法：h2(key) % (capacity-1) + 1，且确保与 capacity 互质
+ *        实际步长为 h2(key) | 1，每次查找只计算一次
  * @return 以统一接口 HashTable* 返回
  */
 HashTable *hashtable_oa_create(
@@ -34,3 +41,19 @@ HashTable *hashtable_oa_create(
     ProbeStrategy probe,
     hash_func_t   secondary_hash /* 可为 NULL；双散列时必须提供 */
 );
+
+/**
+ * 创建开放地址法哈希表，并指定扩容方式
+ * @param resize RESIZE_ALL_AT_ONCE：插入时一次性 rehash 全部元素（hashtable_oa_create 的行为）
+ *               RESIZE_INCREMENTAL：新旧两张表并存，之后每次增删改查搬迁一小段旧表，
+ *               查找在迁移完成前同时检查两张表
+ * 其余参数同 hashtable_oa_create
+ */
+HashTable *hashtable_oa_create_ex(
+    size_t        initial_capacity,
+    double        max_load_factor,
+    HashKeyOps    keyops,
+    ProbeStrategy probe,
+    hash_func_t   secondary_hash,
+    ResizeMode    resize
+);
@@ -0,0 +1,628 @@
+// data_structures/hashtable/hashtable_oa_rcu.c
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "hashtable_oa_rcu.h"
+#include "hashtable_internal.h"
+
+#define RCU_CACHELINE 64
+#define RCU_STRIPES 32       // reader counters per epoch, one cache line each
+#define RCU_RETIRE_BATCH 64  // objects collected before waiting for a grace period
+#define RCU_MIN_CAPACITY 8
+
+// GNU atomic builtins: the tree is C99, so no <stdatomic.h>
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define STORE_RELAXED(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+/* 条目发布后只有 value 会变（原子替换），其余字段不可变 */
+typedef struct RcuEntry
+{
+    size_t hash;
+    size_t keysz;
+    void *value;
+    HtKey key; // short keys inline, longer ones in the table's KeyStore
+} RcuEntry;
+
+typedef struct RcuTable
+{
+    size_t capacity; // power of two
+    size_t mask;
+    RcuEntry *slots[]; // NULL = empty, RCU_TOMBSTONE = deleted
+} RcuTable;
+
+static char rcu_tombstone;
+#define RCU_TOMBSTONE ((RcuEntry *)&rcu_tombstone)
+
+typedef struct ReaderCount
+{
+    size_t n;
+    char pad[RCU_CACHELINE - sizeof(size_t)];
+} ReaderCount;
+
+typedef enum
+{
+    RETIRE_ENTRY, // erased entry: release key, destroy value, free
+    RETIRE_VALUE, // value replaced by insert/update: destroy_val
+    RETIRE_TABLE  // slot array replaced by rehash: free
+} RetireKind;
+
+typedef struct
+{
+    void *ptr;
+    RetireKind kind;
+} Retired;
+
+struct HashTableOARcu
+{
+    // readers only write here, each thread to its own stripe
+    ReaderCount readers[2][RCU_STRIPES];
+
+    // read-mostly: changed once per grace period / rehash
+    unsigned epoch;
+    RcuTable *table;
+    char pad[RCU_CACHELINE - sizeof(unsigned) - sizeof(RcuTable *)];
+
+    // writer state
+    pthread_mutex_t write_lock;
+    size_t size;
+    size_t tombstones;
+    size_t capacity;
+    size_t resizes;
+    double max_load_factor;
+    HashKeyOps keyops;
+    KeyStore keys;
+    Retired retired[RCU_RETIRE_BATCH];
+    size_t nretired;
+};
+
+/* ========== read side ========== */
+
+static __thread unsigned rcu_thread_stripe; // 1 + stripe index, 0 until first use
+static unsigned rcu_stripe_seq;
+
+static inline unsigned reader_stripe(void)
+{
+    if (!rcu_thread_stripe)
+        rcu_thread_stripe = 1 + __atomic_fetch_add(&rcu_stripe_seq, 1, __ATOMIC_RELAXED) % RCU_STRIPES;
+    return rcu_thread_stripe - 1;
+}
+
+#ifdef HASHTABLE_RCU_TEST_HOOKS
+void (*hashtable_rcu_enter_stall)(void);
+#endif
+
+static inline unsigned rcu_enter(HashTableOARcu *h)
+{
+    unsigned stripe = reader_stripe();
+    for (;;)
+    {
+        unsigned idx = LOAD_RELAXED(&h->epoch) & 1;
+#ifdef HASHTABLE_RCU_TEST_HOOKS
+        if (hashtable_rcu_enter_stall)
+            hashtable_rcu_enter_stall();
+#endif
+        // seq_cst, like the slot and table loads that follow: the writer either sees
+        // this count or we see everything it unpublished before its grace period
+        __atomic_fetch_add(&h->readers[idx][stripe].n, 1, __ATOMIC_SEQ_CST);
+
+        // a grace period that flipped the epoch between the load and the increment
+        // may already have found readers[idx] empty and returned; a later one only
+        // waits on the other epoch, so registering here would not hold anything back.
+        // Seeing idx again afterwards means any future flip away from idx waits for us
+        if ((LOAD(&h->epoch) & 1) == idx)
+            return idx * RCU_STRIPES + stripe;
+        __atomic_fetch_sub(&h->readers[idx][stripe].n, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static inline void rcu_exit(HashTableOARcu *h, unsigned token)
+{
+    __atomic_fetch_sub(&h->readers[token / RCU_STRIPES][token % RCU_STRIPES].n, 1,
+                       __ATOMIC_RELEASE);
+}
+
+unsigned hashtable_rcu_read_lock(HashTable *ht)
+{
+    return rcu_enter((HashTableOARcu *)ht->impl);
+}
+
+void hashtable_rcu_read_unlock(HashTable *ht, unsigned token)
+{
+    rcu_exit((HashTableOARcu *)ht->impl, token);
+}
+
+/* ========== write side: grace periods and reclamation ========== */
+
+/* 翻转 epoch，等旧 epoch 上的读者全部离开；之后新进入的读者看不到此前摘下的对象 */
+static void rcu_synchronize(HashTableOARcu *h)
+{
+    unsigned old = h->epoch & 1;
+    STORE(&h->epoch, old ^ 1);
+    for (size_t s = 0; s < RCU_STRIPES; s++)
+        while (LOAD(&h->readers[old][s].n) != 0)
+            sched_yield();
+}
+
+static void rcu_reclaim(HashTableOARcu *h, bool wait);
+
+#ifdef HASHTABLE_RCU_TEST_HOOKS
+void hashtable_rcu_test_synchronize(HashTable *ht)
+{
+    HashTableOARcu *h = (HashTableOARcu *)ht->impl;
+    pthread_mutex_lock(&h->write_lock);
+    rcu_synchronize(h);
+    rcu_reclaim(h, false);
+    pthread_mutex_unlock(&h->write_lock);
+}
+#endif
+
+static void free_retired(HashTableOARcu *h, Retired r)
+{
+    switch (r.kind)
+    {
+    case RETIRE_ENTRY:
+    {
+        RcuEntry *e = (RcuEntry *)r.ptr;
+        keystore_release(&h->keys, &e->key, e->keysz);
+        if (h->keyops.destroy_val)
+            h->keyops.destroy_val(e->value);
+        free(e);
+        break;
+    }
+    case RETIRE_VALUE:
+        h->keyops.destroy_val(r.ptr);
+        break;
+    case RETIRE_TABLE:
+        free(r.ptr);
+        break;
+    }
+}
+
+static void rcu_reclaim(HashTableOARcu *h, bool wait)
+{
+    if (h->nretired == 0)
+        return;
+    if (wait)
+        rcu_synchronize(h);
+    for (size_t i = 0; i < h->nretired; i++)
+        free_retired(h, h->retired[i]);
+    h->nretired = 0;
+}
+
+static void rcu_retire(HashTableOARcu *h, void *ptr, RetireKind kind)
+{
+    h->retired[h->nretired].ptr = ptr;
+    h->retired[h->nretired].kind = kind;
+    if (++h->nretired == RCU_RETIRE_BATCH)
+        rcu_reclaim(h, true);
+}
+
+/* ========== write side: table maintenance ========== */
+
+static RcuTable *table_create(size_t capacity)
+{
+    RcuTable *t = calloc(1, sizeof(RcuTable) + capacity * sizeof(RcuEntry *));
+    if (!t)
+        return NULL;
+    t->capacity = capacity;
+    t->mask = capacity - 1;
+    return t;
+}
+
+static size_t round_up_pow2(size_t n)
+{
+    size_t cap = RCU_MIN_CAPACITY;
+    while (cap < n)
+        cap <<= 1;
+    return cap;
+}
+
+/* 建新表并整体发布；读者可能仍在旧表上探测，旧表放进待回收列表 */
+static bool rcu_rehash(HashTableOARcu *h, size_t new_capacity)
+{
+    RcuTable *old = h->table;
+    RcuTable *t = table_create(new_capacity);
+    if (!t)
+        return false;
+
+    // entries are shared between the two tables, only the pointers are copied
+    for (size_t i = 0; i < old->capacity; i++)
+    {
+        RcuEntry *e = old->slots[i];
+        if (!e || e == RCU_TOMBSTONE)
+            continue;
+        size_t idx = e->hash & t->mask;
+        while (t->slots[idx])
+            idx = (idx + 1) & t->mask;
+        t->slots[idx] = e;
+    }
+
+    STORE(&h->table, t);
+    STORE_RELAXED(&h->capacity, new_capacity);
+    STORE_RELAXED(&h->tombstones, 0);
+    STORE_RELAXED(&h->resizes, h->resizes + 1);
+    rcu_retire(h, old, RETIRE_TABLE);
+    return true;
+}
+
+/* 预留共 n 个元素的空间：最多一次 rehash（顺带清掉墓碑） */
+static bool rcu_reserve(void *impl, size_t n)
+{
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    bool ok = true;
+    pthread_mutex_lock(&h->write_lock);
+    size_t cap = h->table->capacity;
+    while ((double)n > h->max_load_factor * cap && cap <= SIZE_MAX / 2)
+        cap <<= 1;
+    if (cap != h->table->capacity ||
+        (double)(n + h->tombstones) > h->max_load_factor * cap)
+        ok = rcu_rehash(h, cap);
+    pthread_mutex_unlock(&h->write_lock);
+    return ok;
+}
+
+/* 发布一张装下当前元素的最小新表（同时清掉墓碑），旧表照常等读者离开后回收 */
+static bool rcu_shrink_to_fit(void *impl)
+{
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    bool ok = true;
+    pthread_mutex_lock(&h->write_lock);
+    size_t size = h->size; // writers are serialised by write_lock
+    size_t cap = RCU_MIN_CAPACITY;
+    while ((double)size > h->max_load_factor * cap && cap <= SIZE_MAX / 2)
+        cap <<= 1;
+    if (cap < h->table->capacity || h->tombstones > 0)
+        ok = rcu_rehash(h, cap < h->table->capacity ? cap : h->table->capacity);
+    pthread_mutex_unlock(&h->write_lock);
+    return ok;
+}
+
+/*
+ * 写者查找：返回键所在的槽位，不存在时返回 SIZE_MAX
+ * free_slot 为探测路径上第一个可插入的槽位（墓碑或空）
+ */
+static size_t find_slot(HashTableOARcu *h, const RcuTable *t, const void *key, size_t hash,
+                        size_t *free_slot)
+{
+    size_t idx = hash & t->mask;
+    *free_slot = SIZE_MAX;
+    for (size_t n = 0; n < t->capacity; n++, idx = (idx + 1) & t->mask)
+    {
+        RcuEntry *e = t->slots[idx];
+        if (!e)
+        {
+            if (*free_slot == SIZE_MAX)
+                *free_slot = idx;
+            break;
+        }
+        if (e == RCU_TOMBSTONE)
+        {
+            if (*free_slot == SIZE_MAX)
+                *free_slot = idx;
+            continue;
+        }
+        if (e->hash == hash && h->keyops.eq(key, keystore_get(&h->keys, &e->key, e->keysz)) == 0)
+            return idx;
+    }
+    return SIZE_MAX;
+}
+
+/* 替换值；旧值等宽限期过后再交给 destroy_val */
+static void replace_value(HashTableOARcu *h, RcuEntry *e, void *value)
+{
+    void *old = e->value;
+    if (old == value)
+        return;
+    STORE(&e->value, value);
+    if (h->keyops.destroy_val && old)
+        rcu_retire(h, old, RETIRE_VALUE);
+}
+
+static bool rcu_insert(void *impl, const void *key, size_t keysz, void *value)
+{
+    if (!impl) return false;
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    size_t hash = ht_hash(&h->keyops, key, keysz);
+    bool ok = false;
+
+    pthread_mutex_lock(&h->write_lock);
+    RcuTable *t = h->table;
+    // grow when live entries pass half the threshold, otherwise just drop tombstones
+    if ((double)(h->size + h->tombstones + 1) > h->max_load_factor * t->capacity)
+    {
+        size_t cap = t->capacity;
+        if ((double)(h->size + 1) > h->max_load_factor * cap / 2)
+            cap <<= 1;
+        if (!rcu_rehash(h, cap))
+            goto out;
+        t = h->table;
+    }
+
+    size_t free_slot;
+    size_t idx = find_slot(h, t, key, hash, &free_slot);
+    if (idx != SIZE_MAX)
+    {
+        replace_value(h, t->slots[idx], value);
+        ok = true;
+        goto out;
+    }
+
+    RcuEntry *e = malloc(sizeof(RcuEntry));
+    if (!e)
+        goto out;
+    if (!keystore_put(&h->keys, &e->key, key, keysz))
+    {
+        free(e);
+        goto out;
+    }
+    e->hash = hash;
+    e->keysz = keysz;
+    e->value = value;
+
+    if (t->slots[free_slot] == RCU_TOMBSTONE)
+        STORE_RELAXED(&h->tombstones, h->tombstones - 1);
+    STORE(&t->slots[free_slot], e); // publishes the fully built entry
+    STORE_RELAXED(&h->size, h->size + 1);
+    ok = true;
+out:
+    pthread_mutex_unlock(&h->write_lock);
+    return ok;
+}
+
+static void *rcu_search(void *impl, const void *key, size_t keysz)
+{
+    if (!impl) return NULL;
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    size_t hash = ht_hash(&h->keyops, key, keysz);
+    void *value = NULL;
+
+    unsigned token = rcu_enter(h);
+    RcuTable *t = LOAD(&h->table);
+    size_t idx = hash & t->mask;
+    for (size_t n = 0; n < t->capacity; n++, idx = (idx + 1) & t->mask)
+    {
+        RcuEntry *e = LOAD(&t->slots[idx]);
+        if (!e)
+            break;
+        if (e != RCU_TOMBSTONE && e->hash == hash &&
+            h->keyops.eq(key, keystore_get(&h->keys, &e->key, e->keysz)) == 0)
+        {
+            value = LOAD(&e->value);
+            break;
+        }
+    }
+    rcu_exit(h, token);
+    return value;
+}
+
+static bool rcu_erase(void *impl, const void *key, size_t keysz)
+{
+    if (!impl) return false;
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    size_t hash = ht_hash(&h->keyops, key, keysz);
+
+    pthread_mutex_lock(&h->write_lock);
+    RcuTable *t = h->table;
+    size_t free_slot;
+    size_t idx = find_slot(h, t, key, hash, &free_slot);
+    if (idx != SIZE_MAX)
+    {
+        RcuEntry *e = t->slots[idx];
+        STORE(&t->slots[idx], RCU_TOMBSTONE);
+        STORE_RELAXED(&h->size, h->size - 1);
+        STORE_RELAXED(&h->tombstones, h->tombstones + 1);
+        rcu_retire(h, e, RETIRE_ENTRY);
+    }
+    pthread_mutex_unlock(&h->write_lock);
+    return idx != SIZE_MAX;
+}
+
+static bool rcu_update(void *impl, const void *key, size_t keysz, void *new_value)
+{
+    if (!impl) return false;
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    size_t hash = ht_hash(&h->keyops, key, keysz);
+
+    pthread_mutex_lock(&h->write_lock);
+    size_t free_slot;
+    size_t idx = find_slot(h, h->table, key, hash, &free_slot);
+    if (idx != SIZE_MAX)
+        replace_value(h, h->table->slots[idx], new_value);
+    pthread_mutex_unlock(&h->write_lock);
+    return idx != SIZE_MAX;
+}
+
+static size_t rcu_size(const void *impl)
+{
+    if (!impl) return 0;
+    return LOAD_RELAXED(&((const HashTableOARcu *)impl)->size);
+}
+
+static size_t rcu_capacity(const void *impl)
+{
+    if (!impl) return 0;
+    return LOAD_RELAXED(&((const HashTableOARcu *)impl)->capacity);
+}
+
+static double rcu_load_factor(const void *impl)
+{
+    if (!impl) return -1.;
+    return (double)rcu_size(impl) / rcu_capacity(impl);
+}
+
+/* 在读临界区内扫描当前表；写者可以同时修改，结果是近似快照 */
+static HashStats rcu_stats(const void *impl)
+{
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    HashStats hs = {0};
+    size_t dist_sum = 0, miss_sum = 0;
+
+    unsigned token = rcu_enter(h);
+    RcuTable *t = LOAD(&h->table);
+    size_t empty = SIZE_MAX;
+    for (size_t i = 0; i < t->capacity; i++)
+    {
+        RcuEntry *e = LOAD(&t->slots[i]);
+        if (!e)
+        {
+            if (empty == SIZE_MAX)
+                empty = i;
+            continue;
+        }
+        if (e == RCU_TOMBSTONE)
+        {
+            hs.tombstones++;
+            continue;
+        }
+        size_t probes = ((i - (e->hash & t->mask)) & t->mask) + 1;
+        hs.total_elements++;
+        hs.histogram[ht_hist_bin(probes)]++;
+        dist_sum += probes;
+        if (probes > 1)
+            hs.collision_count++;
+        if (hs.max_chain_or_probe < probes)
+            hs.max_chain_or_probe = probes;
+    }
+    // a miss starting at slot i walks the run up to the next empty slot;
+    // walk backwards from an empty slot so runs are counted with wrap-around
+    for (size_t n = 0, run = 0, i = empty; empty != SIZE_MAX && n < t->capacity;
+         n++, i = (i - 1) & t->mask)
+    {
+        run = LOAD(&t->slots[i]) ? run + 1 : 0;
+        miss_sum += run + 1;
+    }
+    size_t capacity = t->capacity;
+    rcu_exit(h, token);
+
+    hs.used_buckets = hs.total_elements;
+    hs.average_chain_length = hs.total_elements ? (double)dist_sum / hs.total_elements : 0.0;
+    hs.avg_probe_success = hs.average_chain_length;
+    hs.avg_probe_failure = empty != SIZE_MAX ? (double)miss_sum / capacity : (double)capacity;
+    hs.resize_count = LOAD_RELAXED(&h->resizes);
+    hs.bytes_used = sizeof(HashTableOARcu) + sizeof(RcuTable) + capacity * sizeof(RcuEntry *)
+                  + hs.total_elements * sizeof(RcuEntry) + LOAD_RELAXED(&h->keys.bytes);
+    return hs;
+}
+
+/*
+ * 在读临界区内遍历当前表，与写者并发时看到的是近似快照；
+ * 回调中不能调用写操作（写者会等这个读临界区结束）
+ */
+static bool rcu_foreach(void *impl, hashtable_visit_t visit, void *ctx)
+{
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    bool done = true;
+    unsigned token = rcu_enter(h);
+    RcuTable *t = LOAD(&h->table);
+    for (size_t i = 0; i < t->capacity && done; i++)
+    {
+        RcuEntry *e = LOAD(&t->slots[i]);
+        if (e && e != RCU_TOMBSTONE)
+            done = visit(keystore_get(&h->keys, &e->key, e->keysz), e->keysz, LOAD(&e->value), ctx);
+    }
+    rcu_exit(h, token);
+    return done;
+}
+
+/*
+ * 每次调用单独进出读临界区；两次调用之间发生 rehash 时槽位下标换了一张表，
+ * 遍历可能漏掉或重复元素（弱一致）。key/value 的有效期同 search：
+ * 要在后续调用中继续使用时，由调用方用 hashtable_rcu_read_lock 包住整个遍历
+ */
+static bool rcu_iter_next(void *impl, HashIter *it)
+{
+    HashTableOARcu *h = (HashTableOARcu *)impl;
+    bool found = false;
+    unsigned token = rcu_enter(h);
+    RcuTable *t = LOAD(&h->table);
+    for (size_t i = it->pos; i < t->capacity; i++)
+    {
+        RcuEntry *e = LOAD(&t->slots[i]);
+        if (!e || e == RCU_TOMBSTONE)
+            continue;
+        it->pos = i + 1;
+        it->key = keystore_get(&h->keys, &e->key, e->keysz);
+        it->keysz = e->keysz;
+        it->value = LOAD(&e->value);
+        found = true;
+        break;
+    }
+    if (!found)
+        it->pos = t->capacity;
+    rcu_exit(h, token);
+    return found;
+}
+
+static void rcu_destroy(void **pimpl)
+{
+    if (!pimpl || !*pimpl) return;
+    HashTableOARcu *h = (HashTableOARcu *)(*pimpl);
+
+    // no readers may be left at this point
+    rcu_reclaim(h, false);
+    RcuTable *t = h->table;
+    for (size_t i = 0; i < t->capacity; i++)
+    {
+        RcuEntry *e = t->slots[i];
+        if (e && e != RCU_TOMBSTONE)
+            free_retired(h, (Retired){e, RETIRE_ENTRY});
+    }
+    free(t);
+    keystore_destroy(&h->keys);
+    pthread_mutex_destroy(&h->write_lock);
+    free(h);
+    *pimpl = NULL;
+}
+
+HashTable *hashtable_oa_rcu_create(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops)
+{
+    void *mem = NULL;
+    if (posix_memalign(&mem, RCU_CACHELINE, sizeof(HashTableOARcu)) != 0)
+        return NULL;
+    HashTableOARcu *impl = (HashTableOARcu *)mem;
+    memset(impl, 0, sizeof(*impl));
+
+    impl->capacity = round_up_pow2(initial_capacity);
+    impl->table = table_create(impl->capacity);
+    if (!impl->table || pthread_mutex_init(&impl->write_lock, NULL) != 0)
+    {
+        free(impl->table);
+        free(impl);
+        return NULL;
+    }
+    impl->max_load_factor =
+        (max_load_factor <= 0 || max_load_factor >= 1) ? 0.75 : max_load_factor;
+    keyops = ht_seed_keyops(keyops);
+    impl->keyops = keyops;
+    keystore_init(&impl->keys, keyops.destroy_key);
+
+    HashOps ops = {
+        .insert = rcu_insert,
+        .search = rcu_search,
+        .erase = rcu_erase,
+        .update = rcu_update,
+        .reserve = rcu_reserve,
+        .shrink_to_fit = rcu_shrink_to_fit,
+        .size = rcu_size,
+        .capacity = rcu_capacity,
+        .load_factor = rcu_load_factor,
+        .stats = rcu_stats,
+        .foreach = rcu_foreach,
+        .iter_next = rcu_iter_next,
+        .destroy = rcu_destroy,
+    };
+
+    return ht_create_from_impl(impl, ops, keyops);
+}
@@ -0,0 +1,47 @@
+// hashtable_oa_rcu.h
+#pragma once
+#include "hashtable.h"
+
+/*
+ * 读无锁的开放地址法哈希表（单写者、多读者）
+ * - 线性探测，容量为 2 的幂；每个槽位只是一个原子指针：NULL 为空、特殊值为墓碑，
+ *   其余指向不可变的条目（哈希 + 键 + 原子的值指针）
+ * - hashtable_search 不加任何锁：读者只做原子读，并在按线程分散的计数器上登记，
+ *   不会与写者或其他读者争抢同一条 cache line
+ * - 写操作（insert/erase/update 及由此触发的 rehash）由内部的写者锁串行化；
+ *   rehash 建好新表后用一次原子指针替换发布（RCU），旧表延后释放
+ * - 被删除的条目、被替换的值、旧表都放进待回收列表，等所有可能看到它们的读者离开后
+ *   （基于两个 epoch 的宽限期）才释放键、调用 destroy_val、free
+ * - 调用者若要在 hashtable_search 返回后继续使用值，需用 hashtable_rcu_read_lock/unlock
+ *   把查找和使用包在同一个读临界区里；临界区内不能调用写操作
+ */
+
+typedef struct HashTableOARcu HashTableOARcu;
+
+/**
+ * 创建读无锁的开放地址法哈希表
+ * @param initial_capacity 初始槽位数（向上取整为 2 的幂，0 表示默认值 8）
+ * @param max_load_factor  元素与墓碑合计占比的阈值，超过后 rehash；<= 0 或 >= 1 时取 0.75
+ * @param keyops           键相关回调（hash/eq/destroy），hash/eq 会被读者并发调用
+ * @return 以统一接口 HashTable* 返回
+ */
+HashTable *hashtable_oa_rcu_create(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops
+);
+
+/**
+ * 进入读临界区；可嵌套，返回值需原样传给 hashtable_rcu_read_unlock
+ * 临界区内查到的值在离开前不会被 destroy_val 释放
+ */
+unsigned hashtable_rcu_read_lock(HashTable *ht);
+void hashtable_rcu_read_unlock(HashTable *ht, unsigned token);
+
+#ifdef HASHTABLE_RCU_TEST_HOOKS
+/* 仅测试用：读者读到 epoch 之后、登记到计数器之前调用，用来制造读者在这两步之间的停顿 */
+extern void (*hashtable_rcu_enter_stall)(void);
+
+/* 仅测试用：无条件走一次宽限期（翻转 epoch 并等待旧 epoch 的读者），然后释放待回收列表 */
+void hashtable_rcu_test_synchronize(HashTable *ht);
+#endif
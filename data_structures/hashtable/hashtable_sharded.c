@@ -0,0 +1,421 @@
+// data_structures/hashtable/hashtable_sharded.c
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "hashtable_sharded.h"
+#include "hashtable_internal.h"
+
+#define SHARDED_DEFAULT_SHARDS 16
+#define SHARD_CACHELINE 64
+#define SIZE_BITS (sizeof(size_t) * 8)
+// hashtable_build: below this many keys threads cost more than they save
+#define SHARDED_BUILD_PARALLEL_MIN 8192
+#define SHARDED_BUILD_MAX_THREADS 64
+
+// one shard per cache line so threads working on neighbouring shards don't
+// bounce each other's lock
+typedef union Shard
+{
+    struct
+    {
+        pthread_mutex_t lock;
+        HashTable *ht;
+    } s;
+    char pad[((sizeof(pthread_mutex_t) + sizeof(HashTable *) + SHARD_CACHELINE - 1)
+              / SHARD_CACHELINE) * SHARD_CACHELINE];
+} Shard;
+
+struct HashTableSharded
+{
+    Shard *shards;
+    size_t nshards; // power of two
+    unsigned bits;  // log2(nshards)
+    HashKeyOps keyops; // shard 0's hash and seed route every key
+};
+
+static inline size_t shard_index(const HashTableSharded *hts, const void *key, size_t keysz)
+{
+    if (hts->bits == 0)
+        return 0;
+    // high bits pick the shard; the backend indexes with the low bits
+    return ht_hash(&hts->keyops, key, keysz) >> (SIZE_BITS - hts->bits);
+}
+
+static inline Shard *shard_for(const HashTableSharded *hts, const void *key, size_t keysz)
+{
+    return &hts->shards[shard_index(hts, key, keysz)];
+}
+
+static bool sharded_insert(void *impl, const void *key, size_t keysz, void *value)
+{
+    Shard *sh = shard_for((HashTableSharded *)impl, key, keysz);
+    pthread_mutex_lock(&sh->s.lock);
+    bool ok = hashtable_insert(sh->s.ht, key, keysz, value);
+    pthread_mutex_unlock(&sh->s.lock);
+    return ok;
+}
+
+static void *sharded_search(void *impl, const void *key, size_t keysz)
+{
+    Shard *sh = shard_for((HashTableSharded *)impl, key, keysz);
+    pthread_mutex_lock(&sh->s.lock);
+    void *value = hashtable_search(sh->s.ht, key, keysz);
+    pthread_mutex_unlock(&sh->s.lock);
+    return value;
+}
+
+static bool sharded_erase(void *impl, const void *key, size_t keysz)
+{
+    Shard *sh = shard_for((HashTableSharded *)impl, key, keysz);
+    pthread_mutex_lock(&sh->s.lock);
+    bool ok = hashtable_delete(sh->s.ht, key, keysz);
+    pthread_mutex_unlock(&sh->s.lock);
+    return ok;
+}
+
+static bool sharded_update(void *impl, const void *key, size_t keysz, void *new_value)
+{
+    Shard *sh = shard_for((HashTableSharded *)impl, key, keysz);
+    pthread_mutex_lock(&sh->s.lock);
+    bool ok = hashtable_update(sh->s.ht, key, keysz, new_value);
+    pthread_mutex_unlock(&sh->s.lock);
+    return ok;
+}
+
+static size_t isqrt(size_t x)
+{
+    size_t r = 0;
+    for (size_t bit = (size_t)1 << (SIZE_BITS - 2); bit; bit >>= 2)
+    {
+        if (x >= r + bit)
+        {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+        {
+            r >>= 1;
+        }
+    }
+    return r;
+}
+
+static bool sharded_shrink_to_fit(void *impl)
+{
+    HashTableSharded *hts = (HashTableSharded *)impl;
+    bool ok = true;
+    for (size_t i = 0; i < hts->nshards; i++)
+    {
+        Shard *sh = &hts->shards[i];
+        pthread_mutex_lock(&sh->s.lock);
+        ok &= hashtable_shrink_to_fit(sh->s.ht);
+        pthread_mutex_unlock(&sh->s.lock);
+    }
+    return ok;
+}
+
+/*
+ * 键按哈希高位均匀落到各分片：每个分片预留平均值再加 4 个标准差，
+ * 总数到 n 之前基本不会有分片需要扩容
+ */
+static bool sharded_reserve(void *impl, size_t n)
+{
+    HashTableSharded *hts = (HashTableSharded *)impl;
+    size_t mean = n / hts->nshards + 1;
+    size_t per_shard = mean + 4 * isqrt(mean);
+    bool ok = true;
+    for (size_t i = 0; i < hts->nshards; i++)
+    {
+        Shard *sh = &hts->shards[i];
+        pthread_mutex_lock(&sh->s.lock);
+        if (sh->s.ht->ops.reserve)
+            ok &= sh->s.ht->ops.reserve(sh->s.ht->impl, hashtable_size(sh->s.ht) + per_shard);
+        pthread_mutex_unlock(&sh->s.lock);
+    }
+    return ok;
+}
+
+/* 并行建表：键已按分片排好，工作线程每次领一个分片，各自加锁填充 */
+typedef struct
+{
+    HashTableSharded *hts;
+    const void **keys;
+    const size_t *keyszs;
+    void **vals;
+    const size_t *start; // shard i owns [start[i], start[i + 1])
+    size_t next_shard;   // atomic
+    size_t inserted;     // atomic
+} BuildJob;
+
+static void *build_worker(void *arg)
+{
+    BuildJob *job = (BuildJob *)arg;
+    size_t i;
+    while ((i = __atomic_fetch_add(&job->next_shard, 1, __ATOMIC_RELAXED)) < job->hts->nshards)
+    {
+        Shard *sh = &job->hts->shards[i];
+        size_t b = job->start[i], cnt = job->start[i + 1] - b;
+        pthread_mutex_lock(&sh->s.lock);
+        size_t done = hashtable_build(sh->s.ht, job->keys + b, job->keyszs + b, job->vals + b, cnt);
+        pthread_mutex_unlock(&sh->s.lock);
+        __atomic_fetch_add(&job->inserted, done, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+static size_t sharded_build(void *impl, const void **keys, const size_t *keyszs, void **vals,
+                            size_t n)
+{
+    HashTableSharded *hts = (HashTableSharded *)impl;
+    size_t *idx = malloc(n * sizeof(size_t));
+    size_t *start = calloc(hts->nshards + 1, sizeof(size_t));
+    size_t *pos = malloc(hts->nshards * sizeof(size_t));
+    const void **pkeys = malloc(n * sizeof(void *));
+    size_t *pkeyszs = malloc(n * sizeof(size_t));
+    void **pvals = malloc(n * sizeof(void *));
+    size_t inserted = 0;
+    if (!idx || !start || !pos || !pkeys || !pkeyszs || !pvals)
+    {
+        // no room to partition: insert one by one
+        for (size_t i = 0; i < n; i++)
+            inserted += sharded_insert(impl, keys[i], keyszs[i], vals[i]);
+        goto out;
+    }
+
+    // counting sort by shard; order within a shard is kept, so later duplicates still win
+    for (size_t i = 0; i < n; i++)
+    {
+        idx[i] = shard_index(hts, keys[i], keyszs[i]);
+        start[idx[i] + 1]++;
+    }
+    for (size_t s = 0; s < hts->nshards; s++)
+        start[s + 1] += start[s];
+    memcpy(pos, start, hts->nshards * sizeof(size_t));
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t p = pos[idx[i]]++;
+        pkeys[p] = keys[i];
+        pkeyszs[p] = keyszs[i];
+        pvals[p] = vals[i];
+    }
+
+    BuildJob job = {hts, pkeys, pkeyszs, pvals, start, 0, 0};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = cpus > 1 ? (size_t)cpus : 1;
+    if (nthreads > hts->nshards)
+        nthreads = hts->nshards;
+    if (nthreads > SHARDED_BUILD_MAX_THREADS)
+        nthreads = SHARDED_BUILD_MAX_THREADS;
+    if (n < SHARDED_BUILD_PARALLEL_MIN)
+        nthreads = 1;
+
+    // the calling thread is one of the workers; a thread that fails to start is just skipped
+    pthread_t threads[SHARDED_BUILD_MAX_THREADS];
+    size_t started = 0;
+    for (size_t t = 1; t < nthreads; t++)
+        if (pthread_create(&threads[started], NULL, build_worker, &job) == 0)
+            started++;
+    build_worker(&job);
+    for (size_t t = 0; t < started; t++)
+        pthread_join(threads[t], NULL);
+    inserted = job.inserted;
+
+out:
+    free(idx);
+    free(start);
+    free(pos);
+    free(pkeys);
+    free(pkeyszs);
+    free(pvals);
+    return inserted;
+}
+
+static size_t sharded_size(const void *impl)
+{
+    const HashTableSharded *hts = (const HashTableSharded *)impl;
+    size_t total = 0;
+    for (size_t i = 0; i < hts->nshards; i++)
+    {
+        Shard *sh = &hts->shards[i];
+        pthread_mutex_lock(&sh->s.lock);
+        total += hashtable_size(sh->s.ht);
+        pthread_mutex_unlock(&sh->s.lock);
+    }
+    return total;
+}
+
+static size_t sharded_capacity(const void *impl)
+{
+    const HashTableSharded *hts = (const HashTableSharded *)impl;
+    size_t total = 0;
+    for (size_t i = 0; i < hts->nshards; i++)
+    {
+        Shard *sh = &hts->shards[i];
+        pthread_mutex_lock(&sh->s.lock);
+        total += hashtable_capacity(sh->s.ht);
+        pthread_mutex_unlock(&sh->s.lock);
+    }
+    return total;
+}
+
+static double sharded_load_factor(const void *impl)
+{
+    size_t capacity = sharded_capacity(impl);
+    return capacity ? (double)sharded_size(impl) / capacity : 0.0;
+}
+
+/* 各分片统计之和；平均值按元素数（未命中按分片数）加权 */
+static HashStats sharded_stats(const void *impl)
+{
+    const HashTableSharded *hts = (const HashTableSharded *)impl;
+    HashStats hs = {0};
+    double chain_sum = 0.0, success_sum = 0.0, failure_sum = 0.0;
+
+    for (size_t i = 0; i < hts->nshards; i++)
+    {
+        Shard *sh = &hts->shards[i];
+        pthread_mutex_lock(&sh->s.lock);
+        HashStats s = hashtable_get_stats(sh->s.ht);
+        pthread_mutex_unlock(&sh->s.lock);
+
+        hs.total_elements += s.total_elements;
+        hs.used_buckets += s.used_buckets;
+        if (hs.max_chain_or_probe < s.max_chain_or_probe)
+            hs.max_chain_or_probe = s.max_chain_or_probe;
+        hs.collision_count += s.collision_count;
+        for (size_t b = 0; b < HT_HIST_BUCKETS; b++)
+            hs.histogram[b] += s.histogram[b];
+        hs.tombstones += s.tombstones;
+        hs.resize_count += s.resize_count;
+        hs.bytes_used += s.bytes_used;
+        chain_sum += s.average_chain_length;
+        success_sum += s.avg_probe_success * s.total_elements;
+        failure_sum += s.avg_probe_failure;
+    }
+    hs.average_chain_length = chain_sum / hts->nshards;
+    hs.avg_probe_success = hs.total_elements ? success_sum / hs.total_elements : 0.0;
+    hs.avg_probe_failure = failure_sum / hts->nshards;
+    hs.bytes_used += sizeof(HashTableSharded) + hts->nshards * sizeof(Shard);
+    return hs;
+}
+
+/* it->shard 是当前分片，pos/node 原样交给分片的后端；只在每次调用期间持有分片锁 */
+static bool sharded_iter_next(void *impl, HashIter *it)
+{
+    HashTableSharded *hts = (HashTableSharded *)impl;
+    for (; it->shard < hts->nshards; it->shard++)
+    {
+        Shard *sh = &hts->shards[it->shard];
+        pthread_mutex_lock(&sh->s.lock);
+        bool found = sh->s.ht->ops.iter_next(sh->s.ht->impl, it);
+        pthread_mutex_unlock(&sh->s.lock);
+        if (found)
+            return true;
+        it->pos = 0;
+        it->node = NULL;
+    }
+    return false;
+}
+
+/*
+ * 用游标逐个取元素，调用 visit 时不持有分片锁，
+ * 所以回调里可以查找和 update 同一张表（同一分片的锁不会被重复加）
+ */
+static bool sharded_foreach(void *impl, hashtable_visit_t visit, void *ctx)
+{
+    HashIter it = {0, NULL, 0, NULL, 0, NULL};
+    while (sharded_iter_next(impl, &it))
+    {
+        if (!visit(it.key, it.keysz, it.value, ctx))
+            return false;
+    }
+    return true;
+}
+
+static void shards_destroy(Shard *shards, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        hashtable_destroy(&shards[i].s.ht);
+        pthread_mutex_destroy(&shards[i].s.lock);
+    }
+    free(shards);
+}
+
+static void sharded_destroy(void **pimpl)
+{
+    if (!pimpl || !*pimpl) return;
+    HashTableSharded *hts = (HashTableSharded *)(*pimpl);
+    shards_destroy(hts->shards, hts->nshards);
+    free(hts);
+    *pimpl = NULL;
+}
+
+HashTable *hashtable_sharded_create(
+    size_t nshards,
+    hashtable_factory_t backend_factory,
+    void *ctx)
+{
+    if (!backend_factory)
+        return NULL;
+    if (nshards == 0)
+        nshards = SHARDED_DEFAULT_SHARDS;
+    unsigned bits = 0;
+    while (((size_t)1 << bits) < nshards)
+        bits++;
+    nshards = (size_t)1 << bits;
+
+    HashTableSharded *impl = malloc(sizeof(HashTableSharded));
+    if (!impl)
+        return NULL;
+    void *mem = NULL;
+    if (posix_memalign(&mem, SHARD_CACHELINE, nshards * sizeof(Shard)) != 0)
+    {
+        free(impl);
+        return NULL;
+    }
+    impl->shards = (Shard *)mem;
+    impl->nshards = nshards;
+    impl->bits = bits;
+
+    for (size_t i = 0; i < nshards; i++)
+    {
+        Shard *sh = &impl->shards[i];
+        sh->s.ht = backend_factory(ctx);
+        if (!sh->s.ht || pthread_mutex_init(&sh->s.lock, NULL) != 0)
+        {
+            hashtable_destroy(&sh->s.ht);
+            shards_destroy(impl->shards, i);
+            free(impl);
+            return NULL;
+        }
+    }
+    HashKeyOps keyops = impl->shards[0].s.ht->kops;
+    impl->keyops = keyops;
+
+    HashOps ops = {
+        .insert = sharded_insert,
+        .search = sharded_search,
+        .erase = sharded_erase,
+        .update = sharded_update,
+        .reserve = sharded_reserve,
+        .shrink_to_fit = sharded_shrink_to_fit,
+        .build = sharded_build,
+        .size = sharded_size,
+        .capacity = sharded_capacity,
+        .load_factor = sharded_load_factor,
+        .stats = sharded_stats,
+        .foreach = sharded_foreach,
+        .iter_next = sharded_iter_next,
+        .destroy = sharded_destroy,
+    };
+
+    return ht_create_from_impl(impl, ops, keyops);
+}
@@ -0,0 +1,37 @@
+// hashtable_sharded.h
+#pragma once
+#include "hashtable.h"
+
+/*
+ * 分片（striped lock）并发哈希表
+ * - 内部持有 nshards 张互相独立的 HashTable（链地址/开放地址等任意后端），每张一把互斥锁
+ * - 键按哈希值的高位路由到分片：各分片内部用低位定位桶/槽位，两者互不干扰
+ * - 对外仍是 HashTable*，所有 hashtable_* 接口可被多个线程同时调用；
+ *   不同分片上的操作互不阻塞，线程数不超过分片数时吞吐接近线性增长
+ * - 分片锁是互斥锁而非读写锁：渐进式扩容、统计计数会让查找也修改表
+ * - hashtable_search 返回的值指针在解锁后才交给调用者，值的生命周期由调用者保证
+ *   （其他线程删除该键并通过 destroy_val 释放值时不可再访问）
+ * - size/capacity/stats 逐个分片加锁汇总，不是整张表的原子快照
+ */
+
+typedef struct HashTableSharded HashTableSharded;
+
+/**
+ * 创建分片所用的后端哈希表；每个分片调用一次
+ * @param ctx hashtable_sharded_create 传入的上下文（如每个分片的初始容量）
+ * @return 新建的哈希表，失败返回 NULL；所有分片必须使用相同的 keyops
+ */
+typedef HashTable *(*hashtable_factory_t)(void *ctx);
+
+/**
+ * 创建分片并发哈希表
+ * @param nshards         分片数（向上取整为 2 的幂，0 表示默认值 16）；通常取线程数的 2~4 倍
+ * @param backend_factory 创建单个分片的函数
+ * @param ctx             原样传给 backend_factory
+ * @return 以统一接口 HashTable* 返回；任一分片创建失败时返回 NULL
+ */
+HashTable *hashtable_sharded_create(
+    size_t nshards,
+    hashtable_factory_t backend_factory,
+    void *ctx
+);
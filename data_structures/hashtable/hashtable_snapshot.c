@@ -0,0 +1,471 @@
+// data_structures/hashtable/hashtable_snapshot.c
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "hashtable_snapshot.h"
+#include "hashtable_internal.h"
+#include "hash.h"
+
+#define SNAP_MAGIC "HTSNAP01"
+#define SNAP_VERSION 1u
+#define SNAP_BYTE_ORDER 0x01020304u // reads back differently on a foreign-endian host
+#define SNAP_VALUE_ALIGN 16
+#define SNAP_MIN_CAPACITY 8
+#define SNAP_WRITE_BUFFER (1 << 20)
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t count;
+    uint64_t capacity;   // power of two
+    uint64_t value_size; // 0: slot.value is the saved pointer bits
+    uint64_t seed;       // hash_fast_seeded seed for every slot hash
+    uint64_t slots_off;
+    uint64_t file_size;
+} SnapHeader;
+
+typedef struct
+{
+    uint64_t hash;
+    uint64_t key_off; // 0 marks an empty slot (offset 0 is the header)
+    uint64_t keysz;
+    uint64_t value;   // pointer bits, or offset of value_size bytes (0 for NULL)
+} SnapSlot;
+
+// the layout is part of the file format
+typedef char snap_header_is_64_bytes[sizeof(SnapHeader) == 64 ? 1 : -1];
+typedef char snap_slot_is_32_bytes[sizeof(SnapSlot) == 32 ? 1 : -1];
+
+static inline uint64_t snap_hash(const void *key, size_t keysz, uint64_t seed)
+{
+    return (uint64_t)hash_fast_seeded(key, keysz, seed);
+}
+
+static inline uint64_t align_up(uint64_t off, uint64_t align)
+{
+    return (off + align - 1) & ~(align - 1);
+}
+
+/* ========== save ========== */
+
+typedef struct
+{
+    const void *key;
+    size_t keysz;
+    void *value;
+} SnapEntry;
+
+typedef struct
+{
+    SnapEntry *v;
+    size_t n;
+    size_t cap;
+} SnapEntries;
+
+static bool collect_entry(const void *key, size_t keysz, void *value, void *ctx)
+{
+    SnapEntries *es = (SnapEntries *)ctx;
+    if (es->n == es->cap)
+    {
+        size_t cap = es->cap ? es->cap * 2 : 64;
+        SnapEntry *v = realloc(es->v, cap * sizeof(SnapEntry));
+        if (!v)
+            return false;
+        es->v = v;
+        es->cap = cap;
+    }
+    es->v[es->n++] = (SnapEntry){key, keysz, value};
+    return true;
+}
+
+/* 按条目顺序写出键和值；offset 的推进方式必须与 build_slots 相同 */
+static bool write_data(FILE *f, const SnapEntries *es, uint64_t off, size_t value_size)
+{
+    static const unsigned char zeros[SNAP_VALUE_ALIGN] = {0};
+    for (size_t i = 0; i < es->n; i++)
+    {
+        const SnapEntry *e = &es->v[i];
+        if (e->keysz && fwrite(e->key, 1, e->keysz, f) != e->keysz)
+            return false;
+        off += e->keysz;
+        if (value_size && e->value)
+        {
+            uint64_t pad = align_up(off, SNAP_VALUE_ALIGN) - off;
+            if (pad && fwrite(zeros, 1, pad, f) != pad)
+                return false;
+            if (fwrite(e->value, 1, value_size, f) != value_size)
+                return false;
+            off += pad + value_size;
+        }
+    }
+    return true;
+}
+
+/* 在 slots 中为每个条目找位置并分配键/值偏移；返回文件总长度 */
+static uint64_t build_slots(SnapSlot *slots, uint64_t capacity, const SnapEntries *es,
+                            uint64_t data_off, size_t value_size, uint64_t seed)
+{
+    uint64_t mask = capacity - 1;
+    uint64_t off = data_off;
+    for (size_t i = 0; i < es->n; i++)
+    {
+        const SnapEntry *e = &es->v[i];
+        uint64_t hash = snap_hash(e->key, e->keysz, seed);
+        uint64_t idx = hash & mask;
+        while (slots[idx].key_off)
+            idx = (idx + 1) & mask;
+
+        SnapSlot *s = &slots[idx];
+        s->hash = hash;
+        s->key_off = off;
+        s->keysz = e->keysz;
+        off += e->keysz;
+        if (!value_size)
+        {
+            s->value = (uint64_t)(uintptr_t)e->value;
+        }
+        else if (e->value)
+        {
+            off = align_up(off, SNAP_VALUE_ALIGN);
+            s->value = off;
+            off += value_size;
+        }
+    }
+    return off;
+}
+
+bool hashtable_save_ex(HashTable *ht, const char *path, size_t value_size)
+{
+    if (!ht || !path)
+        return false;
+
+    SnapEntries es = {NULL, 0, 0};
+    size_t n = hashtable_size(ht);
+    if (n && !(es.v = malloc(n * sizeof(SnapEntry))))
+        return false;
+    es.cap = n;
+    if (!hashtable_foreach(ht, collect_entry, &es))
+    {
+        free(es.v);
+        return false;
+    }
+
+    // load factor <= 0.5 keeps unsuccessful lookups short
+    uint64_t capacity = SNAP_MIN_CAPACITY;
+    while (capacity < 2 * (uint64_t)es.n)
+        capacity <<= 1;
+    SnapSlot *slots = calloc(capacity, sizeof(SnapSlot));
+    char *tmp = malloc(strlen(path) + 5);
+    FILE *f = NULL;
+    bool ok = slots && tmp;
+    if (ok)
+    {
+        SnapHeader hdr;
+        memset(&hdr, 0, sizeof hdr);
+        memcpy(hdr.magic, SNAP_MAGIC, sizeof hdr.magic);
+        hdr.version = SNAP_VERSION;
+        hdr.byte_order = SNAP_BYTE_ORDER;
+        hdr.count = es.n;
+        hdr.capacity = capacity;
+        hdr.value_size = value_size;
+        hdr.seed = ht_random_seed();
+        hdr.slots_off = sizeof(SnapHeader);
+        uint64_t data_off = hdr.slots_off + capacity * sizeof(SnapSlot);
+        hdr.file_size = build_slots(slots, capacity, &es, data_off, value_size, hdr.seed);
+
+        // write next to the target and rename, so a crash never leaves a torn snapshot
+        strcpy(tmp, path);
+        strcat(tmp, ".tmp");
+        f = fopen(tmp, "wb");
+        ok = f != NULL;
+        if (ok)
+            setvbuf(f, NULL, _IOFBF, SNAP_WRITE_BUFFER);
+        ok = ok && fwrite(&hdr, sizeof hdr, 1, f) == 1 &&
+             fwrite(slots, sizeof(SnapSlot), capacity, f) == capacity &&
+             write_data(f, &es, data_off, value_size) && fflush(f) == 0 &&
+             fsync(fileno(f)) == 0;
+        if (f && fclose(f) != 0)
+            ok = false;
+        if (f && !ok)
+            remove(tmp);
+        ok = ok && rename(tmp, path) == 0;
+    }
+    free(tmp);
+    free(slots);
+    free(es.v);
+    return ok;
+}
+
+bool hashtable_save(HashTable *ht, const char *path)
+{
+    return hashtable_save_ex(ht, path, 0);
+}
+
+/* ========== read-only mapped table ========== */
+
+typedef struct
+{
+    const unsigned char *base;
+    size_t file_size;
+    const SnapHeader *hdr;
+    const SnapSlot *slots;
+    uint64_t mask;
+    uint64_t seed;
+    size_t value_size;
+} HashTableMapped;
+
+/* 键/值所在的区间必须落在文件内：损坏或被截断的文件不能导致越界读 */
+static inline bool in_file(const HashTableMapped *m, uint64_t off, uint64_t len)
+{
+    return off <= m->file_size && len <= m->file_size - off;
+}
+
+static const SnapSlot *mapped_find(const HashTableMapped *m, const void *key, size_t keysz,
+                                   uint64_t hash)
+{
+    uint64_t idx = hash & m->mask;
+    for (uint64_t step = 0; step <= m->mask; step++, idx = (idx + 1) & m->mask)
+    {
+        const SnapSlot *s = &m->slots[idx];
+        if (!s->key_off)
+            return NULL;
+        if (s->hash == hash && s->keysz == keysz && in_file(m, s->key_off, keysz) &&
+            memcmp(m->base + s->key_off, key, keysz) == 0)
+            return s;
+    }
+    return NULL;
+}
+
+static inline void *mapped_value(const HashTableMapped *m, const SnapSlot *s)
+{
+    if (!s)
+        return NULL;
+    if (!m->value_size)
+        return (void *)(uintptr_t)s->value;
+    // the mapping is read-only; callers must not write through this pointer
+    return s->value && in_file(m, s->value, m->value_size)
+               ? (void *)(uintptr_t)(m->base + s->value)
+               : NULL;
+}
+
+static void *mapped_search(void *impl, const void *key, size_t keysz)
+{
+    const HashTableMapped *m = (const HashTableMapped *)impl;
+    return mapped_value(m, mapped_find(m, key, keysz, snap_hash(key, keysz, m->seed)));
+}
+
+static size_t mapped_search_batch(void *impl, const void **keys, const size_t *keyszs,
+                                  size_t n, void **out)
+{
+    const HashTableMapped *m = (const HashTableMapped *)impl;
+    uint64_t hashes[HT_BATCH];
+    size_t found = 0;
+    for (size_t base = 0; base < n; base += HT_BATCH)
+    {
+        size_t cnt = n - base < HT_BATCH ? n - base : HT_BATCH;
+        for (size_t i = 0; i < cnt; i++)
+        {
+            hashes[i] = snap_hash(keys[base + i], keyszs[base + i], m->seed);
+            HT_PREFETCH(&m->slots[hashes[i] & m->mask]);
+        }
+        for (size_t i = 0; i < cnt; i++)
+        {
+            out[base + i] = mapped_value(
+                m, mapped_find(m, keys[base + i], keyszs[base + i], hashes[i]));
+            found += out[base + i] != NULL;
+        }
+    }
+    return found;
+}
+
+static bool mapped_insert(void *impl, const void *key, size_t keysz, void *value)
+{
+    (void)impl; (void)key; (void)keysz; (void)value;
+    return false; // read-only
+}
+
+static bool mapped_erase(void *impl, const void *key, size_t keysz)
+{
+    (void)impl; (void)key; (void)keysz;
+    return false;
+}
+
+static bool mapped_update(void *impl, const void *key, size_t keysz, void *new_value)
+{
+    (void)impl; (void)key; (void)keysz; (void)new_value;
+    return false;
+}
+
+static size_t mapped_size(const void *impl)
+{
+    return (size_t)((const HashTableMapped *)impl)->hdr->count;
+}
+
+static size_t mapped_capacity(const void *impl)
+{
+    return (size_t)((const HashTableMapped *)impl)->hdr->capacity;
+}
+
+static double mapped_load_factor(const void *impl)
+{
+    return (double)mapped_size(impl) / mapped_capacity(impl);
+}
+
+static HashStats mapped_stats(const void *impl)
+{
+    const HashTableMapped *m = (const HashTableMapped *)impl;
+    HashStats hs = {0};
+    size_t dist_sum = 0;
+    for (uint64_t i = 0; i <= m->mask; i++)
+    {
+        const SnapSlot *s = &m->slots[i];
+        if (!s->key_off)
+            continue;
+        size_t probes = (size_t)((i - (s->hash & m->mask)) & m->mask) + 1;
+        hs.total_elements++;
+        hs.histogram[ht_hist_bin(probes)]++;
+        dist_sum += probes;
+        if (probes > 1)
+            hs.collision_count++;
+        if (hs.max_chain_or_probe < probes)
+            hs.max_chain_or_probe = probes;
+    }
+    hs.used_buckets = hs.total_elements;
+    hs.average_chain_length = hs.total_elements ? (double)dist_sum / hs.total_elements : 0.0;
+    hs.avg_probe_success = hs.average_chain_length;
+    hs.bytes_used = m->file_size;
+    return hs;
+}
+
+static bool mapped_foreach(void *impl, hashtable_visit_t visit, void *ctx)
+{
+    const HashTableMapped *m = (const HashTableMapped *)impl;
+    for (uint64_t i = 0; i <= m->mask; i++)
+    {
+        const SnapSlot *s = &m->slots[i];
+        if (s->key_off && in_file(m, s->key_off, s->keysz) &&
+            !visit(m->base + s->key_off, (size_t)s->keysz, mapped_value(m, s), ctx))
+            return false;
+    }
+    return true;
+}
+
+static bool mapped_iter_next(void *impl, HashIter *it)
+{
+    const HashTableMapped *m = (const HashTableMapped *)impl;
+    for (uint64_t i = it->pos; i <= m->mask; i++)
+    {
+        const SnapSlot *s = &m->slots[i];
+        if (!s->key_off || !in_file(m, s->key_off, s->keysz))
+            continue;
+        it->pos = (size_t)i + 1;
+        it->key = m->base + s->key_off;
+        it->keysz = (size_t)s->keysz;
+        it->value = mapped_value(m, s);
+        return true;
+    }
+    it->pos = (size_t)m->mask + 1;
+    return false;
+}
+
+static void mapped_destroy(void **pimpl)
+{
+    if (!pimpl || !*pimpl) return;
+    HashTableMapped *m = (HashTableMapped *)(*pimpl);
+    munmap((void *)(uintptr_t)m->base, m->file_size);
+    free(m);
+    *pimpl = NULL;
+}
+
+static bool header_valid(const SnapHeader *hdr, size_t file_size)
+{
+    if (memcmp(hdr->magic, SNAP_MAGIC, sizeof hdr->magic) != 0 ||
+        hdr->version != SNAP_VERSION || hdr->byte_order != SNAP_BYTE_ORDER)
+        return false;
+    if (hdr->file_size != file_size || hdr->slots_off != sizeof(SnapHeader))
+        return false;
+    uint64_t cap = hdr->capacity;
+    if (cap == 0 || (cap & (cap - 1)) || cap > (file_size - sizeof(SnapHeader)) / sizeof(SnapSlot))
+        return false;
+    return hdr->count < cap;
+}
+
+HashTable *hashtable_open_mmap(const char *path)
+{
+    if (!path)
+        return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(SnapHeader) ||
+        (uint64_t)st.st_size > SIZE_MAX)
+    {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (base == MAP_FAILED)
+        return NULL;
+
+    const SnapHeader *hdr = (const SnapHeader *)base;
+    HashTableMapped *m = header_valid(hdr, size) ? malloc(sizeof(HashTableMapped)) : NULL;
+    if (!m)
+    {
+        munmap(base, size);
+        return NULL;
+    }
+    // lookups jump around the slot array; don't read ahead
+    posix_madvise(base, size, POSIX_MADV_RANDOM);
+
+    m->base = (const unsigned char *)base;
+    m->file_size = size;
+    m->hdr = hdr;
+    m->slots = (const SnapSlot *)(m->base + hdr->slots_off);
+    m->mask = hdr->capacity - 1;
+    m->seed = hdr->seed;
+    m->value_size = (size_t)hdr->value_size;
+
+    HashKeyOps kops = {
+        .hash = hash_fast,
+        .eq = NULL, // keys compare bytewise
+        .destroy_key = NULL,
+        .destroy_val = NULL,
+        .hash_seeded = hash_fast_seeded,
+        .seed = hdr->seed};
+    HashOps ops = {
+        .insert = mapped_insert,
+        .search = mapped_search,
+        .erase = mapped_erase,
+        .update = mapped_update,
+        .search_batch = mapped_search_batch,
+        .size = mapped_size,
+        .capacity = mapped_capacity,
+        .load_factor = mapped_load_factor,
+        .stats = mapped_stats,
+        .foreach = mapped_foreach,
+        .iter_next = mapped_iter_next,
+        .destroy = mapped_destroy,
+    };
+
+    HashTable *ht = ht_create_from_impl(m, ops, kops);
+    if (!ht)
+    {
+        munmap(base, size);
+        free(m);
+    }
+    return ht;
+}
@@ -0,0 +1,36 @@
+// hashtable_snapshot.h
+#pragma once
+#include "hashtable.h"
+
+/*
+ * 哈希表快照：保存到文件，之后 mmap 只读打开，不需要逐个重新插入
+ *
+ * 文件格式（本机字节序，所有位置都是相对文件开头的偏移，可以映射到任意地址）：
+ *   [头部 64 字节][槽位数组 capacity × 32 字节][键/值区]
+ * - 槽位数组是线性探测的开放地址表（容量为 2 的幂，负载因子不超过 0.5），
+ *   每个槽位保存 {hash, 键偏移, 键长, 值}，键偏移为 0 表示空槽
+ * - 哈希固定用 hash_fast_seeded（种子记录在头部），键按字节比较（memcmp），
+ *   所以打开时不需要原表的 HashKeyOps；键相等的含义必须是“字节相同”
+ *   （compare_int、compare_string 配合 hashtable_*_int/_string 均满足）
+ * - 打开是 O(1)：只校验头部并 mmap，查找直接在映射上进行，页面按需载入
+ */
+
+/**
+ * 把 ht 中的全部元素写入 path（先写 path.tmp 再 rename，失败时不破坏旧文件）
+ * @param value_size 0：值指针本身按 64 位整数保存（适合存放整数/下标的表；
+ *                      指向堆内存的指针在重启后无效）
+ *                   >0：每个值指向 value_size 字节的数据，拷贝进文件（按 16 字节对齐），
+ *                      打开后 search 返回指向映射内这份数据的指针
+ * @return 成功返回 true
+ */
+bool hashtable_save_ex(HashTable *ht, const char *path, size_t value_size);
+
+/* 等价于 hashtable_save_ex(ht, path, 0) */
+bool hashtable_save(HashTable *ht, const char *path);
+
+/**
+ * 只读映射 hashtable_save 写出的文件，返回的表可以直接 search / search_batch / 统计；
+ * insert / update / delete 一律返回 false。hashtable_destroy 时解除映射。
+ * 文件不存在、格式不符或与本机字节序不同时返回 NULL
+ */
+HashTable *hashtable_open_mmap(const char *path);
@@ -0,0 +1,577 @@
+// data_structures/hashtable/hashtable_swiss.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "hashtable_swiss.h"
+#include "hashtable_internal.h"
+
+// define SWISS_NO_SIMD to force the portable SWAR path
+#if !defined(SWISS_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define SWISS_USE_SSE2 1
+#endif
+
+#define GROUP_WIDTH 16
+
+// control bytes: full slots hold the 7-bit H2 fingerprint (high bit clear)
+#define CTRL_EMPTY ((int8_t)-128)  /* 0x80 */
+#define CTRL_DELETED ((int8_t)-2)  /* 0xFE */
+
+typedef struct SwissSlot
+{
+    HtKey key;   // short keys inline, longer ones in the table's KeyStore
+    void *value;
+    size_t hash;
+    size_t keysz;
+} SwissSlot;
+
+typedef struct HashTableSwiss
+{
+    int8_t *ctrl;       // capacity control bytes
+    SwissSlot *slots;   // capacity slots
+    size_t size;
+    size_t deleted;
+    size_t capacity;    // num_groups * GROUP_WIDTH
+    size_t group_mask;  // num_groups - 1 (num_groups is a power of two)
+    double max_load_factor;
+    size_t collision_count;
+    size_t resizes;
+    HashKeyOps keyops;
+    KeyStore keys;
+} HashTableSwiss;
+
+/* ========== group matching: one bit per slot in a 16-bit mask ========== */
+
+static inline unsigned lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctz(mask);
+#else
+    unsigned i = 0;
+    while (!(mask & 1u)) { mask >>= 1; i++; }
+    return i;
+#endif
+}
+
+#ifdef SWISS_USE_SSE2
+
+static inline uint32_t group_match(const int8_t *g, int8_t h2)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)g);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+}
+
+static inline uint32_t group_match_empty(const int8_t *g)
+{
+    return group_match(g, CTRL_EMPTY);
+}
+
+static inline uint32_t group_match_empty_or_deleted(const int8_t *g)
+{
+    // EMPTY and DELETED are the only bytes with the high bit set
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)g));
+}
+
+#else /* portable SWAR: two 64-bit words per group */
+
+#define LSB 0x0101010101010101ull
+#define MSB 0x8080808080808080ull
+
+static inline uint64_t load_le64(const int8_t *p)
+{
+    const unsigned char *b = (const unsigned char *)p;
+    uint64_t w = 0;
+    for (int i = 7; i >= 0; i--)
+        w = (w << 8) | b[i];
+    return w;
+}
+
+// gather the high bit of each byte into 8 consecutive bits
+static inline uint32_t compress_msb(uint64_t m)
+{
+    return (uint32_t)((((m & MSB) >> 7) * 0x0102040810204080ull) >> 56);
+}
+
+static inline uint64_t word_match(uint64_t w, int8_t h2)
+{
+    uint64_t x = w ^ (LSB * (unsigned char)h2);
+    // may report a false positive after a true match; callers verify with eq
+    return (x - LSB) & ~x & MSB;
+}
+
+static inline uint32_t group_match(const int8_t *g, int8_t h2)
+{
+    return compress_msb(word_match(load_le64(g), h2)) |
+           compress_msb(word_match(load_le64(g + 8), h2)) << 8;
+}
+
+static inline uint32_t group_match_empty(const int8_t *g)
+{
+    // EMPTY is 0x80: high bit set, bit 6 clear (DELETED 0xFE has bit 6 set)
+    uint64_t lo = load_le64(g), hi = load_le64(g + 8);
+    return compress_msb(lo & ~(lo << 1)) | compress_msb(hi & ~(hi << 1)) << 8;
+}
+
+static inline uint32_t group_match_empty_or_deleted(const int8_t *g)
+{
+    return compress_msb(load_le64(g)) | compress_msb(load_le64(g + 8)) << 8;
+}
+
+#endif /* SWISS_USE_SSE2 */
+
+/* ========== helpers ========== */
+
+static inline size_t h1_of(size_t hash) { return hash >> 7; }
+static inline int8_t h2_of(size_t hash) { return (int8_t)(hash & 0x7F); }
+
+static size_t groups_for(size_t capacity)
+{
+    size_t groups = 1;
+    while (groups * GROUP_WIDTH < capacity)
+        groups <<= 1;
+    return groups;
+}
+
+static bool swiss_alloc(HashTableSwiss *hts, size_t num_groups)
+{
+    size_t cap = num_groups * GROUP_WIDTH;
+    int8_t *ctrl = malloc(cap);
+    SwissSlot *slots = malloc(cap * sizeof(SwissSlot));
+    if (!ctrl || !slots)
+    {
+        free(ctrl);
+        free(slots);
+        return false;
+    }
+    memset(ctrl, CTRL_EMPTY, cap);
+    hts->ctrl = ctrl;
+    hts->slots = slots;
+    hts->capacity = cap;
+    hts->group_mask = num_groups - 1;
+    return true;
+}
+
+/* 查找键；返回槽位下标，找不到返回 SIZE_MAX */
+static size_t find_index(const HashTableSwiss *hts, const void *key, size_t hash)
+{
+    int8_t h2 = h2_of(hash);
+    size_t g = h1_of(hash) & hts->group_mask;
+    for (size_t i = 1; i <= hts->group_mask + 1; i++)
+    {
+        const int8_t *ctrl = hts->ctrl + g * GROUP_WIDTH;
+        for (uint32_t m = group_match(ctrl, h2); m; m &= m - 1)
+        {
+            size_t idx = g * GROUP_WIDTH + lowest_bit(m);
+            const SwissSlot *s = &hts->slots[idx];
+            if (s->hash == hash &&
+                hts->keyops.eq(key, keystore_get(&hts->keys, &s->key, s->keysz)) == 0)
+                return idx;
+        }
+        if (group_match_empty(ctrl))
+            return SIZE_MAX;
+        g = (g + i) & hts->group_mask; // triangular probing over groups
+    }
+    return SIZE_MAX;
+}
+
+/* 找到第一个可插入（空或已删除）的槽位；调用方保证表未满 */
+static size_t find_insert_slot(const HashTableSwiss *hts, size_t hash)
+{
+    size_t g = h1_of(hash) & hts->group_mask;
+    for (size_t i = 1;; i++)
+    {
+        uint32_t m = group_match_empty_or_deleted(hts->ctrl + g * GROUP_WIDTH);
+        if (m)
+            return g * GROUP_WIDTH + lowest_bit(m);
+        g = (g + i) & hts->group_mask;
+    }
+}
+
+static bool swiss_rehash(HashTableSwiss *hts, size_t num_groups)
+{
+    int8_t *old_ctrl = hts->ctrl;
+    SwissSlot *old_slots = hts->slots;
+    size_t old_cap = hts->capacity;
+    size_t old_mask = hts->group_mask;
+
+    if (!swiss_alloc(hts, num_groups))
+    {
+        hts->ctrl = old_ctrl;
+        hts->slots = old_slots;
+        hts->capacity = old_cap;
+        hts->group_mask = old_mask;
+        return false;
+    }
+
+    // entries are unique and carry their hash: place without eq or rehashing keys
+    hts->collision_count = 0;
+    for (size_t i = 0; i < old_cap; i++)
+    {
+        if (old_ctrl[i] < 0)
+            continue;
+        size_t hash = old_slots[i].hash;
+        size_t idx = find_insert_slot(hts, hash);
+        if (idx / GROUP_WIDTH != (h1_of(hash) & hts->group_mask))
+            hts->collision_count++;
+        hts->ctrl[idx] = h2_of(hash);
+        hts->slots[idx] = old_slots[i];
+    }
+    hts->deleted = 0;
+    hts->resizes++;
+
+    free(old_ctrl);
+    free(old_slots);
+    return true;
+}
+
+/* 预留共 n 个元素的空间：最多一次 rehash（顺带清掉已删除槽位） */
+static bool swiss_reserve(void *impl, size_t n)
+{
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    size_t groups = hts->group_mask + 1;
+    while ((double)n > groups * GROUP_WIDTH * hts->max_load_factor &&
+           groups <= SIZE_MAX / (2 * GROUP_WIDTH))
+        groups <<= 1;
+    if (groups == hts->group_mask + 1 &&
+        (double)(n + hts->deleted) <= hts->capacity * hts->max_load_factor)
+        return true;
+    return swiss_rehash(hts, groups);
+}
+
+/* 换成装下当前元素的最少组数，同时清掉 DELETED 标记 */
+static bool swiss_shrink_to_fit(void *impl)
+{
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    size_t groups = 1;
+    while ((double)hts->size > groups * GROUP_WIDTH * hts->max_load_factor &&
+           groups <= SIZE_MAX / (2 * GROUP_WIDTH))
+        groups <<= 1;
+    if (groups >= hts->group_mask + 1)
+    {
+        if (hts->deleted == 0)
+            return true;
+        groups = hts->group_mask + 1;
+    }
+    return swiss_rehash(hts, groups);
+}
+
+static bool swiss_insert_hashed(HashTableSwiss *hts, const void *key, size_t keysz,
+                                size_t hash, void *val)
+{
+    size_t idx = find_index(hts, key, hash);
+    if (idx != SIZE_MAX)
+    {
+        SwissSlot *s = &hts->slots[idx];
+        if (hts->keyops.destroy_val && s->value && s->value != val)
+            hts->keyops.destroy_val(s->value);
+        s->value = val;
+        return true;
+    }
+
+    if ((double)(hts->size + hts->deleted + 1) > hts->capacity * hts->max_load_factor)
+    {
+        // mostly tombstones: clean up in place instead of growing
+        size_t groups = hts->group_mask + 1;
+        if (hts->deleted < hts->size)
+            groups <<= 1;
+        if (!swiss_rehash(hts, groups))
+            return false;
+    }
+
+    HtKey key_copy;
+    if (!keystore_put(&hts->keys, &key_copy, key, keysz))
+        return false;
+
+    idx = find_insert_slot(hts, hash);
+    if (hts->ctrl[idx] == CTRL_DELETED)
+        hts->deleted--;
+    if (idx / GROUP_WIDTH != (h1_of(hash) & hts->group_mask))
+        hts->collision_count++;
+    hts->ctrl[idx] = h2_of(hash);
+    SwissSlot *s = &hts->slots[idx];
+    s->key = key_copy;
+    s->value = val;
+    s->hash = hash;
+    s->keysz = keysz;
+    hts->size++;
+    return true;
+}
+
+static bool swiss_insert(void *impl, const void *key, size_t keysz, void *val)
+{
+    if (!impl)
+        return false;
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    return swiss_insert_hashed(hts, key, keysz, ht_hash(&hts->keyops, key, keysz), val);
+}
+
+/* 算出一轮键的哈希，预取各自首个组的控制字节和槽位 */
+static void swiss_hash_prefetch(HashTableSwiss *hts, const void **keys, const size_t *keyszs,
+                                size_t m, size_t *hashes)
+{
+    for (size_t i = 0; i < m; i++)
+    {
+        hashes[i] = ht_hash(&hts->keyops, keys[i], keyszs[i]);
+        size_t g = h1_of(hashes[i]) & hts->group_mask;
+        HT_PREFETCH(hts->ctrl + g * GROUP_WIDTH);
+        HT_PREFETCH(&hts->slots[g * GROUP_WIDTH]);
+    }
+}
+
+static size_t swiss_search_batch(void *impl, const void **keys, const size_t *keyszs,
+                                 size_t n, void **out)
+{
+    if (!impl)
+        return 0;
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    size_t hashes[HT_BATCH];
+    size_t found = 0;
+    for (size_t base = 0; base < n; base += HT_BATCH)
+    {
+        size_t m = n - base < HT_BATCH ? n - base : HT_BATCH;
+        swiss_hash_prefetch(hts, keys + base, keyszs + base, m, hashes);
+        for (size_t i = 0; i < m; i++)
+        {
+            size_t idx = find_index(hts, keys[base + i], hashes[i]);
+            out[base + i] = idx == SIZE_MAX ? NULL : hts->slots[idx].value;
+            found += idx != SIZE_MAX;
+        }
+    }
+    return found;
+}
+
+static size_t swiss_insert_batch(void *impl, const void **keys, const size_t *keyszs,
+                                 void **vals, size_t n)
+{
+    if (!impl)
+        return 0;
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    size_t hashes[HT_BATCH];
+    size_t inserted = 0;
+    for (size_t base = 0; base < n; base += HT_BATCH)
+    {
+        size_t m = n - base < HT_BATCH ? n - base : HT_BATCH;
+        swiss_hash_prefetch(hts, keys + base, keyszs + base, m, hashes);
+        for (size_t i = 0; i < m; i++)
+            inserted += swiss_insert_hashed(hts, keys[base + i], keyszs[base + i], hashes[i],
+                                            vals[base + i]);
+    }
+    return inserted;
+}
+
+static void *swiss_search(void *impl, const void *key, size_t keysz)
+{
+    if (!impl)
+        return NULL;
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    size_t idx = find_index(hts, key, ht_hash(&hts->keyops, key, keysz));
+    return idx == SIZE_MAX ? NULL : hts->slots[idx].value;
+}
+
+static bool swiss_erase(void *impl, const void *key, size_t keysz)
+{
+    if (!impl)
+        return false;
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    size_t idx = find_index(hts, key, ht_hash(&hts->keyops, key, keysz));
+    if (idx == SIZE_MAX)
+        return false;
+
+    SwissSlot *s = &hts->slots[idx];
+    keystore_release(&hts->keys, &s->key, s->keysz);
+    if (hts->keyops.destroy_val)
+        hts->keyops.destroy_val(s->value);
+    s->value = NULL;
+
+    // A group that still has an EMPTY slot was never full, so no probe
+    // sequence ever continued past it and the slot can become EMPTY again.
+    size_t g = idx / GROUP_WIDTH;
+    if (group_match_empty(hts->ctrl + g * GROUP_WIDTH))
+    {
+        hts->ctrl[idx] = CTRL_EMPTY;
+    }
+    else
+    {
+        hts->ctrl[idx] = CTRL_DELETED;
+        hts->deleted++;
+    }
+    hts->size--;
+    return true;
+}
+
+static bool swiss_update(void *impl, const void *key, size_t keysz, void *new_value)
+{
+    if (!impl)
+        return false;
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    size_t idx = find_index(hts, key, ht_hash(&hts->keyops, key, keysz));
+    if (idx == SIZE_MAX)
+        return false;
+
+    SwissSlot *s = &hts->slots[idx];
+    if (s->value == new_value)
+        return true;
+    if (hts->keyops.destroy_val && s->value)
+        hts->keyops.destroy_val(s->value);
+    s->value = new_value;
+    return true;
+}
+
+static size_t swiss_size(const void *impl)
+{
+    if (!impl) return 0;
+    return ((const HashTableSwiss *)impl)->size;
+}
+
+static size_t swiss_capacity(const void *impl)
+{
+    if (!impl) return 0;
+    return ((const HashTableSwiss *)impl)->capacity;
+}
+
+static double swiss_load_factor(const void *impl)
+{
+    if (!impl) return -1.;
+    const HashTableSwiss *hts = (const HashTableSwiss *)impl;
+    return ((double)hts->size + hts->deleted) / hts->capacity;
+}
+
+static HashStats swiss_stats(const void *impl)
+{
+    const HashTableSwiss *hts = (const HashTableSwiss *)impl;
+    HashStats hs = {0};
+
+    hs.total_elements = hts->size;
+    hs.used_buckets = hts->size;
+    hs.collision_count = hts->collision_count;
+
+    // probe length = number of groups visited before reaching the entry's group
+    size_t sum_probe = 0;
+    for (size_t idx = 0; idx < hts->capacity; idx++)
+    {
+        if (hts->ctrl[idx] < 0)
+            continue;
+        size_t target = idx / GROUP_WIDTH;
+        size_t g = h1_of(hts->slots[idx].hash) & hts->group_mask;
+        size_t probes = 1;
+        for (size_t i = 1; g != target; i++, probes++)
+            g = (g + i) & hts->group_mask;
+        sum_probe += probes;
+        if (hs.max_chain_or_probe < probes)
+            hs.max_chain_or_probe = probes;
+        hs.histogram[ht_hist_bin(probes)]++;
+    }
+    hs.average_chain_length = hts->size ? (double)sum_probe / hts->size : 0.0;
+    hs.avg_probe_success = hs.average_chain_length;
+    hs.tombstones = hts->deleted;
+    hs.resize_count = hts->resizes;
+    hs.bytes_used = sizeof(HashTableSwiss) + hts->keys.bytes
+                  + hts->capacity * (sizeof(SwissSlot) + 1);
+    return hs;
+}
+
+static bool swiss_foreach(void *impl, hashtable_visit_t visit, void *ctx)
+{
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    for (size_t i = 0; i < hts->capacity; i++)
+    {
+        const SwissSlot *s = &hts->slots[i];
+        if (hts->ctrl[i] >= 0 &&
+            !visit(keystore_get(&hts->keys, &s->key, s->keysz), s->keysz, s->value, ctx))
+            return false;
+    }
+    return true;
+}
+
+static bool swiss_iter_next(void *impl, HashIter *it)
+{
+    HashTableSwiss *hts = (HashTableSwiss *)impl;
+    // the control bytes are dense: slots are only touched for full entries
+    for (size_t i = it->pos; i < hts->capacity; i++)
+    {
+        if (hts->ctrl[i] < 0)
+            continue;
+        const SwissSlot *s = &hts->slots[i];
+        it->pos = i + 1;
+        it->key = keystore_get(&hts->keys, &s->key, s->keysz);
+        it->keysz = s->keysz;
+        it->value = s->value;
+        return true;
+    }
+    it->pos = hts->capacity;
+    return false;
+}
+
+static void swiss_destroy(void **pimpl)
+{
+    if (!pimpl || !*pimpl) return;
+    HashTableSwiss *hts = (HashTableSwiss *)(*pimpl);
+    HashKeyOps keyops = hts->keyops;
+    for (size_t i = 0; i < hts->capacity; i++)
+    {
+        if (hts->ctrl[i] < 0)
+            continue;
+        keystore_release(&hts->keys, &hts->slots[i].key, hts->slots[i].keysz);
+        if (keyops.destroy_val) keyops.destroy_val(hts->slots[i].value);
+    }
+    keystore_destroy(&hts->keys);
+    free(hts->ctrl);
+    free(hts->slots);
+    free(hts);
+    *pimpl = NULL;
+}
+
+HashTable *hashtable_swiss_create(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops)
+{
+    HashTableSwiss *impl = malloc(sizeof(HashTableSwiss));
+    if (!impl)
+        return NULL;
+    if (!swiss_alloc(impl, groups_for(initial_capacity)))
+    {
+        free(impl);
+        return NULL;
+    }
+    impl->size = 0;
+    impl->deleted = 0;
+    impl->max_load_factor =
+        (max_load_factor <= 0 || max_load_factor >= 1) ? 0.875 : max_load_factor;
+    impl->collision_count = 0;
+    impl->resizes = 0;
+    keyops = ht_seed_keyops(keyops);
+    impl->keyops = keyops;
+    keystore_init(&impl->keys, keyops.destroy_key);
+
+    HashOps ops = {
+        .insert = swiss_insert,
+        .search = swiss_search,
+        .erase = swiss_erase,
+        .update = swiss_update,
+        .search_batch = swiss_search_batch,
+        .insert_batch = swiss_insert_batch,
+        .reserve = swiss_reserve,
+        .shrink_to_fit = swiss_shrink_to_fit,
+        .size = swiss_size,
+        .capacity = swiss_capacity,
+        .load_factor = swiss_load_factor,
+        .stats = swiss_stats,
+        .foreach = swiss_foreach,
+        .iter_next = swiss_iter_next,
+        .destroy = swiss_destroy,
+    };
+
+    HashTable *ht = ht_create_from_impl(impl, ops, keyops);
+    if (!ht)
+    {
+        free(impl->ctrl);
+        free(impl->slots);
+        free(impl);
+    }
+    return ht;
+}
@@ -0,0 +1,27 @@
+// hashtable_swiss.h
+#pragma once
+#include "hashtable.h"
+
+/*
+ * Swiss table 风格的开放地址法哈希表
+ * - 控制字节数组（每槽 1 字节）：空 / 已删除 / 已占用（低 7 位存哈希指纹 H2）
+ * - 槽位按 16 个一组，一次用 SSE2 字节比较（或可移植的 SWAR）匹配整组指纹，
+ *   只有指纹相同的槽位才调用 keyops.eq
+ * - 组间按三角数序列探测，组数为 2 的幂时保证遍历所有组
+ * - 槽位数组与控制字节分离，探测只触碰 16 字节的控制字节
+ */
+
+typedef struct HashTableSwiss HashTableSwiss;
+
+/**
+ * 创建 Swiss table 哈希表
+ * @param initial_capacity 初始槽位数（向上取整为 16 × 2 的幂）
+ * @param max_load_factor  负载因子阈值（含已删除槽位），<= 0 或 >= 1 时取 0.875
+ * @param keyops           键相关回调（hash/eq/destroy）
+ * @return 以统一接口 HashTable* 返回
+ */
+HashTable *hashtable_swiss_create(
+    size_t initial_capacity,
+    double max_load_factor,
+    HashKeyOps keyops
+);
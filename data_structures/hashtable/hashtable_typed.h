@@ -0,0 +1,243 @@
+// hashtable_typed.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 编译期生成的类型化开放地址表（只有头文件）
+ *
+ *   HASHTABLE_DEFINE(name, KeyT, ValT, hashfn, eqfn)
+ *
+ * 生成类型 name 以及 name_create / name_destroy / name_insert / name_search /
+ * name_update / name_erase / name_size / name_capacity / name_load_factor
+ * - 布局沿用 HashTableOA 的线性探测：槽位数组 + EMPTY/OCCUPIED/TOMBSTONE，
+ *   容量为 2 的幂，每个槽位缓存完整哈希，rehash 不重算
+ * - 键和值按值存在槽位里：没有 void*，没有 KeyStore，插入不分配内存
+ * - hashfn(KeyT) 返回 size_t，eqfn(KeyT, KeyT) 相等时返回非 0；两者都可以是宏或
+ *   static inline 函数，编译器能把哈希、比较连同探测循环一起内联
+ * - 语义与 hashtable_insert/search/update/delete 相同：insert 遇到已有键时覆盖值，
+ *   search 返回槽位内值的地址（下一次插入/删除前有效），找不到返回 NULL
+ * - 所有函数都是 static inline：同一个 name 在多个 .c 中 HASHTABLE_DEFINE 互不冲突
+ *
+ * 例：
+ *   static inline size_t point_hash(int k) { return ht_typed_hash_int(k); }
+ *   HASHTABLE_DEFINE(PointMap, int, Point, point_hash, HT_TYPED_EQ)
+ *   PointMap *m = PointMap_create(16, 0.75);
+ *   PointMap_insert(m, 42, (Point){1, 2});
+ *   Point *p = PointMap_search(m, 42);
+ *   PointMap_destroy(&m);
+ */
+
+/* 标量键的比较，可直接作为 eqfn */
+#define HT_TYPED_EQ(a, b) ((a) == (b))
+
+/* 与 hash_int32 / hash_int64 结果相同的可内联版本（一次 64×64→128 位乘法） */
+static inline uint64_t ht_typed_mum(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32, b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    return (a * b) ^ (hi_hi + (hi_lo >> 32) + (cross >> 32));
+#endif
+}
+
+static inline size_t ht_typed_hash_int(int32_t k)
+{
+    return (size_t)ht_typed_mum((uint64_t)(uint32_t)k ^ 4 ^ 0xa0761d6478bd642full,
+                                0xe7037ed1a0b428dbull);
+}
+
+static inline size_t ht_typed_hash_u64(uint64_t k)
+{
+    return (size_t)ht_typed_mum(k ^ 8 ^ 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull);
+}
+
+enum
+{
+    HT_TYPED_EMPTY = 0,
+    HT_TYPED_OCCUPIED = 1,
+    HT_TYPED_TOMBSTONE = 2
+};
+
+#define HASHTABLE_DEFINE(name, KeyT, ValT, hashfn, eqfn)                                    \
+    typedef struct name##_slot                                                              \
+    {                                                                                       \
+        KeyT key;                                                                           \
+        ValT value;                                                                         \
+        size_t hash; /* cached hashfn(key): checked before eqfn, reused by rehash */        \
+        unsigned char state;                                                                \
+    } name##_slot;                                                                          \
+                                                                                            \
+    typedef struct name                                                                     \
+    {                                                                                       \
+        name##_slot *slots;                                                                 \
+        size_t size;                                                                        \
+        size_t capacity; /* power of two */                                                 \
+        size_t tombstones;                                                                  \
+        double max_load_factor;                                                             \
+    } name;                                                                                 \
+                                                                                            \
+    static inline name *name##_create(size_t initial_capacity, double max_load_factor)      \
+    {                                                                                       \
+        size_t cap = 8;                                                                     \
+        while (cap < initial_capacity)                                                      \
+            cap <<= 1;                                                                      \
+        name *t = (name *)malloc(sizeof(name));                                             \
+        if (!t)                                                                             \
+            return NULL;                                                                    \
+        t->slots = (name##_slot *)calloc(cap, sizeof(name##_slot));                         \
+        if (!t->slots)                                                                      \
+        {                                                                                   \
+            free(t);                                                                        \
+            return NULL;                                                                    \
+        }                                                                                   \
+        t->size = 0;                                                                        \
+        t->capacity = cap;                                                                  \
+        t->tombstones = 0;                                                                  \
+        t->max_load_factor =                                                                \
+            (max_load_factor <= 0 || max_load_factor >= 1) ? 0.5 : max_load_factor;        \
+        return t;                                                                           \
+    }                                                                                       \
+                                                                                            \
+    static inline void name##_destroy(name **pt)                                            \
+    {                                                                                       \
+        if (!pt || !*pt)                                                                    \
+            return;                                                                         \
+        free((*pt)->slots);                                                                 \
+        free(*pt);                                                                          \
+        *pt = NULL;                                                                         \
+    }                                                                                       \
+                                                                                            \
+    /* 命中返回槽位下标；否则 SIZE_MAX，*insert_at 为第一个墓碑或空槽 */                   \
+    static inline size_t name##_probe(const name *t, KeyT key, size_t hash,                 \
+                                      size_t *insert_at)                                    \
+    {                                                                                       \
+        size_t mask = t->capacity - 1;                                                      \
+        size_t idx = hash & mask;                                                           \
+        size_t first_tomb = SIZE_MAX;                                                       \
+        for (size_t step = 0; step < t->capacity; step++, idx = (idx + 1) & mask)           \
+        {                                                                                   \
+            const name##_slot *s = &t->slots[idx];                                          \
+            if (s->state == HT_TYPED_OCCUPIED)                                              \
+            {                                                                               \
+                if (s->hash == hash && eqfn(s->key, key))                                   \
+                    return idx;                                                             \
+            }                                                                               \
+            else if (s->state == HT_TYPED_TOMBSTONE)                                        \
+            {                                                                               \
+                if (first_tomb == SIZE_MAX)                                                 \
+                    first_tomb = idx;                                                       \
+            }                                                                               \
+            else                                                                            \
+            {                                                                               \
+                *insert_at = first_tomb != SIZE_MAX ? first_tomb : idx;                     \
+                return SIZE_MAX;                                                            \
+            }                                                                               \
+        }                                                                                   \
+        *insert_at = first_tomb;                                                            \
+        return SIZE_MAX;                                                                    \
+    }                                                                                       \
+                                                                                            \
+    static inline bool name##_rehash(name *t, size_t new_capacity)                          \
+    {                                                                                       \
+        name##_slot *slots = (name##_slot *)calloc(new_capacity, sizeof(name##_slot));      \
+        if (!slots)                                                                         \
+            return false;                                                                   \
+        size_t mask = new_capacity - 1;                                                     \
+        for (size_t i = 0; i < t->capacity; i++)                                            \
+        {                                                                                   \
+            if (t->slots[i].state != HT_TYPED_OCCUPIED)                                     \
+                continue;                                                                   \
+            /* keys are distinct and there are no tombstones: first empty slot wins */      \
+            size_t idx = t->slots[i].hash & mask;                                           \
+            while (slots[idx].state == HT_TYPED_OCCUPIED)                                   \
+                idx = (idx + 1) & mask;                                                     \
+            slots[idx] = t->slots[i];                                                       \
+        }                                                                                   \
+        free(t->slots);                                                                     \
+        t->slots = slots;                                                                   \
+        t->capacity = new_capacity;                                                         \
+        t->tombstones = 0;                                                                  \
+        return true;                                                                        \
+    }                                                                                       \
+                                                                                            \
+    static inline ValT *name##_search(const name *t, KeyT key)                              \
+    {                                                                                       \
+        if (!t)                                                                             \
+            return NULL;                                                                    \
+        size_t insert_at = SIZE_MAX;                                                        \
+        size_t idx = name##_probe(t, key, hashfn(key), &insert_at);                         \
+        return idx == SIZE_MAX ? NULL : &t->slots[idx].value;                               \
+    }                                                                                       \
+                                                                                            \
+    static inline bool name##_insert(name *t, KeyT key, ValT value)                         \
+    {                                                                                       \
+        if (!t)                                                                             \
+            return false;                                                                   \
+        if ((double)(t->size + t->tombstones + 1) > t->max_load_factor * t->capacity)       \
+        {                                                                                   \
+            /* mostly tombstones: rebuilding at the same size is enough */                  \
+            size_t cap = (double)(t->size + 1) > t->max_load_factor * t->capacity / 2       \
+                             ? t->capacity << 1                                             \
+                             : t->capacity;                                                 \
+            if (!name##_rehash(t, cap))                                                     \
+                return false;                                                               \
+        }                                                                                   \
+        size_t hash = hashfn(key);                                                          \
+        size_t insert_at = SIZE_MAX;                                                        \
+        size_t idx = name##_probe(t, key, hash, &insert_at);                                \
+        if (idx != SIZE_MAX)                                                                \
+        {                                                                                   \
+            t->slots[idx].value = value;                                                    \
+            return true;                                                                    \
+        }                                                                                   \
+        if (insert_at == SIZE_MAX)                                                          \
+            return false;                                                                   \
+        name##_slot *s = &t->slots[insert_at];                                              \
+        if (s->state == HT_TYPED_TOMBSTONE)                                                 \
+            t->tombstones--;                                                                \
+        s->key = key;                                                                       \
+        s->value = value;                                                                   \
+        s->hash = hash;                                                                     \
+        s->state = HT_TYPED_OCCUPIED;                                                       \
+        t->size++;                                                                          \
+        return true;                                                                        \
+    }                                                                                       \
+                                                                                            \
+    static inline bool name##_update(name *t, KeyT key, ValT value)                         \
+    {                                                                                       \
+        ValT *v = name##_search(t, key);                                                    \
+        if (!v)                                                                             \
+            return false;                                                                   \
+        *v = value;                                                                         \
+        return true;                                                                        \
+    }                                                                                       \
+                                                                                            \
+    static inline bool name##_erase(name *t, KeyT key)                                      \
+    {                                                                                       \
+        if (!t)                                                                             \
+            return false;                                                                   \
+        size_t insert_at = SIZE_MAX;                                                        \
+        size_t idx = name##_probe(t, key, hashfn(key), &insert_at);                         \
+        if (idx == SIZE_MAX)                                                                \
+            return false;                                                                   \
+        t->slots[idx].state = HT_TYPED_TOMBSTONE;                                           \
+        t->size--;                                                                          \
+        t->tombstones++;                                                                    \
+        return true;                                                                        \
+    }                                                                                       \
+                                                                                            \
+    static inline size_t name##_size(const name *t) { return t ? t->size : 0; }             \
+    static inline size_t name##_capacity(const name *t) { return t ? t->capacity : 0; }     \
+    static inline double name##_load_factor(const name *t)                                  \
+    {                                                                                       \
+        return t && t->capacity ? (double)t->size / t->capacity : 0.0;                      \
+    }
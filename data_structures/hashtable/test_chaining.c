@@ -5,11 +5,26 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
 #include "hashtable.h"
 #include "hashtable_chaining.h"
 #include "hash.h"
 #include "../common/common.h"
+#include "test_helpers.h"
+
+// test_chaining links with -Wl,--wrap=malloc so a test can make the table's next malloc fail
+static int g_fail_next_malloc;
+
+void *__real_malloc(size_t size);
+
+void *__wrap_malloc(size_t size) {
+    if (g_fail_next_malloc) {
+        g_fail_next_malloc = 0;
+        return NULL;
+    }
+    return __real_malloc(size);
+}
 
 void print_separator(const char *test_suite_name) {
     printf("\n--- %s ---\n", test_suite_name);
@@ -262,6 +277,415 @@ void test_chaining_edge_cases() {
     hashtable_destroy(&ht);
 }
 
+void test_chaining_incremental_resize() {
+    print_separator("Chaining: Incremental Resize");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = free
+    };
+
+    HashTable *ht = hashtable_chaining_create_ex(8, 0.75, keyops, RESIZE_INCREMENTAL);
+    test_assert(ht != NULL, "Create chaining hashtable with incremental resize");
+
+    // Interleave lookups and deletes with the inserts that trigger migrations
+    int ok = 1;
+    for (int i = 0; i < 5000; i++) {
+        int *v = malloc(sizeof *v);
+        *v = i;
+        ok &= hashtable_insert(ht, &i, sizeof(int), v);
+        int probe = i / 2;
+        int *found = (int*)hashtable_search(ht, &probe, sizeof(int));
+        if (probe % 3 == 0 && i > 2 * probe)
+            ok &= (found == NULL);
+        else
+            ok &= (found != NULL && *found == probe);
+        if (i % 2 == 0 && probe % 3 == 0)
+            ok &= hashtable_delete(ht, &probe, sizeof(int));
+    }
+    test_assert(ok, "Operations consistent during migration");
+
+    size_t expected = 0;
+    ok = 1;
+    for (int i = 0; i < 5000; i++) {
+        int *found = (int*)hashtable_search(ht, &i, sizeof(int));
+        if (i % 3 == 0 && i < 2500) {
+            ok &= (found == NULL);
+            continue;
+        }
+        expected++;
+        ok &= (found != NULL && *found == i);
+    }
+    test_assert(ok, "All keys consistent after incremental resizing");
+    test_assert(hashtable_size(ht) == expected, "Size counts entries of both bucket arrays");
+
+    HashStats stats = hashtable_get_stats(ht);
+    test_assert(stats.total_elements == expected, "Stats element count");
+
+    hashtable_destroy(&ht);
+}
+
+static int destroyed_keys = 0;
+
+/* Unique string key for i; lengths cover inline keys, arena size classes and oversized keys */
+static size_t make_key(char *buf, int i)
+{
+    static const size_t lengths[] = {8, 15, 16, 40, 255, 600};
+    size_t len = lengths[i % 6];
+    char id[8];
+    memset(buf, 'a' + i % 26, len);
+    snprintf(id, sizeof id, "%07d", i);
+    memcpy(buf, id, 7);
+    buf[len - 1] = '\0';
+    return len;
+}
+
+static void count_destroy_key(void *key)
+{
+    destroyed_keys++;
+    free(key);
+}
+
+void test_chaining_key_storage() {
+    print_separator("Chaining: Key Storage");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_string,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    char buf[700];
+    HashTable *ht = hashtable_chaining_create(8, 0.75, keyops);
+    int ok = 1;
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 300; i++)
+        {
+            size_t len = make_key(buf, i);
+            ok &= hashtable_insert(ht, buf, len, (void *)(size_t)(i + 1));
+        }
+        for (int i = 0; i < 300; i++)
+        {
+            size_t len = make_key(buf, i);
+            ok &= hashtable_search(ht, buf, len) == (void *)(size_t)(i + 1);
+            // freed arena blocks are reused by the next round
+            if (round < 2 && i % 2)
+                ok &= hashtable_delete(ht, buf, len);
+        }
+    }
+    test_assert(ok, "Inline, arena and oversized keys round-trip");
+    test_assert(hashtable_insert_int(ht, 42, buf) && hashtable_search_int(ht, 42) == buf,
+                "Int keys use the inline path");
+    hashtable_destroy(&ht);
+
+    // With destroy_key every key is a separately allocated copy handed to the callback
+    HashKeyOps heap_ops = keyops;
+    heap_ops.destroy_key = count_destroy_key;
+    ht = hashtable_chaining_create(8, 0.75, heap_ops);
+    test_assert(hashtable_insert_string(ht, "short", NULL), "Insert with destroy_key");
+    test_assert(hashtable_insert_string(ht, "a somewhat longer key", NULL), "Insert long key");
+    test_assert(hashtable_delete_string(ht, "short"), "Delete with destroy_key");
+    test_assert(destroyed_keys == 1, "destroy_key called on delete");
+    hashtable_destroy(&ht);
+    test_assert(destroyed_keys == 2, "destroy_key called on destroy");
+}
+
+void test_chaining_batch_operations() {
+    print_separator("Chaining: Batch Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_chaining_create(8, 0.75, keyops);
+    enum { N = 1000 };
+    static int keys[2 * N];
+    const void *kp[2 * N];
+    size_t ksz[2 * N];
+    void *vals[2 * N];
+    void *out[2 * N];
+    for (int i = 0; i < 2 * N; i++)
+    {
+        keys[i] = i * 7 + 1;
+        kp[i] = &keys[i];
+        ksz[i] = sizeof(int);
+        vals[i] = &keys[i];
+    }
+
+    // N is not a multiple of the internal batch size; the table grows mid-batch
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals, N) == N, "Insert batch");
+    test_assert(hashtable_size(ht) == N, "Size after insert batch");
+
+    // second half of the keys was never inserted
+    size_t found = hashtable_search_batch(ht, kp, ksz, 2 * N, out);
+    test_assert(found == N, "Search batch hit count");
+    int ok = 1;
+    for (int i = 0; i < 2 * N; i++)
+        ok &= out[i] == (i < N ? &keys[i] : NULL);
+    test_assert(ok, "Search batch results match single lookups");
+
+    // Re-inserting existing keys through the batch API updates them
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals + 1, N) == N, "Update via insert batch");
+    test_assert(hashtable_search(ht, kp[0], sizeof(int)) == &keys[1], "Batch insert updated value");
+    test_assert(hashtable_search_batch(ht, kp, ksz, 0, out) == 0, "Empty batch");
+
+    hashtable_destroy(&ht);
+}
+
+void test_chaining_stats() {
+    print_separator("Chaining: Statistics");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    ResizeMode modes[] = {RESIZE_ALL_AT_ONCE, RESIZE_INCREMENTAL};
+    for (int m = 0; m < 2; m++) {
+        HashTable *ht = hashtable_chaining_create_ex(8, 0.75, keyops, modes[m]);
+        static int keys[3000];
+        for (int i = 0; i < 3000; i++) {
+            keys[i] = i;
+            hashtable_insert(ht, &keys[i], sizeof(int), &keys[i]);
+        }
+        for (int i = 0; i < 3000; i += 4)
+            hashtable_delete(ht, &keys[i], sizeof(int));
+
+        HashStats stats = hashtable_get_stats(ht);
+        size_t buckets = 0, entries = 0, longest = 0;
+        for (size_t i = 0; i < HT_HIST_BUCKETS; i++) {
+            buckets += stats.histogram[i];
+            entries += i * stats.histogram[i];
+            if (stats.histogram[i])
+                longest = i;
+        }
+        hashtable_print_stats(ht);
+        test_assert(stats.total_elements == 2250, "Stats element count");
+        test_assert(entries == stats.total_elements, "Chain histogram covers every entry");
+        test_assert(buckets >= hashtable_capacity(ht), "Chain histogram covers every bucket");
+        test_assert(stats.used_buckets == buckets - stats.histogram[0], "Used buckets match histogram");
+        test_assert(longest <= stats.max_chain_or_probe, "Max chain bounds the histogram");
+        test_assert(stats.avg_probe_success >= 1.0, "Average successful probe");
+        test_assert(stats.avg_probe_failure > 0.0, "Average unsuccessful probe");
+        test_assert(stats.resize_count > 0, "Resizes counted");
+        test_assert(stats.bytes_used > stats.total_elements * sizeof(int), "Bytes used");
+        if (modes[m] == RESIZE_ALL_AT_ONCE)
+            test_assert(buckets == hashtable_capacity(ht), "No old buckets left");
+        hashtable_destroy(&ht);
+    }
+}
+
+void test_chaining_seeded_hash() {
+    print_separator("Chaining: Seeded Hashing");
+
+    HashKeyOps keyops = {
+        .hash = hash_fast,
+        .eq = compare_string,
+        .destroy_key = NULL,
+        .destroy_val = NULL,
+        .hash_seeded = hash_fast_seeded};
+
+    HashTable *a = hashtable_chaining_create(8, 0.75, keyops);
+    HashTable *b = hashtable_chaining_create(8, 0.75, keyops);
+    test_assert(a->kops.seed != 0 && b->kops.seed != 0, "Seed 0 is replaced by a random seed");
+    test_assert(a->kops.seed != b->kops.seed, "Every table gets its own seed");
+
+    char buf[32];
+    int ok = 1;
+    for (int i = 0; i < 2000; i++) {
+        snprintf(buf, sizeof buf, "seeded-%d", i);
+        ok &= hashtable_insert_string(a, buf, (void *)(intptr_t)(i + 1));
+    }
+    for (int i = 0; i < 2000; i++) {
+        snprintf(buf, sizeof buf, "seeded-%d", i);
+        ok &= hashtable_search_string(a, buf) == (void *)(intptr_t)(i + 1);
+    }
+    test_assert(ok, "Operations across rehashes use the table's seed");
+    hashtable_destroy(&a);
+    hashtable_destroy(&b);
+
+    // a fixed seed is kept, so bucket layout is reproducible
+    keyops.seed = 0x1234;
+    a = hashtable_chaining_create(8, 0.75, keyops);
+    b = hashtable_chaining_create(8, 0.75, keyops);
+    test_assert(a->kops.seed == 0x1234, "Fixed seed is kept");
+    for (int i = 0; i < 500; i++) {
+        snprintf(buf, sizeof buf, "fixed-%d", i);
+        hashtable_insert_string(a, buf, NULL);
+        hashtable_insert_string(b, buf, NULL);
+    }
+    HashStats sa = hashtable_get_stats(a), sb = hashtable_get_stats(b);
+    test_assert(memcmp(sa.histogram, sb.histogram, sizeof sa.histogram) == 0,
+                "Same seed, same chain histogram");
+    hashtable_destroy(&a);
+    hashtable_destroy(&b);
+}
+
+void test_chaining_iteration() {
+    print_separator("Chaining: Iteration");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_iteration(hashtable_chaining_create(8, 0.75, keyops), 2000, "All at once");
+    // 1600 inserts into a table of 8 leave a migration pending
+    check_iteration(hashtable_chaining_create_ex(8, 0.75, keyops, RESIZE_INCREMENTAL), 1600,
+                    "Incremental");
+    check_iteration(hashtable_chaining_create(8, 0.75, keyops), 0, "Empty");
+}
+
+void test_chaining_build() {
+    print_separator("Chaining: Bulk Build");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_build(hashtable_chaining_create(8, 0.75, keyops), 50000, 1, "All at once");
+    check_build(hashtable_chaining_create_ex(8, 0.75, keyops, RESIZE_INCREMENTAL), 50000, 1,
+                "Incremental");
+}
+
+void test_chaining_capacity_control() {
+    print_separator("Chaining: Reserve, Shrink and Hysteresis");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    // a pre-sized table keeps its buckets through the first inserts and later deletes
+    HashTable *ht = hashtable_chaining_create(1 << 16, 0.75, keyops);
+    for (int i = 0; i < 10; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)(i + 1));
+    for (int i = 0; i < 5; i++)
+        hashtable_delete_int(ht, i);
+    test_assert(hashtable_capacity(ht) == 1 << 16 && hashtable_get_stats(ht).resize_count == 0,
+                "Initial capacity is not shrunk by inserts or deletes");
+    hashtable_destroy(&ht);
+
+    // inserts never shrink; deletes shrink only well below the grow point
+    ht = hashtable_chaining_create(8, 0.75, keyops);
+    for (int i = 0; i < 4096; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)i);
+    size_t cap = hashtable_capacity(ht);
+    size_t resizes = hashtable_get_stats(ht).resize_count;
+    for (int round = 0; round < 1000; round++) {
+        int k = 4096 + round;
+        hashtable_insert_int(ht, k, NULL);
+        hashtable_delete_int(ht, k);
+        hashtable_delete_int(ht, round);
+        hashtable_insert_int(ht, round, (void *)(intptr_t)round);
+    }
+    test_assert(hashtable_capacity(ht) == cap && hashtable_get_stats(ht).resize_count == resizes,
+                "Insert/delete churn at a fixed size never resizes");
+    for (int i = 0; i < 4096 - 100; i++)
+        hashtable_delete_int(ht, i);
+    cap = hashtable_capacity(ht);
+    test_assert(cap < 4096 && (double)hashtable_size(ht) / cap < 0.75, "Deleting most keys shrinks");
+    int ok = 1;
+    for (int i = 4096 - 100; i < 4096; i++)
+        ok &= (intptr_t)hashtable_search_int(ht, i) == i;
+    test_assert(ok, "Remaining keys survive the shrink");
+    hashtable_destroy(&ht);
+
+    // a reserve that fails to allocate must not raise the shrink floor
+    ht = hashtable_chaining_create(8, 0.75, keyops);
+    for (int i = 0; i < 4096; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)i);
+    cap = hashtable_capacity(ht);
+    g_fail_next_malloc = 1;
+    test_assert(!hashtable_reserve(ht, 1 << 20) && hashtable_capacity(ht) == cap,
+                "A reserve that cannot allocate fails and keeps the capacity");
+    g_fail_next_malloc = 0;
+    for (int i = 0; i < 4096 - 100; i++)
+        hashtable_delete_int(ht, i);
+    test_assert(hashtable_capacity(ht) < cap, "A failed reserve does not stop deletes from shrinking");
+    hashtable_destroy(&ht);
+
+    check_capacity_control(hashtable_chaining_create(8, 0.75, keyops), 20000, 1, "All at once");
+    check_capacity_control(hashtable_chaining_create_ex(8, 0.75, keyops, RESIZE_INCREMENTAL), 20000, 1,
+                           "Incremental");
+}
+
+typedef struct {
+    Arena arena;
+    size_t allocs;
+    size_t frees;
+} CountingArena;
+
+static void *counting_alloc(void *ctx, size_t size) {
+    CountingArena *ca = ctx;
+    ca->allocs++;
+    return arena_alloc(&ca->arena, size);
+}
+
+static void counting_free(void *ctx, void *ptr, size_t size) {
+    (void)ptr;
+    (void)size;
+    ((CountingArena *)ctx)->frees++;
+}
+
+void test_chaining_allocator() {
+    print_separator("Chaining: Node Allocators");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    // default: nodes come from the table's pools, erased nodes are reused
+    HashTable *ht = hashtable_chaining_create(8, 0.75, keyops);
+    for (int i = 0; i < 20000; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)(i + 1));
+    for (int i = 0; i < 20000; i += 2)
+        hashtable_delete_int(ht, i);
+    size_t bytes = hashtable_get_stats(ht).bytes_used;
+    for (int i = 0; i < 20000; i += 2)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)(i + 1));
+    int ok = 1;
+    for (int i = 0; i < 20000; i++)
+        ok &= (intptr_t)hashtable_search_int(ht, i) == i + 1;
+    test_assert(ok, "Pooled nodes: every key survives delete and re-insert");
+    test_assert(hashtable_get_stats(ht).bytes_used == bytes, "Re-inserted nodes reuse freed pool slots");
+    hashtable_destroy(&ht);
+
+    // caller-supplied allocator receives every node
+    CountingArena ca = {.allocs = 0, .frees = 0};
+    arena_init(&ca.arena, 0);
+    Allocator alloc = {.alloc = counting_alloc, .free = counting_free, .ctx = &ca};
+    ht = hashtable_chaining_create_alloc(8, 0.75, keyops, RESIZE_INCREMENTAL, &alloc);
+    for (int i = 0; i < 5000; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)i);
+    test_assert(ca.allocs >= 2 * 5000, "Hash nodes and list nodes come from the allocator");
+    for (int i = 0; i < 5000; i += 5)
+        hashtable_delete_int(ht, i);
+    ok = hashtable_size(ht) == 4000;
+    for (int i = 0; i < 5000; i++)
+        ok &= (hashtable_search_int(ht, i) != NULL) == (i % 5 != 0);
+    test_assert(ok, "Table works on arena memory");
+    hashtable_destroy(&ht);
+    test_assert(ca.frees == ca.allocs, "Every node is handed back to the allocator");
+    arena_destroy(&ca.arena);
+}
+
 int main() {
     printf("Chaining Hashtable Implementation Tests\n");
     printf("=====================================\n");
@@ -271,7 +695,17 @@ int main() {
     test_chaining_rehashing();
     test_chaining_string_keys();
     test_chaining_edge_cases();
-    
+    test_chaining_incremental_resize();
+    test_chaining_key_storage();
+    test_chaining_batch_operations();
+    test_chaining_stats();
+    test_chaining_seeded_hash();
+    
+    test_chaining_iteration();
+    test_chaining_build();
+    test_chaining_capacity_control();
+    test_chaining_allocator();
+
     printf("\n✓ All chaining hashtable tests passed!\n");
     printf("Chaining implementation appears to be working correctly.\n");
     
@@ -0,0 +1,340 @@
+/**
+ * test_flat.c - Test cases for the flat (node pool) chaining hashtable
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hashtable.h"
+#include "hashtable_flat.h"
+#include "hash.h"
+#include "../common/common.h"
+#include "test_helpers.h"
+
+// test_flat links with -Wl,--wrap=malloc so a test can make the table's next malloc fail
+static int g_fail_next_malloc;
+
+void *__real_malloc(size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    if (g_fail_next_malloc)
+    {
+        g_fail_next_malloc = 0;
+        return NULL;
+    }
+    return __real_malloc(size);
+}
+
+void print_separator(const char *test_suite_name)
+{
+    printf("\n--- %s ---\n", test_suite_name);
+}
+
+void test_assert(int condition, const char *test_name)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", test_name);
+    }
+    else
+    {
+        printf("✗ %s FAILED\n", test_name);
+        exit(1);
+    }
+}
+
+void test_flat_basic_operations()
+{
+    print_separator("Flat Chaining: Basic Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_flat_create(8, 0.75, keyops);
+    test_assert(ht != NULL, "Create flat hashtable");
+    test_assert(hashtable_size(ht) == 0, "Initial size is 0");
+    test_assert(hashtable_capacity(ht) == 8, "Initial capacity is 8");
+
+    int key1 = 10, val1 = 100;
+    int key2 = 20, val2 = 200;
+    int key3 = 30, val3 = 300;
+
+    test_assert(hashtable_insert(ht, &key1, sizeof(int), &val1), "Insert key1");
+    test_assert(hashtable_insert(ht, &key2, sizeof(int), &val2), "Insert key2");
+    test_assert(hashtable_insert(ht, &key3, sizeof(int), &val3), "Insert key3");
+    test_assert(hashtable_size(ht) == 3, "Size after insertions");
+
+    int *found = (int *)hashtable_search(ht, &key1, sizeof(int));
+    test_assert(found != NULL && *found == val1, "Search existing key1");
+
+    int nonexistent = 999;
+    found = (int *)hashtable_search(ht, &nonexistent, sizeof(int));
+    test_assert(found == NULL, "Search non-existent key");
+
+    int new_val1 = 1000;
+    test_assert(hashtable_update(ht, &key1, sizeof(int), &new_val1), "Update existing key");
+    found = (int *)hashtable_search(ht, &key1, sizeof(int));
+    test_assert(found != NULL && *found == new_val1, "Verify updated value");
+
+    test_assert(hashtable_delete(ht, &key2, sizeof(int)), "Delete existing key");
+    test_assert(hashtable_size(ht) == 2, "Size after deletion");
+    test_assert(hashtable_search(ht, &key2, sizeof(int)) == NULL, "Verify deleted key not found");
+    test_assert(!hashtable_delete(ht, &key2, sizeof(int)), "Delete twice fails");
+
+    hashtable_destroy(&ht);
+    test_assert(ht == NULL, "Destroy hashtable");
+}
+
+void test_flat_collision_handling()
+{
+    print_separator("Flat Chaining: Collision Handling");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    // Load factor 4.0 keeps 8 buckets for 32 keys: long chains everywhere
+    HashTable *ht = hashtable_flat_create(8, 4.0, keyops);
+    int keys[32], vals[32];
+    for (int i = 0; i < 32; i++)
+    {
+        keys[i] = i * 7;
+        vals[i] = i * 70;
+        test_assert(hashtable_insert(ht, &keys[i], sizeof(int), &vals[i]),
+                    "Insert key causing collisions");
+    }
+    test_assert(hashtable_capacity(ht) == 8, "No rehash below load factor");
+
+    // Remove every other key from the middle of chains, then verify the rest
+    for (int i = 0; i < 32; i += 2)
+        test_assert(hashtable_delete(ht, &keys[i], sizeof(int)), "Delete from chain");
+    for (int i = 0; i < 32; i++)
+    {
+        int *found = (int *)hashtable_search(ht, &keys[i], sizeof(int));
+        if (i % 2 == 0)
+            test_assert(found == NULL, "Deleted key gone");
+        else
+            test_assert(found != NULL && *found == vals[i], "Surviving key intact");
+    }
+
+    HashStats stats = hashtable_get_stats(ht);
+    printf("  - Collision count: %zu\n", stats.collision_count);
+    printf("  - Max chain length: %zu\n", stats.max_chain_or_probe);
+    test_assert(stats.total_elements == 16, "Stats element count");
+    test_assert(stats.max_chain_or_probe > 1, "Chain length > 1 due to collisions");
+
+    hashtable_destroy(&ht);
+}
+
+void test_flat_node_reuse_and_rehash()
+{
+    print_separator("Flat Chaining: Node Reuse and Rehashing");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = free};
+
+    HashTable *ht = hashtable_flat_create(0, 0.75, keyops);
+    size_t initial_capacity = hashtable_capacity(ht);
+
+    // Insert/delete churn exercises the free list
+    for (int round = 0; round < 4; round++)
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            int *v = malloc(sizeof *v);
+            *v = i + round;
+            test_assert(hashtable_insert(ht, &i, sizeof(int), v), "Churn insert");
+        }
+        for (int i = 0; i < 1000; i += 3)
+            hashtable_delete(ht, &i, sizeof(int));
+    }
+
+    test_assert(hashtable_capacity(ht) > initial_capacity, "Capacity increased due to rehashing");
+    test_assert(hashtable_load_factor(ht) <= 0.75, "Load factor kept below threshold");
+
+    int ok = 1;
+    for (int i = 0; i < 1000; i++)
+    {
+        int *found = (int *)hashtable_search(ht, &i, sizeof(int));
+        if (i % 3 == 0)
+            ok &= (found == NULL);
+        else
+            ok &= (found != NULL && *found == i + 3);
+    }
+    test_assert(ok, "All keys consistent after churn and rehashing");
+
+    hashtable_destroy(&ht);
+}
+
+void test_flat_string_keys()
+{
+    print_separator("Flat Chaining: String Key Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_string,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_flat_create(8, 0.75, keyops);
+    test_assert(ht != NULL, "Create hashtable for strings");
+
+    test_assert(hashtable_insert_string(ht, "Alice", "25"), "Insert Alice");
+    test_assert(hashtable_insert_string(ht, "Bob", "30"), "Insert Bob");
+    test_assert(hashtable_insert_string(ht, "Charlie", "35"), "Insert Charlie");
+
+    char *found = (char *)hashtable_search_string(ht, "Bob");
+    test_assert(found != NULL && strcmp(found, "30") == 0, "Find string key");
+
+    test_assert(hashtable_delete_string(ht, "Bob"), "Delete string key");
+    test_assert(hashtable_search_string(ht, "Bob") == NULL, "Deleted string key not found");
+    test_assert(hashtable_size(ht) == 2, "Size after string deletion");
+
+    hashtable_destroy(&ht);
+}
+
+void test_flat_batch_operations()
+{
+    print_separator("Flat Chaining: Batch Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_flat_create(8, 0.75, keyops);
+    enum { N = 1000 };
+    static int keys[2 * N];
+    const void *kp[2 * N];
+    size_t ksz[2 * N];
+    void *vals[2 * N];
+    void *out[2 * N];
+    for (int i = 0; i < 2 * N; i++)
+    {
+        keys[i] = i * 7 + 1;
+        kp[i] = &keys[i];
+        ksz[i] = sizeof(int);
+        vals[i] = &keys[i];
+    }
+
+    // N is not a multiple of the internal batch size; the table grows mid-batch
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals, N) == N, "Insert batch");
+    test_assert(hashtable_size(ht) == N, "Size after insert batch");
+
+    // second half of the keys was never inserted
+    size_t found = hashtable_search_batch(ht, kp, ksz, 2 * N, out);
+    test_assert(found == N, "Search batch hit count");
+    int ok = 1;
+    for (int i = 0; i < 2 * N; i++)
+        ok &= out[i] == (i < N ? &keys[i] : NULL);
+    test_assert(ok, "Search batch results match single lookups");
+
+    // Re-inserting existing keys through the batch API updates them
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals + 1, N) == N, "Update via insert batch");
+    test_assert(hashtable_search(ht, kp[0], sizeof(int)) == &keys[1], "Batch insert updated value");
+    test_assert(hashtable_search_batch(ht, kp, ksz, 0, out) == 0, "Empty batch");
+
+    hashtable_destroy(&ht);
+}
+
+void test_flat_iteration()
+{
+    print_separator("Flat: Iteration");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_iteration(hashtable_flat_create(8, 0.75, keyops), 2000, "Flat");
+    check_iteration(hashtable_flat_create(8, 0.75, keyops), 0, "Empty");
+}
+
+void test_flat_build()
+{
+    print_separator("Flat: Bulk Build");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_build(hashtable_flat_create(8, 0.75, keyops), 50000, 1, "Flat");
+}
+
+void test_flat_capacity_control()
+{
+    print_separator("Flat: Reserve and Shrink");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_capacity_control(hashtable_flat_create(8, 0.75, keyops), 20000, 1, "Flat");
+
+    // survivors sit behind freed nodes, so a compaction would move every one of them
+    HashTable *ht = hashtable_flat_create(8, 0.75, keyops);
+    for (int i = 0; i < 1000; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)(i + 1));
+    for (int i = 0; i < 900; i++)
+        hashtable_delete_int(ht, i);
+    size_t cap = hashtable_capacity(ht);
+    g_fail_next_malloc = 1;
+    test_assert(!hashtable_shrink_to_fit(ht), "shrink_to_fit reports a failed bucket allocation");
+    g_fail_next_malloc = 0;
+    int ok = hashtable_size(ht) == 100 && hashtable_capacity(ht) == cap;
+    for (int i = 0; i < 1000; i++)
+    {
+        intptr_t v = (intptr_t)hashtable_search_int(ht, i);
+        ok &= i < 900 ? v == 0 : v == i + 1;
+    }
+    // refilling reuses the freed nodes; the survivors must still be reachable
+    for (int i = 0; i < 900; i++)
+        ok &= hashtable_insert_int(ht, i, (void *)(intptr_t)(i + 1));
+    for (int i = 0; i < 1000; i++)
+        ok &= (intptr_t)hashtable_search_int(ht, i) == i + 1;
+    for (int i = 0; i < 900; i++)
+        hashtable_delete_int(ht, i);
+    test_assert(ok, "A failed shrink_to_fit leaves the table unchanged");
+    test_assert(hashtable_shrink_to_fit(ht) && hashtable_capacity(ht) < cap,
+                "shrink_to_fit succeeds once memory is available");
+    hashtable_destroy(&ht);
+}
+
+int main()
+{
+    printf("Flat Chaining Hashtable Implementation Tests\n");
+    printf("============================================\n");
+
+    test_flat_basic_operations();
+    test_flat_collision_handling();
+    test_flat_node_reuse_and_rehash();
+    test_flat_string_keys();
+    test_flat_batch_operations();
+    test_flat_iteration();
+    test_flat_build();
+    test_flat_capacity_control();
+
+    printf("\n✓ All flat chaining hashtable tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * test_hash.c - Test cases for the hash functions in hash.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "hash.h"
+
+void print_separator(const char *test_suite_name)
+{
+    printf("\n--- %s ---\n", test_suite_name);
+}
+
+void test_assert(int condition, const char *test_name)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", test_name);
+    }
+    else
+    {
+        printf("✗ %s FAILED\n", test_name);
+        exit(1);
+    }
+}
+
+static unsigned char pattern[2048];
+
+static void fill_pattern(void)
+{
+    for (size_t i = 0; i < sizeof pattern; i++)
+        pattern[i] = (unsigned char)(i * 131 + 7);
+}
+
+static int popcount64(uint64_t x)
+{
+    int n = 0;
+    for (; x; x &= x - 1)
+        n++;
+    return n;
+}
+
+void test_hash_fast_known_values()
+{
+    print_separator("hash_fast: Known Values");
+
+    // computed with -DHASH_NO_AVX2; the AVX2 path has to produce the same bits
+    static const struct
+    {
+        size_t len;
+        uint64_t hash;
+    } expected[] = {
+        {0, 0x42bc986dc5eec4d3ull},
+        {1, 0x7bbfc11aa49c3a9dull},
+        {3, 0x7962517f1e64fb21ull},
+        {4, 0x92f9f1b846445649ull},
+        {5, 0xb2757a63ee812cccull},
+        {8, 0xec721f531a1534fbull},
+        {12, 0x63a09500e441c200ull},
+        {16, 0xab12e8516bbeb265ull},
+        {17, 0xcb2c7822c791ed8dull},
+        {31, 0xad5dd95e1e14c826ull},
+        {32, 0xb358f96fa402570aull},
+        {33, 0x685864fe599fd47full},
+        {64, 0xe3085d7984fadfceull},
+        {100, 0xae66c34c525e9b2bull},
+        {128, 0xa83d5267fed08677ull},
+        {129, 0xe9bba16ff97fcb91ull},
+        {200, 0xae4a377fbbe1af66ull},
+        {256, 0x8f6793efbafaee17ull},
+        {257, 0x6bd43b2739a441a0ull},
+        {511, 0xd3e6830fb390a12full},
+        {512, 0x7ad3324d6168611dull},
+        {1000, 0x9ce115501b30953full},
+        {1024, 0xe93a87714a8da56bull},
+        {2047, 0xbdfd2bae62860babull},
+    };
+
+    if (sizeof(size_t) < sizeof(uint64_t))
+    {
+        printf("  - skipped: size_t is narrower than 64 bits\n");
+        return;
+    }
+    int ok = 1;
+    for (size_t i = 0; i < sizeof expected / sizeof expected[0]; i++)
+        ok &= (uint64_t)hash_fast(pattern, expected[i].len) == expected[i].hash;
+    test_assert(ok, "Every length class matches the reference values");
+}
+
+void test_hash_fast_integer_paths()
+{
+    print_separator("hash_fast: Integer Fast Paths");
+
+    int ok = 1;
+    for (int32_t i = -1000; i < 1000; i++)
+        ok &= hash_int32(&i, sizeof i) == hash_fast(&i, sizeof i);
+    test_assert(ok, "hash_int32 matches hash_fast");
+
+    ok = 1;
+    for (int64_t i = -1000; i < 1000; i++)
+    {
+        int64_t v = i * 0x100000001ll;
+        ok &= hash_int64(&v, sizeof v) == hash_fast(&v, sizeof v);
+    }
+    test_assert(ok, "hash_int64 matches hash_fast");
+
+    // sequential ints must spread over both the low bits (masking) and the high bits (sharding)
+    enum { N = 1 << 16, BUCKETS = 1024 };
+    static unsigned low[BUCKETS], high[BUCKETS];
+    for (uint32_t i = 0; i < N; i++)
+    {
+        size_t h = hash_int32(&i, sizeof i);
+        low[h & (BUCKETS - 1)]++;
+        high[(uint64_t)h >> 54]++;
+    }
+    unsigned max_low = 0, max_high = 0;
+    for (int b = 0; b < BUCKETS; b++)
+    {
+        if (low[b] > max_low) max_low = low[b];
+        if (high[b] > max_high) max_high = high[b];
+    }
+    printf("  - Max bucket load (mean %d): low bits %u, high bits %u\n", N / BUCKETS, max_low, max_high);
+    test_assert(max_low < 2 * N / BUCKETS && max_high < 2 * N / BUCKETS, "Sequential keys spread evenly");
+}
+
+void test_hash_fast_lengths()
+{
+    print_separator("hash_fast: All Lengths");
+
+    // every length reads only its own bytes (checked under ASan) and depends on all of them
+    int ok = 1;
+    for (size_t len = 1; len <= 600; len++)
+    {
+        unsigned char *key = malloc(len);
+        memcpy(key, pattern, len);
+        size_t h = hash_fast(key, len);
+        for (size_t pos = 0; pos < len; pos += (len > 64 ? 7 : 1))
+        {
+            key[pos] ^= 1;
+            ok &= hash_fast(key, len) != h;
+            key[pos] ^= 1;
+        }
+        ok &= hash_fast(key, len) == h;
+        free(key);
+    }
+    test_assert(ok, "Every byte of the key affects the hash");
+    test_assert(hash_fast(pattern, 16) != hash_fast(pattern, 17), "Length is part of the hash");
+
+    // swapping two 32-byte blocks of a long key must change the hash
+    unsigned char swapped[1024];
+    memcpy(swapped, pattern, sizeof swapped);
+    memcpy(swapped, pattern + 32, 32);
+    memcpy(swapped + 32, pattern, 32);
+    test_assert(hash_fast(swapped, sizeof swapped) != hash_fast(pattern, sizeof swapped),
+                "Block order matters for long keys");
+
+    // avalanche: a one-bit change flips about half of the output bits
+    double flips = 0;
+    int trials = 0;
+    for (size_t len = 4; len <= 1024; len *= 2)
+    {
+        unsigned char key[1024];
+        memcpy(key, pattern, len);
+        uint64_t h = hash_fast(key, len);
+        for (size_t bit = 0; bit < len * 8; bit += 5)
+        {
+            key[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+            flips += popcount64(h ^ (uint64_t)hash_fast(key, len));
+            key[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+            trials++;
+        }
+    }
+    printf("  - Average flipped bits: %.2f / 64\n", flips / trials);
+    test_assert(flips / trials > 28 && flips / trials < 36, "Avalanche");
+}
+
+void test_hash_multiplication()
+{
+    print_separator("hash_multiplication: Range Reduction");
+
+    int ok = 1;
+    size_t sizes[] = {1, 7, 1000, 1u << 20, (size_t)1 << 40};
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; s++)
+        for (int i = 0; i < 1000; i++)
+            ok &= hash_multiplication(&i, sizeof i, sizes[s]) < sizes[s];
+    test_assert(ok, "Result is always below table_size");
+
+    // the old version dropped the high half of the product; all slots should now be hit
+    enum { SLOTS = 97 };
+    int seen[SLOTS] = {0}, hit = 0;
+    for (int i = 0; i < 10000; i++)
+        seen[hash_multiplication(&i, sizeof i, SLOTS)] = 1;
+    for (int s = 0; s < SLOTS; s++)
+        hit += seen[s];
+    test_assert(hit == SLOTS, "Every slot of a non power-of-two table is reachable");
+}
+
+void test_seeded_variants()
+{
+    print_separator("Seeded Variants");
+
+    const char *str = "seeded hashing";
+    size_t len = strlen(str);
+    test_assert(hash_fnv1a_seeded(str, len, 0) == hash_fnv1a(str, len) &&
+                    hash_division_seeded(str, len, 1000, 0) == hash_division(str, len, 1000) &&
+                    hash_multiplication_seeded(str, len, 1000, 0) == hash_multiplication(str, len, 1000) &&
+                    hash_string_djb2_seeded(str, 0) == hash_string_djb2(str) &&
+                    hash_string_fnv1a_seeded(str, 0) == hash_string_fnv1a(str),
+                "Seed 0 reproduces the classic functions");
+
+    int ok = 1;
+    for (size_t l = 0; l <= 600; l++)
+        ok &= hash_fast_seeded(pattern, l, 0) == hash_fast(pattern, l);
+    for (int32_t i = -100; i < 100; i++)
+    {
+        int64_t v = i;
+        ok &= hash_int32_seeded(&i, sizeof i, 0) == hash_int32(&i, sizeof i);
+        ok &= hash_int64_seeded(&v, sizeof v, 0) == hash_int64(&v, sizeof v);
+        ok &= hash_int32_seeded(&i, sizeof i, 77) == hash_fast_seeded(&i, sizeof i, 77);
+        ok &= hash_int64_seeded(&v, sizeof v, 77) == hash_fast_seeded(&v, sizeof v, 77);
+    }
+    test_assert(ok, "hash_fast family: seed 0 matches, integer paths match hash_fast_seeded");
+
+    // every length class must actually consume the seed
+    ok = 1;
+    for (size_t l = 0; l <= 600; l += (l < 40 ? 1 : 37))
+        ok &= hash_fast_seeded(pattern, l, 1) != hash_fast_seeded(pattern, l, 2);
+    test_assert(ok, "hash_fast_seeded depends on the seed at every length");
+    test_assert(hash_fnv1a_seeded(str, len, 1) != hash_fnv1a_seeded(str, len, 2) &&
+                    hash_string_djb2_seeded(str, 1) != hash_string_djb2_seeded(str, 2) &&
+                    hash_string_fnv1a_seeded(str, 1) != hash_string_fnv1a_seeded(str, 2),
+                "FNV-1a / djb2 depend on the seed");
+
+    // bytes >= 0x80 hash as plain char, exactly like the original unseeded djb2
+    const char *utf8 = "caf\xc3\xa9 \xe2\x82\xac";
+    size_t classic = 5381;
+    for (const char *p = utf8; *p; p++)
+        classic = ((classic << 5) + classic) + *p;
+    test_assert(hash_string_djb2(utf8) == classic && hash_string_djb2_seeded(utf8, 0) == classic,
+                "djb2 keeps its values for non-ASCII bytes");
+
+    // djb2 collisions of equal length ("Ez" / "FY") must not survive a seed
+    test_assert(hash_string_djb2("Ez") == hash_string_djb2("FY"), "Unseeded djb2 collides on Ez/FY");
+    int split = 0;
+    for (uint64_t seed = 1; seed <= 64; seed++)
+        split += hash_string_djb2_seeded("Ez", seed) != hash_string_djb2_seeded("FY", seed);
+    test_assert(split > 32, "Seeded djb2 separates the collision for most seeds");
+
+    // seeds give independent-looking functions: ~half the bits change
+    double flips = 0;
+    for (uint64_t seed = 1; seed <= 256; seed++)
+        flips += popcount64((uint64_t)hash_fast_seeded(pattern, 24, seed) ^
+                            (uint64_t)hash_fast_seeded(pattern, 24, seed ^ 1));
+    printf("  - Average flipped bits per seed bit: %.2f / 64\n", flips / 256);
+    test_assert(flips / 256 > 28 && flips / 256 < 36, "Seed avalanche");
+}
+
+int main()
+{
+    printf("Hash Function Tests\n");
+    printf("===================\n");
+
+    fill_pattern();
+    test_hash_fast_known_values();
+    test_hash_fast_integer_paths();
+    test_hash_fast_lengths();
+    test_hash_multiplication();
+    test_seeded_variants();
+
+    printf("\n✓ All hash function tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * test_helpers.h - 各后端测试共用的检查：遍历、批量建表、reserve / shrink_to_fit
+ *
+ * 只在 test_*.c 中包含；test_assert 由包含它的测试文件定义。
+ * 键都是 int，值为 key + 1（批量建表的重复键除外）。
+ */
+
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "hashtable.h"
+
+void test_assert(int condition, const char *test_name);
+
+typedef struct
+{
+    HashTable *ht;
+    unsigned char *seen;
+    int n;
+    size_t visited;
+    size_t limit; // stop after this many visits
+    int ok;
+} VisitCheck;
+
+/* Every key must be live and seen for the first time; lookups are allowed meanwhile */
+static bool check_visit(const void *key, size_t keysz, void *value, void *ctx)
+{
+    VisitCheck *vc = (VisitCheck *)ctx;
+    int k = *(const int *)key;
+    vc->ok &= keysz == sizeof(int) && k >= 0 && k < vc->n && !vc->seen[k] &&
+              (intptr_t)value == k + 1 && hashtable_search(vc->ht, &k, sizeof k) == value;
+    if (k >= 0 && k < vc->n)
+        vc->seen[k] = 1;
+    return ++vc->visited < vc->limit;
+}
+
+/**
+ * 插入 [0, n)，删掉 3 的倍数，再用 foreach 和游标各遍历一遍，检查：
+ * - 每个存活的键恰好访问一次，回调里可以查找同一张表
+ * - visit 返回 false 时 foreach 提前停止
+ * 结束时销毁 ht
+ */
+static void check_iteration(HashTable *ht, int n, const char *label)
+{
+    char name[128];
+    size_t live = 0;
+    for (int i = 0; i < n; i++)
+        hashtable_insert(ht, &i, sizeof i, (void *)(intptr_t)(i + 1));
+    for (int i = 0; i < n; i += 3)
+        hashtable_delete(ht, &i, sizeof i);
+    for (int i = 0; i < n; i++)
+        live += i % 3 != 0;
+
+    VisitCheck vc = {ht, calloc(n + 1, 1), n, 0, SIZE_MAX, 1};
+    snprintf(name, sizeof name, "%s: foreach visits every live key once", label);
+    test_assert(hashtable_foreach(ht, check_visit, &vc) && vc.ok && vc.visited == live, name);
+
+    memset(vc.seen, 0, n + 1);
+    vc.visited = 0;
+    vc.limit = 10;
+    snprintf(name, sizeof name, "%s: foreach stops when the callback returns false", label);
+    test_assert(live < 10 || (!hashtable_foreach(ht, check_visit, &vc) && vc.visited == 10), name);
+
+    memset(vc.seen, 0, n + 1);
+    vc.visited = 0;
+    vc.limit = SIZE_MAX;
+    HashIter it = hashtable_iter_begin(ht);
+    while (hashtable_iter_next(ht, &it))
+        check_visit(it.key, it.keysz, it.value, &vc);
+    snprintf(name, sizeof name, "%s: iterator yields every live key once", label);
+    test_assert(vc.ok && vc.visited == live && !hashtable_iter_next(ht, &it), name);
+
+    free(vc.seen);
+    hashtable_destroy(&ht);
+}
+
+/**
+ * 用 hashtable_build 一次插入 n 个键和其中前 100 个键的重复项，检查：
+ * - 重复的键以后出现的值为准（值为 -key - 1）
+ * - 建表最多扩容 max_resizes 次（分片表每个分片各一次）
+ * - 建好的表可以继续插入
+ * 结束时销毁 ht
+ */
+static void check_build(HashTable *ht, int n, size_t max_resizes, const char *label)
+{
+    char name[128];
+    size_t total = (size_t)n + 100;
+    int *keys = malloc(total * sizeof(int));
+    const void **kp = malloc(total * sizeof(void *));
+    size_t *ks = malloc(total * sizeof(size_t));
+    void **vals = malloc(total * sizeof(void *));
+    for (size_t i = 0; i < total; i++)
+    {
+        keys[i] = i < (size_t)n ? (int)i : (int)(i - n);
+        kp[i] = &keys[i];
+        ks[i] = sizeof(int);
+        vals[i] = (void *)(intptr_t)(i < (size_t)n ? keys[i] + 1 : -keys[i] - 1);
+    }
+
+    size_t resizes = hashtable_get_stats(ht).resize_count;
+    size_t built = hashtable_build(ht, kp, ks, vals, total);
+    snprintf(name, sizeof name, "%s: build inserts every key", label);
+    test_assert(built == total && hashtable_size(ht) == (size_t)n, name);
+    snprintf(name, sizeof name, "%s: build resizes at most %zu time(s)", label, max_resizes);
+    test_assert(hashtable_get_stats(ht).resize_count - resizes <= max_resizes, name);
+
+    int ok = 1;
+    for (int i = 0; i < n; i++)
+    {
+        intptr_t v = (intptr_t)hashtable_search(ht, &i, sizeof i);
+        ok &= v == (i < 100 ? -i - 1 : i + 1);
+    }
+    int more = n + 1;
+    ok &= hashtable_insert(ht, &more, sizeof more, (void *)(intptr_t)1) &&
+          hashtable_size(ht) == (size_t)n + 1;
+    snprintf(name, sizeof name, "%s: duplicates overwrite, table stays usable", label);
+    test_assert(ok, name);
+
+    free(keys);
+    free(kp);
+    free(ks);
+    free(vals);
+    hashtable_destroy(&ht);
+}
+
+/**
+ * 预留 n 个键后插满，再删到只剩 1%，最后 shrink_to_fit，检查：
+ * - 插满预留的容量时最多扩容 max_resizes 次（分片表每个分片可能各扩一次）
+ * - 删除不会缩小预留的容量，shrink_to_fit 会
+ * - 收缩后剩下的键都还在，且表仍可继续插入
+ * 结束时销毁 ht
+ */
+static void check_capacity_control(HashTable *ht, int n, size_t max_resizes, const char *label)
+{
+    char name[128];
+    size_t resizes = hashtable_get_stats(ht).resize_count;
+    snprintf(name, sizeof name, "%s: reserve succeeds", label);
+    test_assert(hashtable_reserve(ht, (size_t)n), name);
+    for (int i = 0; i < n; i++)
+        hashtable_insert(ht, &i, sizeof i, (void *)(intptr_t)(i + 1));
+    snprintf(name, sizeof name, "%s: filling the reservation resizes at most %zu time(s)", label,
+             max_resizes);
+    test_assert(hashtable_get_stats(ht).resize_count - resizes <= max_resizes, name);
+
+    size_t cap = hashtable_capacity(ht);
+    for (int i = n / 100; i < n; i++)
+        hashtable_delete(ht, &i, sizeof i);
+    snprintf(name, sizeof name, "%s: deleting keeps the reserved capacity", label);
+    test_assert(hashtable_capacity(ht) == cap, name);
+
+    snprintf(name, sizeof name, "%s: shrink_to_fit releases it", label);
+    test_assert(hashtable_shrink_to_fit(ht) && hashtable_capacity(ht) < cap, name);
+    int ok = hashtable_size(ht) == (size_t)(n / 100);
+    for (int i = 0; i < n; i++)
+    {
+        intptr_t v = (intptr_t)hashtable_search(ht, &i, sizeof i);
+        ok &= i < n / 100 ? v == i + 1 : v == 0;
+    }
+    ok &= hashtable_insert(ht, &n, sizeof n, (void *)(intptr_t)1) &&
+          hashtable_search(ht, &n, sizeof n) == (void *)(intptr_t)1;
+    snprintf(name, sizeof name, "%s: entries survive the shrink", label);
+    test_assert(ok, name);
+    hashtable_destroy(&ht);
+}
+
+#endif /* TEST_HELPERS_H */
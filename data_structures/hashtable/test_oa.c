@@ -5,11 +5,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
 #include "hashtable.h"
 #include "hashtable_oa.h"
 #include "hash.h"
 #include "../common/common.h"
+#include "test_helpers.h"
 
 void print_separator(const char *test_suite_name)
 {
@@ -474,6 +476,404 @@ void test_oa_load_factor_stress()
     hashtable_destroy(&ht);
 }
 
+void test_oa_power_of_two_probing()
+{
+    print_separator("Open Addressing: Power-of-Two Probing");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_oa_create(10, 0.5, keyops, PROBE_LINEAR, NULL);
+    test_assert(hashtable_capacity(ht) == 16, "Initial capacity rounded up to power of two");
+    hashtable_destroy(&ht);
+
+    // Load factor 1.0 never rehashes: every slot must be reachable by the probe sequence
+    ProbeStrategy probes[] = {PROBE_LINEAR, PROBE_QUADRATIC, PROBE_DOUBLEHASH};
+    const char *names[] = {"linear", "quadratic", "double hash"};
+    int keys[16];
+    for (int p = 0; p < 3; p++)
+    {
+        ht = hashtable_oa_create(16, 1.0, keyops, probes[p],
+                                 probes[p] == PROBE_DOUBLEHASH ? hash_fnv1a : NULL);
+        int inserted = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            keys[i] = i * 31;
+            inserted += hashtable_insert(ht, &keys[i], sizeof(int), &keys[i]);
+        }
+        printf("%s: inserted %d/16, capacity %zu\n", names[p], inserted, hashtable_capacity(ht));
+        test_assert(inserted == 16 && hashtable_capacity(ht) == 16, "Probe sequence covers the whole table");
+
+        int found = 0;
+        for (int i = 0; i < 16; i++)
+            found += hashtable_search(ht, &keys[i], sizeof(int)) == &keys[i];
+        test_assert(found == 16, "All keys found in a full table");
+        hashtable_destroy(&ht);
+    }
+}
+
+void test_oa_incremental_resize()
+{
+    print_separator("Open Addressing: Incremental Resize");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = free};
+
+    ProbeStrategy probes[] = {PROBE_LINEAR, PROBE_QUADRATIC, PROBE_DOUBLEHASH, PROBE_ROBINHOOD};
+    for (int p = 0; p < 4; p++)
+    {
+        HashTable *ht = hashtable_oa_create_ex(8, 0.5, keyops, probes[p],
+                                               probes[p] == PROBE_DOUBLEHASH ? hash_fnv1a : NULL,
+                                               RESIZE_INCREMENTAL);
+        test_assert(ht != NULL, "Create OA hashtable with incremental resize");
+
+        // Lookups, updates and deletes interleaved with inserts hit keys on both tables
+        int ok = 1;
+        for (int i = 0; i < 5000; i++)
+        {
+            int *v = malloc(sizeof *v);
+            *v = i;
+            ok &= hashtable_insert(ht, &i, sizeof(int), v);
+            int probe = i / 2;
+            int *found = (int *)hashtable_search(ht, &probe, sizeof(int));
+            if (probe % 3 == 0 && i > 2 * probe)
+                ok &= (found == NULL);
+            else
+                ok &= (found != NULL && *found == probe);
+            if (i % 2 == 0 && probe % 3 == 0)
+                ok &= hashtable_delete(ht, &probe, sizeof(int));
+        }
+        test_assert(ok, "Operations consistent during migration");
+
+        for (int i = 0; i < 5000; i += 7)
+        {
+            int *v = malloc(sizeof *v);
+            *v = -i;
+            if (!hashtable_update(ht, &i, sizeof(int), v))
+                free(v);
+        }
+
+        size_t expected = 0;
+        ok = 1;
+        for (int i = 0; i < 5000; i++)
+        {
+            int *found = (int *)hashtable_search(ht, &i, sizeof(int));
+            if (i % 3 == 0 && i < 2500)
+            {
+                ok &= (found == NULL);
+                continue;
+            }
+            expected++;
+            ok &= (found != NULL && *found == (i % 7 == 0 ? -i : i));
+        }
+        test_assert(ok, "All keys consistent after incremental resizing");
+        test_assert(hashtable_size(ht) == expected, "Size counts entries of both tables");
+        test_assert(hashtable_capacity(ht) >= 8192, "Capacity grew");
+        hashtable_destroy(&ht);
+    }
+}
+
+void test_oa_robinhood()
+{
+    print_separator("Open Addressing: Robin Hood Probing");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = free};
+
+    ResizeMode modes[] = {RESIZE_ALL_AT_ONCE, RESIZE_INCREMENTAL};
+    for (int m = 0; m < 2; m++)
+    {
+        HashTable *ht = hashtable_oa_create_ex(8, 0.95, keyops, PROBE_ROBINHOOD, NULL, modes[m]);
+        test_assert(ht != NULL, "Create hashtable with Robin Hood probing");
+
+        int ok = 1;
+        for (int i = 0; i < 20000; i++)
+        {
+            int *v = malloc(sizeof *v);
+            *v = i;
+            ok &= hashtable_insert(ht, &i, sizeof(int), v);
+        }
+        test_assert(ok && hashtable_size(ht) == 20000, "Insert at load factor 0.95");
+
+        // Backward-shift deletion leaves no tombstones behind
+        for (int i = 0; i < 20000; i += 2)
+            ok &= hashtable_delete(ht, &i, sizeof(int));
+        test_assert(ok && hashtable_size(ht) == 10000, "Delete half of the keys");
+        if (modes[m] == RESIZE_ALL_AT_ONCE)
+            test_assert(hashtable_load_factor(ht) ==
+                            (double)hashtable_size(ht) / hashtable_capacity(ht),
+                        "No tombstones counted in the load factor");
+
+        for (int i = 0; i < 20000; i++)
+        {
+            int *found = (int *)hashtable_search(ht, &i, sizeof(int));
+            ok &= (i % 2 == 0) ? (found == NULL) : (found != NULL && *found == i);
+        }
+        int missing = -1;
+        ok &= hashtable_search(ht, &missing, sizeof(int)) == NULL;
+        test_assert(ok, "Lookups consistent after backward shifts");
+
+        // Refill the holes, then churn on a table that never grows
+        size_t capacity = hashtable_capacity(ht);
+        for (int round = 0; round < 5; round++)
+        {
+            for (int i = 0; i < 20000; i += 2)
+            {
+                int *v = malloc(sizeof *v);
+                *v = i + round;
+                ok &= hashtable_insert(ht, &i, sizeof(int), v);
+            }
+            for (int i = 0; i < 20000; i += 2)
+                ok &= hashtable_delete(ht, &i, sizeof(int));
+        }
+        test_assert(ok && hashtable_size(ht) == 10000, "Insert/delete churn");
+        test_assert(hashtable_capacity(ht) == capacity, "Churn does not trigger a rehash");
+        hashtable_destroy(&ht);
+    }
+
+    // Completely full table: lookups of missing keys still terminate
+    HashKeyOps int_ops = {.hash = hash_fnv1a, .eq = compare_int};
+    HashTable *ht = hashtable_oa_create(16, 1.0, int_ops, PROBE_ROBINHOOD, NULL);
+    int keys[17];
+    int inserted = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        keys[i] = i * 31;
+        inserted += hashtable_insert(ht, &keys[i], sizeof(int), &keys[i]);
+    }
+    keys[16] = 12345;
+    test_assert(inserted == 16 && hashtable_capacity(ht) == 16, "Fill every slot");
+    test_assert(hashtable_search(ht, &keys[16], sizeof(int)) == NULL, "Miss on a full table");
+    hashtable_destroy(&ht);
+}
+
+static int destroyed_keys = 0;
+
+/* Unique string key for i; lengths cover inline keys, arena size classes and oversized keys */
+static size_t make_key(char *buf, int i)
+{
+    static const size_t lengths[] = {8, 15, 16, 40, 255, 600};
+    size_t len = lengths[i % 6];
+    char id[8];
+    memset(buf, 'a' + i % 26, len);
+    snprintf(id, sizeof id, "%07d", i);
+    memcpy(buf, id, 7);
+    buf[len - 1] = '\0';
+    return len;
+}
+
+static void count_destroy_key(void *key)
+{
+    destroyed_keys++;
+    free(key);
+}
+
+void test_oa_key_storage()
+{
+    print_separator("Open Addressing: Key Storage");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_string,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    char buf[700];
+    HashTable *ht = hashtable_oa_create(8, 0.5, keyops, PROBE_LINEAR, NULL);
+    int ok = 1;
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 300; i++)
+        {
+            size_t len = make_key(buf, i);
+            ok &= hashtable_insert(ht, buf, len, (void *)(size_t)(i + 1));
+        }
+        for (int i = 0; i < 300; i++)
+        {
+            size_t len = make_key(buf, i);
+            ok &= hashtable_search(ht, buf, len) == (void *)(size_t)(i + 1);
+            // freed arena blocks are reused by the next round
+            if (round < 2 && i % 2)
+                ok &= hashtable_delete(ht, buf, len);
+        }
+    }
+    test_assert(ok, "Inline, arena and oversized keys round-trip");
+    test_assert(hashtable_insert_int(ht, 42, buf) && hashtable_search_int(ht, 42) == buf,
+                "Int keys use the inline path");
+    hashtable_destroy(&ht);
+
+    // With destroy_key every key is a separately allocated copy handed to the callback
+    HashKeyOps heap_ops = keyops;
+    heap_ops.destroy_key = count_destroy_key;
+    ht = hashtable_oa_create(8, 0.5, heap_ops, PROBE_ROBINHOOD, NULL);
+    test_assert(hashtable_insert_string(ht, "short", NULL), "Insert with destroy_key");
+    test_assert(hashtable_insert_string(ht, "a somewhat longer key", NULL), "Insert long key");
+    test_assert(hashtable_delete_string(ht, "short"), "Delete with destroy_key");
+    test_assert(destroyed_keys == 1, "destroy_key called on delete");
+    hashtable_destroy(&ht);
+    test_assert(destroyed_keys == 2, "destroy_key called on destroy");
+}
+
+void test_oa_batch_operations()
+{
+    print_separator("Open Addressing: Batch Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_oa_create(8, 0.5, keyops, PROBE_LINEAR, NULL);
+    enum { N = 1000 };
+    static int keys[2 * N];
+    const void *kp[2 * N];
+    size_t ksz[2 * N];
+    void *vals[2 * N];
+    void *out[2 * N];
+    for (int i = 0; i < 2 * N; i++)
+    {
+        keys[i] = i * 7 + 1;
+        kp[i] = &keys[i];
+        ksz[i] = sizeof(int);
+        vals[i] = &keys[i];
+    }
+
+    // N is not a multiple of the internal batch size; the table grows mid-batch
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals, N) == N, "Insert batch");
+    test_assert(hashtable_size(ht) == N, "Size after insert batch");
+
+    // second half of the keys was never inserted
+    size_t found = hashtable_search_batch(ht, kp, ksz, 2 * N, out);
+    test_assert(found == N, "Search batch hit count");
+    int ok = 1;
+    for (int i = 0; i < 2 * N; i++)
+        ok &= out[i] == (i < N ? &keys[i] : NULL);
+    test_assert(ok, "Search batch results match single lookups");
+
+    // Re-inserting existing keys through the batch API updates them
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals + 1, N) == N, "Update via insert batch");
+    test_assert(hashtable_search(ht, kp[0], sizeof(int)) == &keys[1], "Batch insert updated value");
+    test_assert(hashtable_search_batch(ht, kp, ksz, 0, out) == 0, "Empty batch");
+
+    hashtable_destroy(&ht);
+}
+
+void test_oa_stats()
+{
+    print_separator("Open Addressing: Statistics");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    ProbeStrategy strategies[] = {PROBE_LINEAR, PROBE_ROBINHOOD};
+    ResizeMode modes[] = {RESIZE_ALL_AT_ONCE, RESIZE_INCREMENTAL};
+    for (int s = 0; s < 2; s++)
+    {
+        for (int m = 0; m < 2; m++)
+        {
+            HashTable *ht = hashtable_oa_create_ex(8, 0.75, keyops, strategies[s], NULL, modes[m]);
+            static int keys[3000];
+            for (int i = 0; i < 3000; i++)
+            {
+                keys[i] = i;
+                hashtable_insert(ht, &keys[i], sizeof(int), &keys[i]);
+            }
+            for (int i = 0; i < 3000; i += 4)
+                hashtable_delete(ht, &keys[i], sizeof(int));
+            for (int i = 3000; i < 3500; i++)
+                hashtable_search(ht, &i, sizeof(int));
+
+            HashStats stats = hashtable_get_stats(ht);
+            size_t total = 0, longest = 0;
+            for (size_t i = 0; i < HT_HIST_BUCKETS; i++)
+            {
+                total += stats.histogram[i];
+                if (stats.histogram[i])
+                    longest = i;
+            }
+            test_assert(stats.total_elements == 2250, "Stats element count");
+            test_assert(total == stats.total_elements, "Probe histogram covers every entry");
+            test_assert(stats.histogram[0] == 0, "Probe lengths start at 1");
+            test_assert(longest <= stats.max_chain_or_probe, "Max probe bounds the histogram");
+            test_assert(stats.avg_probe_success >= 1.0, "Average successful probe");
+            test_assert(stats.avg_probe_failure >= 1.0, "Average unsuccessful probe");
+            test_assert(stats.resize_count > 0, "Resizes counted");
+            test_assert(stats.bytes_used >= hashtable_capacity(ht) * sizeof(int), "Bytes used");
+            if (strategies[s] == PROBE_LINEAR && modes[m] == RESIZE_ALL_AT_ONCE)
+                test_assert(stats.tombstones > 0, "Deletes leave tombstones");
+            if (strategies[s] == PROBE_ROBINHOOD && modes[m] == RESIZE_ALL_AT_ONCE)
+                test_assert(stats.tombstones == 0, "Backward shift leaves no tombstones");
+            hashtable_destroy(&ht);
+        }
+    }
+}
+
+void test_oa_iteration()
+{
+    print_separator("OA: Iteration");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_iteration(hashtable_oa_create(8, 0.5, keyops, PROBE_LINEAR, NULL), 2000, "Linear");
+    check_iteration(hashtable_oa_create(8, 0.9, keyops, PROBE_ROBINHOOD, NULL), 2000, "Robin Hood");
+    check_iteration(hashtable_oa_create_ex(8, 0.5, keyops, PROBE_LINEAR, NULL, RESIZE_INCREMENTAL),
+                    1600, "Incremental");
+    check_iteration(hashtable_oa_create(8, 0.5, keyops, PROBE_LINEAR, NULL), 0, "Empty");
+}
+
+void test_oa_build()
+{
+    print_separator("OA: Bulk Build");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_build(hashtable_oa_create(8, 0.5, keyops, PROBE_LINEAR, NULL), 50000, 1, "Linear");
+    check_build(hashtable_oa_create(8, 0.9, keyops, PROBE_ROBINHOOD, NULL), 50000, 1, "Robin Hood");
+    check_build(hashtable_oa_create_ex(8, 0.5, keyops, PROBE_LINEAR, NULL, RESIZE_INCREMENTAL),
+                50000, 1, "Incremental");
+}
+
+void test_oa_capacity_control()
+{
+    print_separator("OA: Reserve and Shrink");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_capacity_control(hashtable_oa_create(8, 0.5, keyops, PROBE_LINEAR, NULL), 20000, 1, "Linear");
+    check_capacity_control(hashtable_oa_create(8, 0.9, keyops, PROBE_ROBINHOOD, NULL), 20000, 1,
+                           "Robin Hood");
+    check_capacity_control(hashtable_oa_create_ex(8, 0.5, keyops, PROBE_LINEAR, NULL, RESIZE_INCREMENTAL),
+                           20000, 1, "Incremental");
+}
+
 int main()
 {
     printf("Open Addressing Hashtable Implementation Tests\n");
@@ -487,6 +887,15 @@ int main()
     test_oa_string_keys();
     test_oa_edge_cases();
     test_oa_load_factor_stress();
+    test_oa_power_of_two_probing();
+    test_oa_incremental_resize();
+    test_oa_robinhood();
+    test_oa_key_storage();
+    test_oa_batch_operations();
+    test_oa_stats();
+    test_oa_iteration();
+    test_oa_build();
+    test_oa_capacity_control();
 
     printf("\n✓ All open addressing hashtable tests passed!\n");
     printf("Open addressing implementation appears to be working correctly.\n");
@@ -0,0 +1,384 @@
+/**
+ * test_oa_rcu.c - Test cases for the lock-free read open addressing hashtable
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "hashtable.h"
+#include "hashtable_oa_rcu.h"
+#include "hash.h"
+#include "../common/common.h"
+#include "test_helpers.h"
+
+void print_separator(const char *test_suite_name)
+{
+    printf("\n--- %s ---\n", test_suite_name);
+}
+
+void test_assert(int condition, const char *test_name)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", test_name);
+    }
+    else
+    {
+        printf("✗ %s FAILED\n", test_name);
+        exit(1);
+    }
+}
+
+static int destroyed_vals = 0;
+
+static void count_destroy_val(void *val)
+{
+    __atomic_fetch_add(&destroyed_vals, 1, __ATOMIC_RELAXED);
+    free(val);
+}
+
+static int *new_int(int v)
+{
+    int *p = malloc(sizeof *p);
+    *p = v;
+    return p;
+}
+
+void test_oa_rcu_basic_operations()
+{
+    print_separator("OA RCU: Basic Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_oa_rcu_create(8, 0.75, keyops);
+    test_assert(ht != NULL, "Create RCU hashtable");
+    test_assert(hashtable_size(ht) == 0, "Initial size is 0");
+    test_assert(hashtable_capacity(ht) == 8, "Initial capacity is 8");
+
+    int key1 = 10, val1 = 100;
+    int key2 = 20, val2 = 200;
+    test_assert(hashtable_insert(ht, &key1, sizeof(int), &val1), "Insert key1");
+    test_assert(hashtable_insert(ht, &key2, sizeof(int), &val2), "Insert key2");
+    test_assert(hashtable_size(ht) == 2, "Size after insertions");
+
+    int *found = (int *)hashtable_search(ht, &key1, sizeof(int));
+    test_assert(found != NULL && *found == val1, "Search existing key1");
+    int nonexistent = 999;
+    test_assert(hashtable_search(ht, &nonexistent, sizeof(int)) == NULL, "Search non-existent key");
+
+    int new_val1 = 1000;
+    test_assert(hashtable_update(ht, &key1, sizeof(int), &new_val1), "Update existing key");
+    test_assert(hashtable_search(ht, &key1, sizeof(int)) == &new_val1, "Verify updated value");
+    test_assert(!hashtable_update(ht, &nonexistent, sizeof(int), &val1), "Update missing key fails");
+
+    test_assert(hashtable_delete(ht, &key2, sizeof(int)), "Delete existing key");
+    test_assert(!hashtable_delete(ht, &key2, sizeof(int)), "Delete twice fails");
+    test_assert(hashtable_search(ht, &key2, sizeof(int)) == NULL, "Deleted key not found");
+    test_assert(hashtable_size(ht) == 1, "Size after deletion");
+
+    test_assert(hashtable_insert_string(ht, "a key longer than sixteen bytes", &val2) &&
+                    hashtable_search_string(ht, "a key longer than sixteen bytes") == &val2,
+                "Arena-stored key");
+
+    hashtable_destroy(&ht);
+    test_assert(ht == NULL, "Destroy hashtable");
+}
+
+void test_oa_rcu_rehash_and_reclaim()
+{
+    print_separator("OA RCU: Rehash and Deferred Reclamation");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = count_destroy_val};
+
+    HashTable *ht = hashtable_oa_rcu_create(8, 0.75, keyops);
+    for (int i = 0; i < 5000; i++)
+        hashtable_insert(ht, &i, sizeof(int), new_int(i));
+    test_assert(hashtable_capacity(ht) > 8, "Capacity grew");
+    test_assert(hashtable_load_factor(ht) <= 0.75, "Load factor below threshold");
+
+    for (int i = 0; i < 5000; i += 2)
+        hashtable_delete(ht, &i, sizeof(int));
+    for (int i = 1; i < 5000; i += 2)
+        hashtable_update(ht, &i, sizeof(int), new_int(-i));
+
+    // reclamation runs in batches: most, but not necessarily all, values are gone
+    test_assert(destroyed_vals > 0 && destroyed_vals <= 5000, "Values reclaimed in batches");
+
+    int ok = 1;
+    for (int i = 0; i < 5000; i++)
+    {
+        int *found = (int *)hashtable_search(ht, &i, sizeof(int));
+        ok &= (i % 2 == 0) ? found == NULL : (found != NULL && *found == -i);
+    }
+    test_assert(ok, "All keys consistent after churn");
+
+    HashStats stats = hashtable_get_stats(ht);
+    size_t total = 0;
+    for (size_t i = 0; i < HT_HIST_BUCKETS; i++)
+        total += stats.histogram[i];
+    test_assert(stats.total_elements == 2500 && total == 2500, "Stats histogram");
+    test_assert(stats.resize_count > 0, "Resizes counted");
+    test_assert(stats.avg_probe_failure >= 1.0, "Average unsuccessful probe");
+
+    hashtable_destroy(&ht);
+    test_assert(destroyed_vals == 7500, "Every value destroyed exactly once");
+}
+
+enum { READERS = 4, STABLE = 1000, CHURN = 2000, ROUNDS = 4 };
+
+/*
+ * 读者在 rcu_enter 里读到 epoch 之后、登记之前停住；这期间写者走完一次宽限期。
+ * 读者随后登记并拿到值，写者替换该值并再走一次宽限期：第二次宽限期必须等这个读者离开，
+ * 否则值会在读者仍在使用时被回收。
+ */
+enum { STALL_IDLE, STALL_WAITING, STALL_GO, STALL_HOLDING };
+
+static __thread int stall_this_thread;
+static int stall_state;
+
+static void stall_reader(void)
+{
+    if (!stall_this_thread)
+        return;
+    stall_this_thread = 0;
+    __atomic_store_n(&stall_state, STALL_WAITING, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&stall_state, __ATOMIC_SEQ_CST) != STALL_GO)
+        sched_yield();
+}
+
+enum { STALL_LIVE = 42, STALL_DEAD = -1 };
+
+static void poison_val(void *val)
+{
+    // values live in the test, so a premature destroy is visible instead of a use-after-free
+    __atomic_store_n((int *)val, STALL_DEAD, __ATOMIC_SEQ_CST);
+}
+
+typedef struct
+{
+    HashTable *ht;
+    int key;
+    int ok;
+} StallReader;
+
+static void *stalled_reader_run(void *arg)
+{
+    StallReader *r = (StallReader *)arg;
+    stall_this_thread = 1;
+    unsigned token = hashtable_rcu_read_lock(r->ht);
+    int *v = (int *)hashtable_search(r->ht, &r->key, sizeof(int));
+    __atomic_store_n(&stall_state, STALL_HOLDING, __ATOMIC_SEQ_CST);
+
+    // keep using the value while the writer retires it
+    struct timespec ts = {0, 20 * 1000 * 1000};
+    nanosleep(&ts, NULL);
+    r->ok = v != NULL && __atomic_load_n(v, __ATOMIC_SEQ_CST) == STALL_LIVE;
+    hashtable_rcu_read_unlock(r->ht, token);
+    return NULL;
+}
+
+static void wait_stall_state(int state)
+{
+    while (__atomic_load_n(&stall_state, __ATOMIC_SEQ_CST) != state)
+        sched_yield();
+}
+
+void test_oa_rcu_reader_stall_between_epoch_and_register()
+{
+    print_separator("OA RCU: Reader Stalled Between Epoch Load and Register");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = poison_val};
+
+    hashtable_rcu_enter_stall = stall_reader;
+    int ok = 1;
+    for (int round = 0; round < 10; round++)
+    {
+        HashTable *ht = hashtable_oa_rcu_create(64, 0.75, keyops);
+        int vals[2] = {STALL_LIVE, STALL_LIVE};
+        StallReader r = {ht, 7, 0};
+        hashtable_insert(ht, &r.key, sizeof(int), &vals[0]);
+
+        // odd rounds start from the other epoch
+        if (round % 2)
+            hashtable_rcu_test_synchronize(ht);
+
+        __atomic_store_n(&stall_state, STALL_IDLE, __ATOMIC_SEQ_CST);
+        pthread_t reader;
+        pthread_create(&reader, NULL, stalled_reader_run, &r);
+
+        // grace period #1 while the reader holds a stale epoch but is not yet counted
+        wait_stall_state(STALL_WAITING);
+        hashtable_rcu_test_synchronize(ht);
+        __atomic_store_n(&stall_state, STALL_GO, __ATOMIC_SEQ_CST);
+
+        // retire the value the reader now holds; grace period #2 must wait for it
+        wait_stall_state(STALL_HOLDING);
+        hashtable_update(ht, &r.key, sizeof(int), &vals[1]);
+        hashtable_rcu_test_synchronize(ht);
+        ok &= vals[0] == STALL_DEAD; // reclaimed once the reader is gone
+
+        pthread_join(reader, NULL);
+        ok &= r.ok;
+        hashtable_destroy(&ht);
+    }
+    hashtable_rcu_enter_stall = NULL;
+
+    test_assert(ok, "Value outlives a reader that registered after a grace period began");
+}
+
+typedef struct
+{
+    HashTable *ht;
+    int stop;
+    int ok;
+    long lookups;
+} Shared;
+
+/* 读者：稳定键必须一直查得到；变动键可以不存在，存在时值必须与键一致 */
+static void *reader_run(void *arg)
+{
+    Shared *sh = (Shared *)arg;
+    int ok = 1;
+    long lookups = 0;
+    while (!__atomic_load_n(&sh->stop, __ATOMIC_ACQUIRE))
+    {
+        for (int k = 0; k < STABLE + CHURN; k++)
+        {
+            unsigned token = hashtable_rcu_read_lock(sh->ht);
+            int *v = (int *)hashtable_search(sh->ht, &k, sizeof(int));
+            if (k < STABLE)
+                ok &= v != NULL && *v == k;
+            else if (v)
+                ok &= *v == k || *v == -k; // value read inside the critical section
+            hashtable_rcu_read_unlock(sh->ht, token);
+            lookups++;
+        }
+    }
+    if (!ok)
+        __atomic_store_n(&sh->ok, 0, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&sh->lookups, lookups, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+void test_oa_rcu_concurrent_readers()
+{
+    print_separator("OA RCU: Concurrent Readers, Single Writer");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = free};
+
+    HashTable *ht = hashtable_oa_rcu_create(8, 0.75, keyops);
+    for (int k = 0; k < STABLE; k++)
+        hashtable_insert(ht, &k, sizeof(int), new_int(k));
+
+    Shared sh = {ht, 0, 1, 0};
+    pthread_t threads[READERS];
+    for (int t = 0; t < READERS; t++)
+        pthread_create(&threads[t], NULL, reader_run, &sh);
+
+    // the writer keeps inserting, updating and erasing; the table rehashes as it goes
+    int ok = 1;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (int k = STABLE; k < STABLE + CHURN; k++)
+            ok &= hashtable_insert(ht, &k, sizeof(int), new_int(k));
+        for (int k = STABLE; k < STABLE + CHURN; k += 3)
+            ok &= hashtable_update(ht, &k, sizeof(int), new_int(-k));
+        for (int k = STABLE; k < STABLE + CHURN; k++)
+            ok &= hashtable_delete(ht, &k, sizeof(int));
+        for (int k = 0; k < STABLE; k += 7)
+            ok &= hashtable_update(ht, &k, sizeof(int), new_int(k));
+    }
+    __atomic_store_n(&sh.stop, 1, __ATOMIC_RELEASE);
+    for (int t = 0; t < READERS; t++)
+        pthread_join(threads[t], NULL);
+
+    printf("  - Lookups during writes: %ld\n", sh.lookups);
+    test_assert(ok, "Writer operations succeed");
+    test_assert(sh.ok, "Readers never saw a missing stable key or a torn value");
+    test_assert(hashtable_size(ht) == STABLE, "Final size");
+
+    hashtable_destroy(&ht);
+}
+
+void test_oa_rcu_iteration()
+{
+    print_separator("OA RCU: Iteration");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_iteration(hashtable_oa_rcu_create(8, 0.75, keyops), 2000, "RCU");
+}
+
+void test_oa_rcu_build()
+{
+    print_separator("OA RCU: Bulk Build");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_build(hashtable_oa_rcu_create(8, 0.75, keyops), 50000, 1, "RCU");
+}
+
+void test_oa_rcu_capacity_control()
+{
+    print_separator("OA RCU: Reserve and Shrink");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_capacity_control(hashtable_oa_rcu_create(8, 0.75, keyops), 20000, 1, "RCU");
+}
+
+int main()
+{
+    printf("Lock-free Read OA Hashtable Implementation Tests\n");
+    printf("================================================\n");
+
+    test_oa_rcu_basic_operations();
+    test_oa_rcu_rehash_and_reclaim();
+    test_oa_rcu_concurrent_readers();
+    test_oa_rcu_reader_stall_between_epoch_and_register();
+    test_oa_rcu_iteration();
+    test_oa_rcu_build();
+    test_oa_rcu_capacity_control();
+
+    printf("\n✓ All lock-free read OA hashtable tests passed!\n");
+
+    return 0;
+}
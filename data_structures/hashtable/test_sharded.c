@@ -0,0 +1,280 @@
+/**
+ * test_sharded.c - Test cases for the sharded (striped lock) concurrent hashtable
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include "hashtable.h"
+#include "hashtable_sharded.h"
+#include "hashtable_chaining.h"
+#include "hashtable_oa.h"
+#include "hash.h"
+#include "../common/common.h"
+#include "test_helpers.h"
+
+void print_separator(const char *test_suite_name)
+{
+    printf("\n--- %s ---\n", test_suite_name);
+}
+
+void test_assert(int condition, const char *test_name)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", test_name);
+    }
+    else
+    {
+        printf("✗ %s FAILED\n", test_name);
+        exit(1);
+    }
+}
+
+static HashKeyOps int_keyops = {
+    .hash = hash_fnv1a,
+    .eq = compare_int,
+    .destroy_key = NULL,
+    .destroy_val = NULL};
+
+static HashTable *make_chaining(void *ctx)
+{
+    (void)ctx;
+    return hashtable_chaining_create_ex(8, 0.75, int_keyops, RESIZE_INCREMENTAL);
+}
+
+static HashTable *make_oa(void *ctx)
+{
+    size_t capacity = ctx ? *(size_t *)ctx : 8;
+    return hashtable_oa_create(capacity, 0.9, int_keyops, PROBE_ROBINHOOD, NULL);
+}
+
+static int factory_calls = 0;
+
+static HashTable *make_failing(void *ctx)
+{
+    (void)ctx;
+    return ++factory_calls == 3 ? NULL : make_chaining(NULL);
+}
+
+void test_sharded_basic_operations()
+{
+    print_separator("Sharded: Basic Operations");
+
+    HashTable *ht = hashtable_sharded_create(5, make_chaining, NULL);
+    test_assert(ht != NULL, "Create sharded hashtable");
+    test_assert(hashtable_size(ht) == 0, "Initial size is 0");
+    test_assert(hashtable_capacity(ht) == 8 * 8, "Shard count rounded up to a power of two");
+
+    int key1 = 10, val1 = 100;
+    int key2 = 20, val2 = 200;
+    test_assert(hashtable_insert(ht, &key1, sizeof(int), &val1), "Insert key1");
+    test_assert(hashtable_insert(ht, &key2, sizeof(int), &val2), "Insert key2");
+    test_assert(hashtable_size(ht) == 2, "Size after insertions");
+
+    int *found = (int *)hashtable_search(ht, &key1, sizeof(int));
+    test_assert(found != NULL && *found == val1, "Search existing key1");
+    int nonexistent = 999;
+    test_assert(hashtable_search(ht, &nonexistent, sizeof(int)) == NULL, "Search non-existent key");
+
+    int new_val1 = 1000;
+    test_assert(hashtable_update(ht, &key1, sizeof(int), &new_val1), "Update existing key");
+    found = (int *)hashtable_search(ht, &key1, sizeof(int));
+    test_assert(found != NULL && *found == new_val1, "Verify updated value");
+
+    test_assert(hashtable_delete(ht, &key2, sizeof(int)), "Delete existing key");
+    test_assert(!hashtable_delete(ht, &key2, sizeof(int)), "Delete twice fails");
+    test_assert(hashtable_size(ht) == 1, "Size after deletion");
+
+    test_assert(hashtable_insert_int(ht, 7, &val2) && hashtable_search_int(ht, 7) == &val2,
+                "Convenience int API");
+    hashtable_destroy(&ht);
+    test_assert(ht == NULL, "Destroy hashtable");
+
+    // a single shard degenerates to the backend behind one lock
+    ht = hashtable_sharded_create(1, make_chaining, NULL);
+    for (int i = 0; i < 100; i++)
+        hashtable_insert_int(ht, i, NULL);
+    test_assert(hashtable_size(ht) == 100, "Single shard");
+    hashtable_destroy(&ht);
+
+    test_assert(hashtable_sharded_create(4, make_failing, NULL) == NULL,
+                "Factory failure is reported");
+}
+
+void test_sharded_distribution_and_stats()
+{
+    print_separator("Sharded: Distribution and Stats");
+
+    size_t shard_capacity = 64;
+    HashTable *ht = hashtable_sharded_create(16, make_oa, &shard_capacity);
+    test_assert(hashtable_capacity(ht) == 16 * 64, "Factory context reaches every shard");
+
+    static int keys[20000];
+    for (int i = 0; i < 20000; i++)
+    {
+        keys[i] = i;
+        hashtable_insert(ht, &keys[i], sizeof(int), &keys[i]);
+    }
+    for (int i = 0; i < 20000; i += 2)
+        hashtable_delete(ht, &keys[i], sizeof(int));
+
+    HashStats stats = hashtable_get_stats(ht);
+    size_t total = 0;
+    for (size_t i = 0; i < HT_HIST_BUCKETS; i++)
+        total += stats.histogram[i];
+    test_assert(stats.total_elements == 10000, "Stats sum over shards");
+    test_assert(total == stats.total_elements, "Histograms merged");
+    test_assert(stats.resize_count >= 16, "Every shard grew");
+    test_assert(hashtable_load_factor(ht) <= 0.9, "Load factor over all shards");
+
+    int ok = 1;
+    for (int i = 0; i < 20000; i++)
+        ok &= hashtable_search(ht, &keys[i], sizeof(int)) == (i % 2 ? &keys[i] : NULL);
+    test_assert(ok, "All keys consistent across shards");
+
+    hashtable_destroy(&ht);
+}
+
+enum { THREADS = 8, PER_THREAD = 20000 };
+
+typedef struct
+{
+    HashTable *ht;
+    int id;
+    int ok;
+} Worker;
+
+static int worker_keys[THREADS * PER_THREAD];
+
+/* 每个线程写自己的键区间，同时读其他线程的键，最后删掉自己的一半 */
+static void *worker_run(void *arg)
+{
+    Worker *w = (Worker *)arg;
+    int base = w->id * PER_THREAD;
+    w->ok = 1;
+    for (int i = 0; i < PER_THREAD; i++)
+    {
+        int *k = &worker_keys[base + i];
+        w->ok &= hashtable_insert(w->ht, k, sizeof(int), k);
+        int other = ((w->id + 1) % THREADS) * PER_THREAD + i;
+        void *v = hashtable_search(w->ht, &other, sizeof(int));
+        // the owner may already have moved on to its update pass
+        w->ok &= (v == NULL || v == &worker_keys[other] ||
+                  (other % 2 && v == &worker_keys[other - 1]));
+    }
+    for (int i = 0; i < PER_THREAD; i += 2)
+        w->ok &= hashtable_delete(w->ht, &worker_keys[base + i], sizeof(int));
+    for (int i = 1; i < PER_THREAD; i += 2)
+        w->ok &= hashtable_update(w->ht, &worker_keys[base + i], sizeof(int), &worker_keys[base + i - 1]);
+    return NULL;
+}
+
+void test_sharded_concurrent_access()
+{
+    print_separator("Sharded: Concurrent Access");
+
+    hashtable_factory_t factories[] = {make_chaining, make_oa};
+    const char *names[] = {"chaining shards", "OA shards"};
+    for (int f = 0; f < 2; f++)
+    {
+        HashTable *ht = hashtable_sharded_create(32, factories[f], NULL);
+        for (int i = 0; i < THREADS * PER_THREAD; i++)
+            worker_keys[i] = i;
+
+        pthread_t threads[THREADS];
+        Worker workers[THREADS];
+        for (int t = 0; t < THREADS; t++)
+        {
+            workers[t] = (Worker){ht, t, 0};
+            pthread_create(&threads[t], NULL, worker_run, &workers[t]);
+        }
+        int ok = 1;
+        for (int t = 0; t < THREADS; t++)
+        {
+            pthread_join(threads[t], NULL);
+            ok &= workers[t].ok;
+        }
+        test_assert(ok, names[f]);
+        test_assert(hashtable_size(ht) == THREADS * PER_THREAD / 2, "Size after concurrent churn");
+
+        ok = 1;
+        for (int i = 0; i < THREADS * PER_THREAD; i++)
+        {
+            void *v = hashtable_search(ht, &worker_keys[i], sizeof(int));
+            ok &= v == (i % 2 ? &worker_keys[i - 1] : NULL);
+        }
+        test_assert(ok, "Final contents match");
+        hashtable_destroy(&ht);
+    }
+}
+
+/* Updates the visited key in place; the shard it lives in must not be locked during the callback */
+static bool update_visit(const void *key, size_t keysz, void *value, void *ctx)
+{
+    HashTable *ht = (HashTable *)ctx;
+    return hashtable_update(ht, key, keysz, (void *)((intptr_t)value * 2)) &&
+           hashtable_search(ht, key, keysz) == (void *)((intptr_t)value * 2);
+}
+
+void test_sharded_iteration()
+{
+    print_separator("Sharded: Iteration");
+
+    check_iteration(hashtable_sharded_create(5, make_chaining, NULL), 2000, "Chaining shards");
+    size_t shard_capacity = 8;
+    check_iteration(hashtable_sharded_create(16, make_oa, &shard_capacity), 2000, "OA shards");
+    check_iteration(hashtable_sharded_create(4, make_oa, NULL), 0, "Empty");
+
+    HashTable *ht = hashtable_sharded_create(4, make_chaining, NULL);
+    for (int i = 0; i < 1000; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)(i + 1));
+    test_assert(hashtable_foreach(ht, update_visit, ht), "foreach callbacks can update the same table");
+    int ok = 1;
+    for (int i = 0; i < 1000; i++)
+        ok &= (intptr_t)hashtable_search_int(ht, i) == 2 * (i + 1);
+    test_assert(ok, "Every update made from foreach is kept");
+    hashtable_destroy(&ht);
+}
+
+void test_sharded_build()
+{
+    print_separator("Sharded: Parallel Build");
+
+    // every shard is sized once; keys are partitioned by hash and filled in parallel
+    size_t shard_capacity = 8;
+    check_build(hashtable_sharded_create(16, make_oa, &shard_capacity), 50000, 16, "OA shards");
+    check_build(hashtable_sharded_create(8, make_chaining, NULL), 50000, 8, "Chaining shards");
+}
+
+void test_sharded_capacity_control()
+{
+    print_separator("Sharded: Reserve and Shrink");
+
+    // reserve and shrink_to_fit are applied to every shard
+    size_t shard_capacity = 8;
+    check_capacity_control(hashtable_sharded_create(16, make_oa, &shard_capacity), 20000, 16, "OA shards");
+    check_capacity_control(hashtable_sharded_create(8, make_chaining, NULL), 20000, 8, "Chaining shards");
+}
+
+int main()
+{
+    printf("Sharded Hashtable Implementation Tests\n");
+    printf("======================================\n");
+
+    test_sharded_basic_operations();
+    test_sharded_distribution_and_stats();
+    test_sharded_concurrent_access();
+    test_sharded_iteration();
+    test_sharded_build();
+    test_sharded_capacity_control();
+
+    printf("\n✓ All sharded hashtable tests passed!\n");
+
+    return 0;
+}
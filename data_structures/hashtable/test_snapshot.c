@@ -0,0 +1,237 @@
+/**
+ * test_snapshot.c - Test cases for saving a hashtable and reopening it with mmap
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "hashtable.h"
+#include "hashtable_chaining.h"
+#include "hashtable_oa.h"
+#include "hashtable_swiss.h"
+#include "hashtable_snapshot.h"
+#include "hash.h"
+#include "../common/common.h"
+
+void print_separator(const char *test_suite_name)
+{
+    printf("\n--- %s ---\n", test_suite_name);
+}
+
+void test_assert(int condition, const char *test_name)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", test_name);
+    }
+    else
+    {
+        printf("✗ %s FAILED\n", test_name);
+        exit(1);
+    }
+}
+
+static char snap_path[64];
+
+static HashKeyOps int_keyops(void)
+{
+    return (HashKeyOps){.hash = hash_fast, .eq = compare_int, .destroy_key = NULL, .destroy_val = NULL};
+}
+
+static HashKeyOps string_keyops(void)
+{
+    return (HashKeyOps){.hash = hash_fast, .eq = compare_string, .destroy_key = NULL, .destroy_val = NULL};
+}
+
+/* 值直接保存为整数（value_size 0） */
+static void check_int_round_trip(HashTable *ht, const char *backend, int n)
+{
+    char name[128];
+    for (int i = 0; i < n; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)(i * 7 + 1));
+    for (int i = 0; i < n; i += 3)
+        hashtable_delete_int(ht, i);
+
+    snprintf(name, sizeof name, "%s: save", backend);
+    test_assert(hashtable_save(ht, snap_path), name);
+
+    HashTable *m = hashtable_open_mmap(snap_path);
+    snprintf(name, sizeof name, "%s: reopen with mmap", backend);
+    test_assert(m != NULL && hashtable_size(m) == hashtable_size(ht), name);
+
+    int ok = 1;
+    for (int i = 0; i < n; i++)
+    {
+        void *v = hashtable_search_int(m, i);
+        ok &= (i % 3 == 0) ? v == NULL : (intptr_t)v == i * 7 + 1;
+    }
+    for (int i = n; i < n + 1000; i++)
+        ok &= hashtable_search_int(m, i) == NULL;
+    snprintf(name, sizeof name, "%s: every key and miss matches the source table", backend);
+    test_assert(ok, name);
+
+    size_t visited = 0;
+    ok = 1;
+    HashIter it = hashtable_iter_begin(m);
+    while (hashtable_iter_next(m, &it))
+    {
+        int k = *(const int *)it.key;
+        ok &= it.keysz == sizeof(int) && k % 3 != 0 && (intptr_t)it.value == k * 7 + 1;
+        visited++;
+    }
+    snprintf(name, sizeof name, "%s: iterating the mapping yields every entry", backend);
+    test_assert(ok && visited == hashtable_size(ht), name);
+
+    hashtable_destroy(&m);
+    hashtable_destroy(&ht);
+}
+
+void test_snapshot_backends()
+{
+    print_separator("Snapshot: Round Trip From Each Backend");
+
+    check_int_round_trip(hashtable_chaining_create(16, 0.75, int_keyops()), "Chaining", 5000);
+    check_int_round_trip(hashtable_oa_create(16, 0.5, int_keyops(), PROBE_LINEAR, NULL), "OA", 5000);
+    check_int_round_trip(hashtable_swiss_create(16, 0.875, int_keyops()), "Swiss", 5000);
+    // incremental resize leaves entries in both tables while migrating
+    check_int_round_trip(hashtable_oa_create_ex(16, 0.5, int_keyops(), PROBE_LINEAR, NULL, RESIZE_INCREMENTAL),
+                         "OA incremental", 3001);
+    check_int_round_trip(hashtable_chaining_create(16, 0.75, int_keyops()), "Empty table", 0);
+}
+
+typedef struct
+{
+    double score;
+    int rank;
+    char tag[12];
+} Record;
+
+void test_snapshot_string_keys_and_values()
+{
+    print_separator("Snapshot: String Keys and Copied Values");
+
+    HashTable *ht = hashtable_oa_create(16, 0.5, string_keyops(), PROBE_LINEAR, NULL);
+    enum { N = 2000 };
+    static Record recs[N];
+    char key[64];
+    for (int i = 0; i < N; i++)
+    {
+        recs[i] = (Record){i * 0.5, i, ""};
+        snprintf(recs[i].tag, sizeof recs[i].tag, "r%d", i);
+        // mix short and long keys so both inline and arena keys are saved
+        if (i % 2)
+            snprintf(key, sizeof key, "k%d", i);
+        else
+            snprintf(key, sizeof key, "a-rather-long-key-that-does-not-fit-inline-%d", i);
+        hashtable_insert_string(ht, key, &recs[i]);
+    }
+    hashtable_insert_string(ht, "null-value", NULL);
+    test_assert(hashtable_save_ex(ht, snap_path, sizeof(Record)), "Save with value_size = sizeof(Record)");
+    hashtable_destroy(&ht);
+    memset(recs, 0, sizeof recs); // the snapshot must not depend on the original values
+
+    HashTable *m = hashtable_open_mmap(snap_path);
+    test_assert(m != NULL && hashtable_size(m) == N + 1, "Reopen after the source table is gone");
+
+    int ok = 1;
+    for (int i = 0; i < N; i++)
+    {
+        if (i % 2)
+            snprintf(key, sizeof key, "k%d", i);
+        else
+            snprintf(key, sizeof key, "a-rather-long-key-that-does-not-fit-inline-%d", i);
+        const Record *r = hashtable_search_string(m, key);
+        char tag[12];
+        snprintf(tag, sizeof tag, "r%d", i);
+        ok &= r != NULL && r->rank == i && r->score == i * 0.5 && strcmp(r->tag, tag) == 0;
+        ok &= ((uintptr_t)r & 15) == 0;
+    }
+    test_assert(ok, "Values are copied into the file and 16-byte aligned");
+    test_assert(hashtable_search_string(m, "null-value") == NULL &&
+                    hashtable_search_string(m, "k0") == NULL && hashtable_search_string(m, "") == NULL,
+                "NULL values and missing keys");
+
+    const void *keys[4] = {"k1", "k2", "k3", "nope"};
+    size_t keyszs[4];
+    void *out[4];
+    for (int i = 0; i < 4; i++)
+        keyszs[i] = strlen(keys[i]) + 1;
+    test_assert(hashtable_search_batch(m, keys, keyszs, 4, out) == 2 &&
+                    ((Record *)out[0])->rank == 1 && out[1] == NULL && ((Record *)out[2])->rank == 3 &&
+                    out[3] == NULL,
+                "Batched search on the mapping");
+
+    HashStats hs = hashtable_get_stats(m);
+    test_assert(hs.total_elements == N + 1 && hs.max_chain_or_probe >= 1, "Stats scan the slot array");
+    hashtable_destroy(&m);
+    test_assert(m == NULL, "Destroy unmaps the snapshot");
+}
+
+void test_snapshot_read_only()
+{
+    print_separator("Snapshot: Read-Only Table");
+
+    HashTable *ht = hashtable_chaining_create(16, 0.75, int_keyops());
+    hashtable_insert_int(ht, 1, (void *)(intptr_t)10);
+    hashtable_save(ht, snap_path);
+    hashtable_destroy(&ht);
+
+    HashTable *m = hashtable_open_mmap(snap_path);
+    test_assert(!hashtable_insert_int(m, 2, (void *)(intptr_t)20), "Insert fails");
+    test_assert(!hashtable_update(m, &(int){1}, sizeof(int), (void *)(intptr_t)11), "Update fails");
+    test_assert(!hashtable_delete_int(m, 1), "Delete fails");
+    test_assert((intptr_t)hashtable_search_int(m, 1) == 10 && hashtable_size(m) == 1, "Table is unchanged");
+    hashtable_destroy(&m);
+}
+
+void test_snapshot_invalid_files()
+{
+    print_separator("Snapshot: Invalid Files");
+
+    test_assert(hashtable_open_mmap("/nonexistent/dir/snapshot.bin") == NULL, "Missing file");
+
+    FILE *f = fopen(snap_path, "wb");
+    fputs("definitely not a snapshot", f);
+    fclose(f);
+    test_assert(hashtable_open_mmap(snap_path) == NULL, "Short garbage file");
+
+    // a valid snapshot with its tail cut off no longer matches the recorded size
+    HashTable *ht = hashtable_chaining_create(16, 0.75, int_keyops());
+    for (int i = 0; i < 100; i++)
+        hashtable_insert_int(ht, i, (void *)(intptr_t)i);
+    hashtable_save(ht, snap_path);
+    test_assert(truncate(snap_path, 200) == 0 && hashtable_open_mmap(snap_path) == NULL, "Truncated file");
+
+    // corrupt magic
+    hashtable_save(ht, snap_path);
+    f = fopen(snap_path, "r+b");
+    fputc('X', f);
+    fclose(f);
+    test_assert(hashtable_open_mmap(snap_path) == NULL, "Corrupt header");
+
+    test_assert(!hashtable_save(ht, "/nonexistent/dir/snapshot.bin"), "Save to an unwritable path fails");
+    test_assert(!hashtable_save(NULL, snap_path), "Save of NULL table fails");
+    hashtable_destroy(&ht);
+}
+
+int main()
+{
+    printf("Hashtable Snapshot Tests\n");
+    printf("========================\n");
+
+    snprintf(snap_path, sizeof snap_path, "/tmp/ht_snapshot_%ld.bin", (long)getpid());
+
+    test_snapshot_backends();
+    test_snapshot_string_keys_and_values();
+    test_snapshot_read_only();
+    test_snapshot_invalid_files();
+
+    remove(snap_path);
+    printf("\n✓ All snapshot tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,322 @@
+/**
+ * test_swiss.c - Test cases for the Swiss table hashtable implementation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hashtable.h"
+#include "hashtable_swiss.h"
+#include "hash.h"
+#include "../common/common.h"
+#include "test_helpers.h"
+
+void print_separator(const char *test_suite_name)
+{
+    printf("\n--- %s ---\n", test_suite_name);
+}
+
+void test_assert(int condition, const char *test_name)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", test_name);
+    }
+    else
+    {
+        printf("✗ %s FAILED\n", test_name);
+        exit(1);
+    }
+}
+
+/* 所有键落到同一组、同一指纹，强制走完整的组间探测和 eq 比较 */
+static size_t constant_hash(const void *key, size_t keysz)
+{
+    (void)key;
+    (void)keysz;
+    return 42;
+}
+
+void test_swiss_basic_operations()
+{
+    print_separator("Swiss Table: Basic Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_swiss_create(16, 0.875, keyops);
+    test_assert(ht != NULL, "Create swiss hashtable");
+    test_assert(hashtable_size(ht) == 0, "Initial size is 0");
+    test_assert(hashtable_capacity(ht) == 16, "Initial capacity is one group");
+
+    int key1 = 10, val1 = 100;
+    int key2 = 20, val2 = 200;
+    int key3 = 30, val3 = 300;
+
+    test_assert(hashtable_insert(ht, &key1, sizeof(int), &val1), "Insert key1");
+    test_assert(hashtable_insert(ht, &key2, sizeof(int), &val2), "Insert key2");
+    test_assert(hashtable_insert(ht, &key3, sizeof(int), &val3), "Insert key3");
+    test_assert(hashtable_size(ht) == 3, "Size after insertions");
+
+    int *found = (int *)hashtable_search(ht, &key2, sizeof(int));
+    test_assert(found != NULL && *found == val2, "Search existing key2");
+
+    int nonexistent = 999;
+    test_assert(hashtable_search(ht, &nonexistent, sizeof(int)) == NULL, "Search non-existent key");
+
+    int new_val1 = 1000;
+    test_assert(hashtable_update(ht, &key1, sizeof(int), &new_val1), "Update existing key");
+    found = (int *)hashtable_search(ht, &key1, sizeof(int));
+    test_assert(found != NULL && *found == new_val1, "Verify updated value");
+
+    test_assert(hashtable_delete(ht, &key2, sizeof(int)), "Delete existing key");
+    test_assert(hashtable_size(ht) == 2, "Size after deletion");
+    test_assert(hashtable_search(ht, &key2, sizeof(int)) == NULL, "Verify deleted key not found");
+
+    hashtable_destroy(&ht);
+    test_assert(ht == NULL, "Destroy hashtable");
+}
+
+void test_swiss_growth()
+{
+    print_separator("Swiss Table: Growth and Rehashing");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = free};
+
+    HashTable *ht = hashtable_swiss_create(0, 0, keyops);
+    for (int i = 0; i < 10000; i++)
+    {
+        int *v = malloc(sizeof *v);
+        *v = i * 2;
+        test_assert(hashtable_insert(ht, &i, sizeof(int), v), "Insert");
+    }
+    test_assert(hashtable_size(ht) == 10000, "All elements inserted");
+    test_assert(hashtable_load_factor(ht) <= 0.875, "Load factor within threshold");
+
+    int ok = 1;
+    for (int i = 0; i < 10000; i++)
+    {
+        int *found = (int *)hashtable_search(ht, &i, sizeof(int));
+        ok &= (found != NULL && *found == i * 2);
+    }
+    test_assert(ok, "All keys accessible after growth");
+
+    HashStats stats = hashtable_get_stats(ht);
+    printf("  - Max probe (groups): %zu\n", stats.max_chain_or_probe);
+    printf("  - Average probe (groups): %.2f\n", stats.average_chain_length);
+
+    hashtable_destroy(&ht);
+}
+
+void test_swiss_collisions_and_tombstones()
+{
+    print_separator("Swiss Table: Full Collisions and Tombstones");
+
+    HashKeyOps keyops = {
+        .hash = constant_hash,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_swiss_create(64, 0.875, keyops);
+    int keys[40], vals[40];
+    for (int i = 0; i < 40; i++)
+    {
+        keys[i] = i;
+        vals[i] = i * 10;
+        test_assert(hashtable_insert(ht, &keys[i], sizeof(int), &vals[i]), "Insert colliding key");
+    }
+
+    // the first group is full: erasing from it must leave a tombstone
+    for (int i = 0; i < 40; i += 2)
+        test_assert(hashtable_delete(ht, &keys[i], sizeof(int)), "Delete colliding key");
+
+    int ok = 1;
+    for (int i = 0; i < 40; i++)
+    {
+        int *found = (int *)hashtable_search(ht, &keys[i], sizeof(int));
+        ok &= (i % 2 == 0) ? found == NULL : (found != NULL && *found == vals[i]);
+    }
+    test_assert(ok, "Survivors reachable across tombstones");
+
+    // re-insert reuses tombstones without losing anything
+    for (int i = 0; i < 40; i += 2)
+        test_assert(hashtable_insert(ht, &keys[i], sizeof(int), &vals[i]), "Re-insert key");
+    test_assert(hashtable_size(ht) == 40, "Size after re-insert");
+    for (int i = 0; i < 40; i++)
+    {
+        int *found = (int *)hashtable_search(ht, &keys[i], sizeof(int));
+        ok &= (found != NULL && *found == vals[i]);
+    }
+    test_assert(ok, "All keys reachable after tombstone reuse");
+
+    hashtable_destroy(&ht);
+}
+
+void test_swiss_churn()
+{
+    print_separator("Swiss Table: Insert/Delete Churn");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_swiss_create(32, 0.875, keyops);
+    // a sliding window of 20 live keys over 5000 inserts
+    for (int i = 0; i < 5000; i++)
+    {
+        hashtable_insert(ht, &i, sizeof(int), &keyops);
+        int old = i - 20;
+        if (old >= 0)
+            hashtable_delete(ht, &old, sizeof(int));
+    }
+    test_assert(hashtable_size(ht) == 20, "Window size preserved");
+    test_assert(hashtable_capacity(ht) <= 64, "Tombstones cleaned without unbounded growth");
+    int ok = 1;
+    for (int i = 4980; i < 5000; i++)
+        ok &= hashtable_search(ht, &i, sizeof(int)) != NULL;
+    test_assert(ok, "Live window reachable");
+
+    hashtable_destroy(&ht);
+}
+
+void test_swiss_string_keys()
+{
+    print_separator("Swiss Table: String Key Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_string,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_swiss_create(8, 0.875, keyops);
+    test_assert(hashtable_insert_string(ht, "Alice", "25"), "Insert Alice");
+    test_assert(hashtable_insert_string(ht, "Bob", "30"), "Insert Bob");
+
+    char *found = (char *)hashtable_search_string(ht, "Alice");
+    test_assert(found != NULL && strcmp(found, "25") == 0, "Find string key");
+    test_assert(hashtable_delete_string(ht, "Alice"), "Delete string key");
+    test_assert(hashtable_search_string(ht, "Alice") == NULL, "Deleted string key not found");
+
+    hashtable_destroy(&ht);
+}
+
+void test_swiss_batch_operations()
+{
+    print_separator("Swiss Table: Batch Operations");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL};
+
+    HashTable *ht = hashtable_swiss_create(16, 0.875, keyops);
+    enum { N = 1000 };
+    static int keys[2 * N];
+    const void *kp[2 * N];
+    size_t ksz[2 * N];
+    void *vals[2 * N];
+    void *out[2 * N];
+    for (int i = 0; i < 2 * N; i++)
+    {
+        keys[i] = i * 7 + 1;
+        kp[i] = &keys[i];
+        ksz[i] = sizeof(int);
+        vals[i] = &keys[i];
+    }
+
+    // N is not a multiple of the internal batch size; the table grows mid-batch
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals, N) == N, "Insert batch");
+    test_assert(hashtable_size(ht) == N, "Size after insert batch");
+
+    // second half of the keys was never inserted
+    size_t found = hashtable_search_batch(ht, kp, ksz, 2 * N, out);
+    test_assert(found == N, "Search batch hit count");
+    int ok = 1;
+    for (int i = 0; i < 2 * N; i++)
+        ok &= out[i] == (i < N ? &keys[i] : NULL);
+    test_assert(ok, "Search batch results match single lookups");
+
+    // Re-inserting existing keys through the batch API updates them
+    test_assert(hashtable_insert_batch(ht, kp, ksz, vals + 1, N) == N, "Update via insert batch");
+    test_assert(hashtable_search(ht, kp[0], sizeof(int)) == &keys[1], "Batch insert updated value");
+    test_assert(hashtable_search_batch(ht, kp, ksz, 0, out) == 0, "Empty batch");
+
+    hashtable_destroy(&ht);
+}
+
+void test_swiss_iteration()
+{
+    print_separator("Swiss: Iteration");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_iteration(hashtable_swiss_create(16, 0.875, keyops), 2000, "Swiss");
+    check_iteration(hashtable_swiss_create(16, 0.875, keyops), 0, "Empty");
+}
+
+void test_swiss_build()
+{
+    print_separator("Swiss: Bulk Build");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_build(hashtable_swiss_create(16, 0.875, keyops), 50000, 1, "Swiss");
+}
+
+void test_swiss_capacity_control()
+{
+    print_separator("Swiss: Reserve and Shrink");
+
+    HashKeyOps keyops = {
+        .hash = hash_fnv1a,
+        .eq = compare_int,
+        .destroy_key = NULL,
+        .destroy_val = NULL
+    };
+
+    check_capacity_control(hashtable_swiss_create(16, 0.875, keyops), 20000, 1, "Swiss");
+}
+
+int main()
+{
+    printf("Swiss Table Hashtable Implementation Tests\n");
+    printf("==========================================\n");
+
+    test_swiss_basic_operations();
+    test_swiss_growth();
+    test_swiss_collisions_and_tombstones();
+    test_swiss_churn();
+    test_swiss_string_keys();
+    test_swiss_batch_operations();
+    test_swiss_iteration();
+    test_swiss_build();
+    test_swiss_capacity_control();
+
+    printf("\n✓ All swiss table hashtable tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+/**
+ * test_typed.c - Test cases for the macro-generated typed hashtable
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "hashtable_typed.h"
+#include "hash.h"
+
+void print_separator(const char *test_suite_name)
+{
+    printf("\n--- %s ---\n", test_suite_name);
+}
+
+void test_assert(int condition, const char *test_name)
+{
+    if (condition)
+    {
+        printf("✓ %s\n", test_name);
+    }
+    else
+    {
+        printf("✗ %s FAILED\n", test_name);
+        exit(1);
+    }
+}
+
+typedef struct
+{
+    double x, y, z;
+    int id;
+} Point;
+
+HASHTABLE_DEFINE(PointMap, int, Point, ht_typed_hash_int, HT_TYPED_EQ)
+
+/* 结构体键：自定义哈希与比较 */
+typedef struct
+{
+    uint32_t a, b;
+} Pair;
+
+static inline size_t pair_hash(Pair p)
+{
+    return ht_typed_hash_u64((uint64_t)p.a << 32 | p.b);
+}
+
+static inline bool pair_eq(Pair p, Pair q)
+{
+    return p.a == q.a && p.b == q.b;
+}
+
+HASHTABLE_DEFINE(PairSet, Pair, int, pair_hash, pair_eq)
+
+/* 所有键哈希相同：只靠线性探测和 eqfn 区分 */
+#define CONST_HASH(k) ((void)(k), (size_t)7)
+HASHTABLE_DEFINE(CollideMap, int, int, CONST_HASH, HT_TYPED_EQ)
+
+void test_typed_basic_operations()
+{
+    print_separator("Typed: Basic Operations");
+
+    PointMap *m = PointMap_create(4, 0.75);
+    test_assert(m != NULL, "Create typed hashtable");
+    test_assert(PointMap_size(m) == 0, "Initial size is 0");
+    test_assert(PointMap_capacity(m) == 8, "Capacity rounded up to the minimum of 8");
+
+    test_assert(PointMap_insert(m, 10, (Point){1, 2, 3, 10}), "Insert key 10");
+    test_assert(PointMap_insert(m, 20, (Point){4, 5, 6, 20}), "Insert key 20");
+    test_assert(PointMap_size(m) == 2, "Size after insertions");
+
+    Point *p = PointMap_search(m, 10);
+    test_assert(p != NULL && p->id == 10 && p->z == 3, "Search returns the stored struct");
+    test_assert(PointMap_search(m, 999) == NULL, "Search non-existent key");
+
+    p->x = 100; // values live in the slot and can be modified in place
+    test_assert(PointMap_search(m, 10)->x == 100, "Value modified through the returned pointer");
+
+    test_assert(PointMap_update(m, 20, (Point){7, 8, 9, 21}), "Update existing key");
+    test_assert(PointMap_search(m, 20)->id == 21, "Verify updated value");
+    test_assert(!PointMap_update(m, 30, (Point){0, 0, 0, 0}), "Update missing key fails");
+
+    test_assert(PointMap_insert(m, 10, (Point){0, 0, 0, 11}) && PointMap_size(m) == 2,
+                "Insert of an existing key overwrites");
+    test_assert(PointMap_search(m, 10)->id == 11, "Overwritten value");
+
+    test_assert(PointMap_erase(m, 20), "Erase existing key");
+    test_assert(!PointMap_erase(m, 20), "Erase twice fails");
+    test_assert(PointMap_search(m, 20) == NULL && PointMap_size(m) == 1, "Erased key is gone");
+
+    PointMap_destroy(&m);
+    test_assert(m == NULL, "Destroy hashtable");
+    test_assert(PointMap_search(NULL, 1) == NULL && !PointMap_insert(NULL, 1, (Point){0}) &&
+                    PointMap_size(NULL) == 0,
+                "NULL table is handled");
+}
+
+void test_typed_rehash_and_tombstones()
+{
+    print_separator("Typed: Rehash and Tombstones");
+
+    PointMap *m = PointMap_create(8, 0.5);
+    for (int i = 0; i < 10000; i++)
+        PointMap_insert(m, i, (Point){i, -i, 0, i});
+    test_assert(PointMap_size(m) == 10000, "Size after 10000 insertions");
+    test_assert(PointMap_load_factor(m) <= 0.5, "Load factor stays below the threshold");
+
+    for (int i = 0; i < 10000; i += 2)
+        PointMap_erase(m, i);
+    int ok = 1;
+    for (int i = 0; i < 10000; i++)
+    {
+        Point *p = PointMap_search(m, i);
+        ok &= (i % 2) ? (p != NULL && p->id == i && p->y == -i) : p == NULL;
+    }
+    test_assert(ok, "All keys consistent after deletions");
+
+    // churn at constant size: tombstones are cleaned up without the table growing
+    size_t cap = PointMap_capacity(m);
+    for (int round = 0; round < 20; round++)
+    {
+        for (int i = 0; i < 1000; i++)
+            PointMap_insert(m, 100000 + i, (Point){0, 0, 0, i});
+        for (int i = 0; i < 1000; i++)
+            PointMap_erase(m, 100000 + i);
+    }
+    test_assert(PointMap_capacity(m) == cap, "Churn does not grow the table");
+    test_assert(PointMap_size(m) == 5000, "Size after churn");
+    test_assert(m->tombstones < m->capacity / 2, "Tombstones are bounded");
+    PointMap_destroy(&m);
+
+    CollideMap *c = CollideMap_create(8, 0.75);
+    for (int i = 0; i < 200; i++)
+        CollideMap_insert(c, i, i * 3);
+    CollideMap_erase(c, 50);
+    ok = 1;
+    for (int i = 0; i < 200; i++)
+    {
+        int *v = CollideMap_search(c, i);
+        ok &= i == 50 ? v == NULL : (v != NULL && *v == i * 3);
+    }
+    test_assert(ok, "Identical hashes are resolved by eqfn");
+    CollideMap_destroy(&c);
+}
+
+void test_typed_struct_keys()
+{
+    print_separator("Typed: Struct Keys");
+
+    PairSet *s = PairSet_create(0, 0.75);
+    for (uint32_t a = 0; a < 50; a++)
+        for (uint32_t b = 0; b < 50; b++)
+            PairSet_insert(s, (Pair){a, b}, (int)(a * 50 + b));
+    test_assert(PairSet_size(s) == 2500, "Size after insertions");
+
+    int ok = 1;
+    for (uint32_t a = 0; a < 50; a++)
+        for (uint32_t b = 0; b < 50; b++)
+        {
+            int *v = PairSet_search(s, (Pair){a, b});
+            ok &= v != NULL && *v == (int)(a * 50 + b);
+        }
+    test_assert(ok, "Every pair found");
+    test_assert(PairSet_search(s, (Pair){50, 0}) == NULL &&
+                    PairSet_search(s, (Pair){0, 50}) == NULL,
+                "Pairs never inserted are missing");
+    PairSet_destroy(&s);
+}
+
+void test_typed_hash_helpers()
+{
+    print_separator("Typed: Hash Helpers");
+
+    int ok = 1;
+    for (int32_t i = -1000; i < 1000; i++)
+    {
+        int64_t v = (int64_t)i * 0x100000001ll;
+        ok &= ht_typed_hash_int(i) == hash_int32(&i, sizeof i);
+        ok &= ht_typed_hash_u64((uint64_t)v) == hash_int64(&v, sizeof v);
+    }
+    test_assert(ok, "Inline helpers match hash_int32 / hash_int64");
+}
+
+int main()
+{
+    printf("Typed Hashtable Implementation Tests\n");
+    printf("====================================\n");
+
+    test_typed_basic_operations();
+    test_typed_rehash_and_tombstones();
+    test_typed_struct_keys();
+    test_typed_hash_helpers();
+
+    printf("\n✓ All typed hashtable tests passed!\n");
+
+    return 0;
+}
@@ -11,6 +11,11 @@ struct Queue
 };
 
 Queue *queue_create(void)
+{
+    return queue_create_with_allocator(NULL);
+}
+
+Queue *queue_create_with_allocator(const Allocator *alloc)
 {
     Queue *queue = malloc(sizeof(Queue));
     if (!queue)
@@ -18,7 +23,7 @@ Queue *queue_create(void)
         fprintf(stderr, "Failed to allocate memory for Queue\n");
         return NULL;
     }
-    queue->list = list_create(NULL);
+    queue->list = list_create_with_allocator(NULL, alloc);
     if (!queue->list)
     {
         fprintf(stderr, "Failed to create underlying list for Queue\n");
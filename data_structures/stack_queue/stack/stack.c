@@ -11,6 +11,11 @@ struct Stack
 };
 
 Stack *stack_create(void)
+{
+    return stack_create_with_allocator(NULL);
+}
+
+Stack *stack_create_with_allocator(const Allocator *alloc)
 {
     Stack *stack = malloc(sizeof(Stack));
     if (!stack)
@@ -18,7 +23,7 @@ Stack *stack_create(void)
         fprintf(stderr, "Failed to allocate memory for Stack\n");
         return NULL;
     }
-    stack->list = list_create(NULL);
+    stack->list = list_create_with_allocator(NULL, alloc);
     if (!stack->list)
     {
         fprintf(stderr, "Failed to create underlying list for Stack\n");
@@ -4,11 +4,14 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include "../../common/arena.h"
 
 typedef struct Stack Stack;
 
 // 创建和销毁
 Stack *stack_create(void);
+// 底层链表的节点从 alloc 分配（见 list_create_with_allocator），NULL 表示 malloc；alloc 须比它活得久
+Stack *stack_create_with_allocator(const Allocator *alloc);
 void stack_destroy(Stack **stack);
 
 // 栈操作